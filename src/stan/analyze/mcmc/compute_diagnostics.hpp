@@ -0,0 +1,237 @@
+#ifndef STAN_ANALYZE_MCMC_COMPUTE_DIAGNOSTICS_HPP
+#define STAN_ANALYZE_MCMC_COMPUTE_DIAGNOSTICS_HPP
+
+#include <stan/math/prim/mat.hpp>
+#include <stan/util/parallel_for.hpp>
+#include <unsupported/Eigen/FFT>
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <stdexcept>
+#include <vector>
+
+namespace stan {
+  namespace analyze {
+
+    /**
+     * Scratch space for computing the diagnostics of one parameter at
+     * a time.  Reusing a workspace across parameters with the same
+     * number of chains and draws reuses its FFT plan and buffers, so
+     * no memory is allocated after the first parameter.
+     */
+    struct diagnostics_workspace {
+      Eigen::FFT<double> fft;
+      std::vector<double> signal;
+      std::vector<std::complex<double> > spectrum;
+      std::vector<double> correlation;
+      Eigen::MatrixXd acov;
+      Eigen::VectorXd chain_mean;
+      Eigen::VectorXd chain_var;
+      Eigen::VectorXd split_mean;
+      Eigen::VectorXd split_var;
+      Eigen::VectorXd rho_hat_s;
+
+      diagnostics_workspace() {
+        fft.SetFlag(Eigen::FFT<double>::HalfSpectrum);
+      }
+    };
+
+    /**
+     * Computes the effective sample size and the split potential
+     * scale reduction (split R hat) of one parameter.
+     *
+     * The effective sample size matches
+     * <code>compute_effective_sample_size</code> and the split R hat
+     * matches <code>chains::split_potential_scale_reduction</code>.
+     * The means and variances of the half chains used for R hat are
+     * combined into the chain means and variances used for the
+     * effective sample size rather than being computed again.
+     *
+     * All chains are truncated to the length of the shortest chain.
+     *
+     * @tparam M type of the draws of a chain, an Eigen matrix
+     *   expression with one row per draw and one column per parameter
+     * @param[in] draws draws of each chain
+     * @param[in] param column of the parameter
+     * @param[in,out] workspace scratch space
+     * @param[out] ess effective sample size
+     * @param[out] split_rhat split R hat
+     */
+    template <typename M>
+    void compute_diagnostics(const std::vector<M>& draws, int param,
+                             diagnostics_workspace& workspace,
+                             double& ess, double& split_rhat) {
+      int num_chains = draws.size();
+      int num_draws = draws[0].rows();
+      for (int chain = 1; chain < num_chains; ++chain)
+        num_draws = std::min(num_draws, static_cast<int>(draws[chain].rows()));
+      int n = num_draws / 2;
+      size_t padded_size = 2 * math::fft_next_good_size(num_draws);
+
+      workspace.acov.resize(num_draws, num_chains);
+      workspace.chain_mean.resize(num_chains);
+      workspace.chain_var.resize(num_chains);
+      workspace.split_mean.resize(2 * num_chains);
+      workspace.split_var.resize(2 * num_chains);
+      workspace.signal.resize(padded_size);
+
+      for (int chain = 0; chain < num_chains; ++chain) {
+        // split chain means and sums of squares, plus the middle draw
+        // of an odd length chain, combined into the chain mean
+        double total = 0;
+        for (int half = 0; half < 2; ++half) {
+          int start = half == 0 ? 0 : num_draws - n;
+          double sum = 0;
+          for (int i = start; i < start + n; ++i)
+            sum += draws[chain](i, param);
+          double mean = sum / n;
+          double sum_sq = 0;
+          for (int i = start; i < start + n; ++i) {
+            double diff = draws[chain](i, param) - mean;
+            sum_sq += diff * diff;
+          }
+          workspace.split_mean(2 * chain + half) = mean;
+          workspace.split_var(2 * chain + half) = sum_sq / (n - 1);
+          total += sum;
+        }
+        if (num_draws % 2 == 1)
+          total += draws[chain](n, param);
+        double chain_mean = total / num_draws;
+        workspace.chain_mean(chain) = chain_mean;
+
+        for (int i = 0; i < num_draws; ++i)
+          workspace.signal[i] = draws[chain](i, param) - chain_mean;
+        std::fill(workspace.signal.begin() + num_draws,
+                  workspace.signal.end(), 0.0);
+        workspace.fft.fwd(workspace.spectrum, workspace.signal);
+        for (size_t k = 0; k < workspace.spectrum.size(); ++k)
+          workspace.spectrum[k] = std::norm(workspace.spectrum[k]);
+        workspace.fft.inv(workspace.correlation, workspace.spectrum,
+                          padded_size);
+        for (int i = 0; i < num_draws; ++i)
+          workspace.acov(i, chain)
+            = workspace.correlation[i] / (num_draws - i);
+        workspace.chain_var(chain)
+          = workspace.acov(0, chain) * num_draws / (num_draws - 1);
+      }
+
+      const Eigen::VectorXd& split_mean = workspace.split_mean;
+      double var_between = n * (split_mean.array() - split_mean.mean())
+        .square().sum() / (2 * num_chains - 1);
+      double var_within = workspace.split_var.mean();
+      split_rhat = std::sqrt((var_between / var_within + n - 1) / n);
+
+      double mean_var = workspace.chain_var.mean();
+      double var_plus = mean_var * (num_draws - 1) / num_draws;
+      if (num_chains > 1) {
+        const Eigen::VectorXd& chain_mean = workspace.chain_mean;
+        var_plus += (chain_mean.array() - chain_mean.mean()).square().sum()
+          / (num_chains - 1);
+      }
+      workspace.rho_hat_s.setZero(num_draws);
+      Eigen::VectorXd& rho_hat_s = workspace.rho_hat_s;
+      double rho_hat_even = 1;
+      double rho_hat_odd
+        = 1 - (mean_var - workspace.acov.row(1).mean()) / var_plus;
+      rho_hat_s(1) = rho_hat_odd;
+      // Geyer's initial positive sequence
+      int max_s = 1;
+      for (int s = 1;
+           (s < (num_draws - 2) && (rho_hat_even + rho_hat_odd) >= 0);
+           s += 2) {
+        rho_hat_even
+          = 1 - (mean_var - workspace.acov.row(s + 1).mean()) / var_plus;
+        rho_hat_odd
+          = 1 - (mean_var - workspace.acov.row(s + 2).mean()) / var_plus;
+        if ((rho_hat_even + rho_hat_odd) >= 0) {
+          rho_hat_s(s + 1) = rho_hat_even;
+          rho_hat_s(s + 2) = rho_hat_odd;
+        }
+        max_s = s + 2;
+      }
+      // Geyer's initial monotone sequence
+      for (int s = 3; s <= max_s - 2; s += 2) {
+        if (rho_hat_s(s + 1) + rho_hat_s(s + 2) >
+            rho_hat_s(s - 1) + rho_hat_s(s)) {
+          rho_hat_s(s + 1) = (rho_hat_s(s - 1) + rho_hat_s(s)) / 2;
+          rho_hat_s(s + 2) = rho_hat_s(s + 1);
+        }
+      }
+
+      ess = static_cast<double>(num_chains) * num_draws
+        / (1 + 2 * rho_hat_s.head(std::min(max_s + 1, num_draws)).sum());
+    }
+
+    /**
+     * Computes the effective sample size and the split potential
+     * scale reduction (split R hat) of every parameter.
+     *
+     * Parameters are divided among the threads, each of which reuses
+     * one workspace for all of its parameters.
+     *
+     * @tparam M type of the draws of a chain, an Eigen matrix
+     *   expression with one row per draw and one column per parameter
+     * @param[in] draws draws of each chain, all with the same columns
+     * @param[out] ess effective sample size of each parameter
+     * @param[out] split_rhat split R hat of each parameter
+     * @param[in] num_threads maximum number of threads to use
+     * @throw std::invalid_argument if there are no chains, the chains
+     *   have different numbers of columns or fewer than four draws
+     */
+    template <typename M>
+    void compute_diagnostics(const std::vector<M>& draws,
+                             Eigen::VectorXd& ess,
+                             Eigen::VectorXd& split_rhat,
+                             int num_threads) {
+      if (draws.empty())
+        throw std::invalid_argument("compute_diagnostics: no chains");
+      int num_params = draws[0].cols();
+      for (size_t chain = 0; chain < draws.size(); ++chain) {
+        if (draws[chain].cols() != num_params)
+          throw std::invalid_argument("compute_diagnostics: chains have"
+                                      " different numbers of parameters");
+        if (draws[chain].rows() < 4)
+          throw std::invalid_argument("compute_diagnostics: chains must"
+                                      " have at least 4 draws");
+      }
+
+      ess.resize(num_params);
+      split_rhat.resize(num_params);
+      num_threads = std::max(1, std::min(num_threads, num_params));
+      util::parallel_for(0, num_threads,
+                         [&](size_t thread) {
+                           diagnostics_workspace workspace;
+                           for (int param = thread; param < num_params;
+                                param += num_threads)
+                             compute_diagnostics(draws, param, workspace,
+                                                 ess(param),
+                                                 split_rhat(param));
+                         }, num_threads);
+    }
+
+    /**
+     * Computes the effective sample size and the split potential
+     * scale reduction (split R hat) of every parameter, using the
+     * number of threads given by <code>STAN_NUM_THREADS</code>.
+     *
+     * @tparam M type of the draws of a chain, an Eigen matrix
+     *   expression with one row per draw and one column per parameter
+     * @param[in] draws draws of each chain, all with the same columns
+     * @param[out] ess effective sample size of each parameter
+     * @param[out] split_rhat split R hat of each parameter
+     * @throw std::invalid_argument if there are no chains, the chains
+     *   have different numbers of columns or fewer than four draws
+     */
+    template <typename M>
+    void compute_diagnostics(const std::vector<M>& draws,
+                             Eigen::VectorXd& ess,
+                             Eigen::VectorXd& split_rhat) {
+      int num_params = draws.empty() ? 0 : draws[0].cols();
+      compute_diagnostics(draws, ess, split_rhat,
+                          util::get_num_threads(num_params));
+    }
+
+  }
+}
+
+#endif
@@ -0,0 +1,178 @@
+#ifndef STAN_ANALYZE_MCMC_COMPUTE_SUMMARY_HPP
+#define STAN_ANALYZE_MCMC_COMPUTE_SUMMARY_HPP
+
+#include <stan/analyze/mcmc/compute_diagnostics.hpp>
+#include <stan/util/parallel_for.hpp>
+#include <Eigen/Dense>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace stan {
+  namespace analyze {
+
+    /**
+     * Summary of the draws of one parameter.
+     */
+    struct parameter_summary {
+      parameter_summary()
+        : mean(0), sd(0), mcse(0), ess(0), split_rhat(0) {}
+
+      double mean;
+      double sd;
+      double mcse;
+      double ess;
+      double split_rhat;
+      Eigen::VectorXd quantiles;
+    };
+
+    /**
+     * Computes quantiles of draws, selecting only the order
+     * statistics needed rather than sorting the draws.
+     *
+     * For a probability <code>p</code> below one half the quantile is
+     * the <code>ceil(p N)</code>-th smallest of the <code>N</code>
+     * draws, and otherwise it is the <code>ceil((1 - p) N)</code>-th
+     * largest, matching the tail quantiles previously used by
+     * <code>mcmc::chains</code>.  A quantile needing all of the draws
+     * in its tail is not a number.
+     *
+     * @param[in,out] x draws, which are reordered
+     * @param[in] probs probabilities of the quantiles
+     * @param[out] q quantile for each probability
+     */
+    inline void compute_quantiles(std::vector<double>& x,
+                                  const Eigen::VectorXd& probs,
+                                  Eigen::VectorXd& q) {
+      size_t N = x.size();
+      q.resize(probs.size());
+      std::vector<std::pair<size_t, int> > order;
+      order.reserve(probs.size());
+      for (int i = 0; i < probs.size(); ++i) {
+        size_t n = static_cast<size_t>(
+            std::ceil(probs(i) < 0.5 ? probs(i) * N : (1 - probs(i)) * N));
+        n = std::max(n, static_cast<size_t>(1));
+        if (n >= N) {
+          q(i) = std::numeric_limits<double>::quiet_NaN();
+          continue;
+        }
+        order.push_back(std::make_pair(probs(i) < 0.5 ? n - 1 : N - n, i));
+      }
+      std::sort(order.begin(), order.end());
+
+      // each selection only needs to search above the previous one
+      std::vector<double>::iterator begin = x.begin();
+      for (size_t k = 0; k < order.size(); ++k) {
+        std::vector<double>::iterator nth = x.begin() + order[k].first;
+        if (nth >= begin) {
+          std::nth_element(begin, nth, x.end());
+          begin = nth + 1;
+        }
+        q(order[k].second) = *nth;
+      }
+    }
+
+    /**
+     * Summarizes the draws of every parameter: the mean, standard
+     * deviation, quantiles, effective sample size, Monte Carlo
+     * standard error and split R hat.
+     *
+     * Each parameter is summarized in one pass over a copy of its
+     * draws pooled across chains, with the effective sample size and
+     * split R hat computed as by <code>compute_diagnostics</code>.
+     * Parameters are divided among the threads, each of which reuses
+     * its buffers for all of its parameters.  The effective sample
+     * size and split R hat are not a number if any chain has fewer
+     * than four draws.
+     *
+     * @tparam M type of the draws of a chain, an Eigen matrix
+     *   expression with one row per draw and one column per parameter
+     * @param[in] draws draws of each chain, all with the same columns
+     * @param[in] probs probabilities of the quantiles
+     * @param[out] summaries summary of each parameter
+     * @param[in] num_threads maximum number of threads to use
+     * @throw std::invalid_argument if there are no chains or the
+     *   chains have different numbers of columns
+     */
+    template <typename M>
+    void compute_summary(const std::vector<M>& draws,
+                         const Eigen::VectorXd& probs,
+                         std::vector<parameter_summary>& summaries,
+                         int num_threads) {
+      if (draws.empty())
+        throw std::invalid_argument("compute_summary: no chains");
+      int num_params = draws[0].cols();
+      size_t num_draws = 0;
+      bool diagnostics = true;
+      for (size_t chain = 0; chain < draws.size(); ++chain) {
+        if (draws[chain].cols() != num_params)
+          throw std::invalid_argument("compute_summary: chains have"
+                                      " different numbers of parameters");
+        num_draws += draws[chain].rows();
+        diagnostics = diagnostics && draws[chain].rows() >= 4;
+      }
+
+      summaries.resize(num_params);
+      num_threads = std::max(1, std::min(num_threads, num_params));
+      util::parallel_for(0, num_threads, [&](size_t thread) {
+          diagnostics_workspace workspace;
+          std::vector<double> x(num_draws);
+          for (int param = thread; param < num_params;
+               param += num_threads) {
+            parameter_summary& summary = summaries[param];
+            size_t n = 0;
+            for (size_t chain = 0; chain < draws.size(); ++chain)
+              for (int i = 0; i < draws[chain].rows(); ++i)
+                x[n++] = draws[chain](i, param);
+
+            double sum = 0;
+            for (size_t i = 0; i < num_draws; ++i)
+              sum += x[i];
+            summary.mean = sum / num_draws;
+            double sum_sq = 0;
+            for (size_t i = 0; i < num_draws; ++i)
+              sum_sq += (x[i] - summary.mean) * (x[i] - summary.mean);
+            summary.sd = std::sqrt(sum_sq / (num_draws - 1));
+
+            compute_quantiles(x, probs, summary.quantiles);
+
+            if (diagnostics) {
+              compute_diagnostics(draws, param, workspace, summary.ess,
+                                  summary.split_rhat);
+            } else {
+              summary.ess = std::numeric_limits<double>::quiet_NaN();
+              summary.split_rhat = std::numeric_limits<double>::quiet_NaN();
+            }
+            summary.mcse = summary.sd / std::sqrt(summary.ess);
+          }
+        }, num_threads);
+    }
+
+    /**
+     * Summarizes the draws of every parameter, using the number of
+     * threads given by <code>STAN_NUM_THREADS</code>.
+     *
+     * @tparam M type of the draws of a chain, an Eigen matrix
+     *   expression with one row per draw and one column per parameter
+     * @param[in] draws draws of each chain, all with the same columns
+     * @param[in] probs probabilities of the quantiles
+     * @param[out] summaries summary of each parameter
+     * @throw std::invalid_argument if there are no chains or the
+     *   chains have different numbers of columns
+     */
+    template <typename M>
+    void compute_summary(const std::vector<M>& draws,
+                         const Eigen::VectorXd& probs,
+                         std::vector<parameter_summary>& summaries) {
+      int num_params = draws.empty() ? 0 : draws[0].cols();
+      compute_summary(draws, probs, summaries,
+                      util::get_num_threads(num_params));
+    }
+
+  }
+}
+
+#endif
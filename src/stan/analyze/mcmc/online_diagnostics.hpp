@@ -0,0 +1,278 @@
+#ifndef STAN_ANALYZE_MCMC_ONLINE_DIAGNOSTICS_HPP
+#define STAN_ANALYZE_MCMC_ONLINE_DIAGNOSTICS_HPP
+
+#include <Eigen/Dense>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace stan {
+  namespace analyze {
+
+    /**
+     * Accumulates draws of several chains one at a time and estimates
+     * the effective sample size and split potential scale reduction
+     * (split R hat) of every parameter at any point, without storing
+     * the draws.
+     *
+     * The draws of each chain are summarized by batches of equal
+     * size, each holding the mean and sum of squared deviations of
+     * its draws, updated with Welford's algorithm.  When the number
+     * of complete batches reaches twice <code>num_batches</code>,
+     * neighbouring batches are merged and the batch size doubles, so
+     * a chain of <code>n</code> draws takes memory proportional to
+     * <code>num_batches</code> rather than <code>n</code>.  Draws in
+     * the incomplete last batch are not used in the estimates.
+     *
+     * The effective sample size of a chain is its batch means
+     * estimate: the number of draws times their variance divided by
+     * the batch size times the variance of the batch means.  The
+     * effective sample size of a parameter is the sum over chains.
+     * Split R hat splits the complete batches of each chain into a
+     * first and second half, dropping the middle batch if there is an
+     * odd number of them.
+     *
+     * Each chain may be updated from its own thread while the
+     * estimates are read from any thread.
+     */
+    class online_diagnostics {
+    public:
+      /**
+       * Construct an accumulator with no draws.
+       *
+       * @param[in] num_chains number of chains
+       * @param[in] num_params number of parameters
+       * @param[in] num_batches minimum number of batches once batches
+       *   have started to be merged; must be at least two
+       * @throw std::invalid_argument if there are no chains or fewer
+       *   than two batches
+       */
+      online_diagnostics(size_t num_chains, size_t num_params,
+                         size_t num_batches = 16)
+        : num_params_(num_params), num_batches_(num_batches) {
+        if (num_chains == 0)
+          throw std::invalid_argument("online_diagnostics: no chains");
+        if (num_batches < 2)
+          throw std::invalid_argument("online_diagnostics: num_batches must"
+                                      " be at least 2");
+        for (size_t chain = 0; chain < num_chains; ++chain)
+          chains_.push_back(std::unique_ptr<chain_state>(
+              new chain_state(num_params, 2 * num_batches)));
+      }
+
+      size_t num_chains() const {
+        return chains_.size();
+      }
+
+      size_t num_params() const {
+        return num_params_;
+      }
+
+      /**
+       * Add a draw to a chain.
+       *
+       * @param[in] chain index of the chain
+       * @param[in] draw value of each parameter
+       * @throw std::invalid_argument if the draw has the wrong size
+       */
+      void add_sample(size_t chain, const Eigen::VectorXd& draw) {
+        if (static_cast<size_t>(draw.size()) != num_params_)
+          throw std::invalid_argument("online_diagnostics: draw has the"
+                                      " wrong number of parameters");
+        chain_state& state = *chains_[chain];
+        std::lock_guard<std::mutex> lock(state.mutex);
+        ++state.num_draws;
+        ++state.batch_draws;
+        state.delta = draw - state.batch_mean;
+        state.batch_mean += state.delta / state.batch_draws;
+        state.batch_m2 += state.delta.cwiseProduct(draw - state.batch_mean);
+        if (state.batch_draws < state.batch_size)
+          return;
+
+        state.means.col(state.num_batches) = state.batch_mean;
+        state.m2s.col(state.num_batches) = state.batch_m2;
+        ++state.num_batches;
+        state.batch_draws = 0;
+        state.batch_mean.setZero();
+        state.batch_m2.setZero();
+        if (state.num_batches < 2 * num_batches_)
+          return;
+
+        // merge neighbouring batches of equal size
+        for (size_t k = 0; k < num_batches_; ++k) {
+          Eigen::VectorXd diff = state.means.col(2 * k + 1)
+            - state.means.col(2 * k);
+          state.m2s.col(k) = state.m2s.col(2 * k) + state.m2s.col(2 * k + 1)
+            + diff.cwiseProduct(diff) * (state.batch_size / 2.0);
+          state.means.col(k) = (state.means.col(2 * k)
+                                + state.means.col(2 * k + 1)) / 2;
+        }
+        state.num_batches = num_batches_;
+        state.batch_size *= 2;
+      }
+
+      /**
+       * Return the number of draws added to a chain.
+       *
+       * @param[in] chain index of the chain
+       */
+      size_t num_draws(size_t chain) const {
+        chain_state& state = *chains_[chain];
+        std::lock_guard<std::mutex> lock(state.mutex);
+        return state.num_draws;
+      }
+
+      /**
+       * Return the effective sample size of every parameter, which is
+       * not a number until every chain has two complete batches.
+       */
+      Eigen::VectorXd effective_sample_size() const {
+        Eigen::VectorXd ess = Eigen::VectorXd::Zero(num_params_);
+        for (size_t chain = 0; chain < chains_.size(); ++chain) {
+          chain_state& state = *chains_[chain];
+          std::lock_guard<std::mutex> lock(state.mutex);
+          size_t k = state.num_batches;
+          if (k < 2)
+            return Eigen::VectorXd::Constant(
+                num_params_, std::numeric_limits<double>::quiet_NaN());
+          Eigen::VectorXd mean, var_means, var;
+          summarize(state, 0, k, mean, var_means, var);
+          // n var / (b var_means) with n = k b draws
+          ess.array() += k * var.array() / var_means.array();
+        }
+        return ess;
+      }
+
+      /**
+       * Return the split R hat of every parameter, which is not a
+       * number until every chain has two complete batches.
+       */
+      Eigen::VectorXd split_potential_scale_reduction() const {
+        size_t num_halves = 2 * chains_.size();
+        Eigen::MatrixXd half_means(num_params_, num_halves);
+        Eigen::MatrixXd half_vars(num_params_, num_halves);
+        double n = 0;
+        for (size_t chain = 0; chain < chains_.size(); ++chain) {
+          chain_state& state = *chains_[chain];
+          std::lock_guard<std::mutex> lock(state.mutex);
+          size_t half = state.num_batches / 2;
+          if (half < 1)
+            return Eigen::VectorXd::Constant(
+                num_params_, std::numeric_limits<double>::quiet_NaN());
+          Eigen::VectorXd mean, var_means, var;
+          summarize(state, 0, half, mean, var_means, var);
+          half_means.col(2 * chain) = mean;
+          half_vars.col(2 * chain) = var;
+          summarize(state, state.num_batches - half, state.num_batches,
+                    mean, var_means, var);
+          half_means.col(2 * chain + 1) = mean;
+          half_vars.col(2 * chain + 1) = var;
+          n += static_cast<double>(half) * state.batch_size;
+        }
+        n /= chains_.size();
+
+        Eigen::VectorXd mean = half_means.rowwise().mean();
+        Eigen::VectorXd var_between = n
+          * (half_means.colwise() - mean).rowwise().squaredNorm()
+          / (num_halves - 1);
+        Eigen::VectorXd var_within = half_vars.rowwise().mean();
+        return ((var_between.array() / var_within.array() + n - 1) / n)
+          .sqrt();
+      }
+
+      /**
+       * Return true if every chain has enough draws for reliable
+       * estimates and every parameter has at least the given
+       * effective sample size and at most the given split R hat.
+       * Estimates are considered reliable once the batch size is at
+       * least <code>num_batches</code>, so each chain needs at least
+       * <code>num_batches</code> squared draws.
+       *
+       * @param[in] min_ess minimum effective sample size
+       * @param[in] max_rhat maximum split R hat
+       */
+      bool converged(double min_ess, double max_rhat) const {
+        for (size_t chain = 0; chain < chains_.size(); ++chain)
+          if (num_draws(chain) < num_batches_ * num_batches_)
+            return false;
+        Eigen::VectorXd ess = effective_sample_size();
+        Eigen::VectorXd rhat = split_potential_scale_reduction();
+        for (size_t n = 0; n < num_params_; ++n)
+          if (!(ess(n) >= min_ess && rhat(n) <= max_rhat))
+            return false;
+        return true;
+      }
+
+      /**
+       * Remove all draws.
+       */
+      void restart() {
+        for (size_t chain = 0; chain < chains_.size(); ++chain) {
+          chain_state& state = *chains_[chain];
+          std::lock_guard<std::mutex> lock(state.mutex);
+          state.restart();
+        }
+      }
+
+    private:
+      struct chain_state {
+        chain_state(size_t num_params, size_t max_batches)
+          : means(num_params, max_batches), m2s(num_params, max_batches),
+            batch_mean(num_params), batch_m2(num_params),
+            delta(num_params) {
+          restart();
+        }
+
+        void restart() {
+          num_draws = 0;
+          num_batches = 0;
+          batch_size = 1;
+          batch_draws = 0;
+          batch_mean.setZero();
+          batch_m2.setZero();
+        }
+
+        std::mutex mutex;
+        size_t num_draws;
+        size_t num_batches;
+        size_t batch_size;
+        size_t batch_draws;
+        Eigen::MatrixXd means;
+        Eigen::MatrixXd m2s;
+        Eigen::VectorXd batch_mean;
+        Eigen::VectorXd batch_m2;
+        Eigen::VectorXd delta;
+      };
+
+      /**
+       * Compute the mean of the draws in batches <code>[first,
+       * last)</code> of a chain, the variance of their batch means and
+       * the variance of the draws.
+       */
+      static void summarize(const chain_state& state, size_t first,
+                            size_t last, Eigen::VectorXd& mean,
+                            Eigen::VectorXd& var_means,
+                            Eigen::VectorXd& var) {
+        size_t k = last - first;
+        double b = state.batch_size;
+        mean = state.means.middleCols(first, k).rowwise().mean();
+        Eigen::VectorXd ss = (state.means.middleCols(first, k).colwise()
+                              - mean).rowwise().squaredNorm();
+        var_means = ss / (k - 1);
+        var = (state.m2s.middleCols(first, k).rowwise().sum() + b * ss)
+          / (k * b - 1);
+      }
+
+      size_t num_params_;
+      size_t num_batches_;
+      std::vector<std::unique_ptr<chain_state> > chains_;
+    };
+
+  }
+}
+
+#endif
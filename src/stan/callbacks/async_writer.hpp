@@ -0,0 +1,254 @@
+#ifndef STAN_CALLBACKS_ASYNC_WRITER_HPP
+#define STAN_CALLBACKS_ASYNC_WRITER_HPP
+
+#include <stan/callbacks/writer.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace stan {
+  namespace callbacks {
+
+    /**
+     * <code>async_writer</code> is an implementation of
+     * <code>writer</code> that passes every call on to another writer
+     * from a background thread, so the caller does not wait for
+     * formatting or I/O.
+     *
+     * Calls are copied into a bounded single-producer single-consumer
+     * ring buffer.  When the buffer is full the caller waits for the
+     * background thread to make room, so memory use is bounded and a
+     * writer that cannot keep up slows the caller down rather than
+     * falling further behind.  Buffered calls are passed on in order,
+     * and all of them have been passed on when <code>flush</code>
+     * returns or the writer is destroyed, including when it is
+     * destroyed while unwinding from an interrupt.
+     *
+     * The writer must only be called from one thread at a time.  The
+     * wrapped writer is only called from the background thread.  An
+     * exception thrown by the wrapped writer is rethrown by the next
+     * call to this writer, after which further calls are dropped.
+     */
+    class async_writer : public writer {
+    public:
+      /**
+       * Constructs an asynchronous writer passing calls on to the
+       * given writer.
+       *
+       * @param[in, out] output writer the calls are passed on to
+       * @param[in] capacity maximum number of buffered calls. Must be
+       *   greater than or equal to 1.
+       */
+      explicit async_writer(writer& output, size_t capacity = 64)
+        : output_(output), records_(capacity), head_(0), tail_(0),
+          consumer_waiting_(false), producer_waiting_(false), done_(false),
+          failed_(false) {
+        thread_ = std::thread(&async_writer::drain, this);
+      }
+
+      /**
+       * Destructor passes on all buffered calls and stops the
+       * background thread.  Errors from the wrapped writer are
+       * discarded.
+       */
+      virtual ~async_writer() {
+        wait_until_empty();
+        {
+          std::lock_guard<std::mutex> lock(mutex_);
+          done_ = true;
+        }
+        not_empty_.notify_one();
+        thread_.join();
+      }
+
+      /**
+       * Writes a set of names.
+       *
+       * @param[in] names Names in a std::vector
+       */
+      void operator()(const std::vector<std::string>& names) {
+        record& r = begin_push(NAMES);
+        r.names = names;
+        end_push(r);
+      }
+
+      /**
+       * Writes a set of values.
+       *
+       * @param[in] state Values in a std::vector
+       */
+      void operator()(const std::vector<double>& state) {
+        record& r = begin_push(VALUES);
+        r.values.assign(state.begin(), state.end());
+        end_push(r);
+      }
+
+      /**
+       * Writes blank input.
+       */
+      void operator()() {
+        end_push(begin_push(BLANK));
+      }
+
+      /**
+       * Writes a string.
+       *
+       * @param[in] message A string
+       */
+      void operator()(const std::string& message) {
+        record& r = begin_push(MESSAGE);
+        r.message = message;
+        end_push(r);
+      }
+
+      /**
+       * Wait until every buffered call has been passed on.
+       *
+       * @throw any exception thrown by the wrapped writer
+       */
+      void flush() {
+        wait_until_empty();
+        rethrow();
+      }
+
+    private:
+      enum record_type { NAMES, VALUES, BLANK, MESSAGE };
+
+      /**
+       * A buffered call.  Slots are reused, so their vectors and
+       * strings keep their storage from one call to the next.
+       */
+      struct record {
+        record_type type;
+        std::vector<std::string> names;
+        std::vector<double> values;
+        std::string message;
+      };
+
+      /**
+       * Return the slot for the next call, waiting for one to be free,
+       * or a scratch slot once the wrapped writer has failed.
+       */
+      record& begin_push(record_type type) {
+        rethrow();
+        if (failed_)
+          return dropped_;
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load() == records_.size()) {
+          std::unique_lock<std::mutex> lock(mutex_);
+          producer_waiting_ = true;
+          not_full_.wait(lock, [this, tail]() {
+              return tail - head_.load() < records_.size();
+            });
+          producer_waiting_ = false;
+        }
+        record& r = records_[tail % records_.size()];
+        r.type = type;
+        return r;
+      }
+
+      void end_push(const record& r) {
+        if (&r == &dropped_)
+          return;
+        tail_.fetch_add(1);
+        if (consumer_waiting_) {
+          std::lock_guard<std::mutex> lock(mutex_);
+          not_empty_.notify_one();
+        }
+      }
+
+      void drain() {
+        while (true) {
+          size_t head = head_.load(std::memory_order_relaxed);
+          if (head == tail_.load()) {
+            std::unique_lock<std::mutex> lock(mutex_);
+            consumer_waiting_ = true;
+            not_empty_.wait(lock, [this, head]() {
+                return done_ || head != tail_.load();
+              });
+            consumer_waiting_ = false;
+            if (head == tail_.load())
+              return;
+          }
+
+          record& r = records_[head % records_.size()];
+          if (!failed_) {
+            try {
+              write(r);
+            } catch (...) {
+              error_ = std::current_exception();
+              failed_ = true;
+            }
+          }
+
+          head_.fetch_add(1);
+          if (producer_waiting_) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            not_full_.notify_one();
+          }
+        }
+      }
+
+      void write(const record& r) {
+        switch (r.type) {
+        case NAMES:
+          output_(r.names);
+          break;
+        case VALUES:
+          output_(r.values);
+          break;
+        case BLANK:
+          output_();
+          break;
+        case MESSAGE:
+          output_(r.message);
+          break;
+        }
+      }
+
+      void wait_until_empty() {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (head_.load() == tail)
+          return;
+        std::unique_lock<std::mutex> lock(mutex_);
+        producer_waiting_ = true;
+        not_full_.wait(lock, [this, tail]() {
+            return head_.load() == tail;
+          });
+        producer_waiting_ = false;
+      }
+
+      void rethrow() {
+        if (!failed_ || !error_)
+          return;
+        std::exception_ptr error = error_;
+        error_ = std::exception_ptr();
+        std::rethrow_exception(error);
+      }
+
+      writer& output_;
+      std::vector<record> records_;
+      record dropped_;
+
+      std::atomic<size_t> head_;
+      std::atomic<size_t> tail_;
+
+      std::mutex mutex_;
+      std::condition_variable not_empty_;
+      std::condition_variable not_full_;
+      std::atomic<bool> consumer_waiting_;
+      std::atomic<bool> producer_waiting_;
+      bool done_;
+
+      std::atomic<bool> failed_;
+      std::exception_ptr error_;
+      std::thread thread_;
+    };
+
+  }
+}
+#endif
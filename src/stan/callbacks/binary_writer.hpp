@@ -0,0 +1,144 @@
+#ifndef STAN_CALLBACKS_BINARY_WRITER_HPP
+#define STAN_CALLBACKS_BINARY_WRITER_HPP
+
+#include <stan/callbacks/writer.hpp>
+#include <stan/io/stan_binary_format.hpp>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace stan {
+  namespace callbacks {
+
+    /**
+     * <code>binary_writer</code> is an implementation of
+     * <code>writer</code> that writes to a stream in the binary
+     * columnar format described in <code>io::stan_binary</code>.
+     *
+     * Values are buffered and written as blocks of columns, so draws
+     * are stored exactly and without formatting.  A partial block is
+     * written before any names or comments, so the order of the
+     * output is preserved, and when the writer is flushed or
+     * destroyed.  The stream should be opened in binary mode.
+     */
+    class binary_writer : public writer {
+    public:
+      /**
+       * Constructs a binary writer with an output stream and the
+       * number of rows of values in each block.
+       *
+       * @param[in, out] output stream to write
+       * @param[in] block_size number of rows in each block. Must be
+       *   greater than or equal to 1.
+       */
+      explicit binary_writer(std::ostream& output, size_t block_size = 1024)
+        : output_(output), block_size_(block_size), num_rows_(0),
+          num_cols_(0) {
+        output_.write(io::stan_binary::magic, io::stan_binary::magic_size);
+      }
+
+      /**
+       * Destructor writes any buffered values.
+       */
+      virtual ~binary_writer() {
+        flush();
+      }
+
+      /**
+       * Writes a set of names.
+       *
+       * @param[in] names Names in a std::vector
+       */
+      void operator()(const std::vector<std::string>& names) {
+        flush();
+        output_.put(io::stan_binary::names_record);
+        io::stan_binary::write_size(output_, names.size());
+        for (size_t n = 0; n < names.size(); ++n)
+          io::stan_binary::write_string(output_, names[n]);
+      }
+
+      /**
+       * Adds a set of values to the current block, writing the block
+       * once it is full.  A set of values of a different size from the
+       * rest of the block starts a new block.
+       *
+       * @param[in] state Values in a std::vector
+       */
+      void operator()(const std::vector<double>& state) {
+        if (state.empty())
+          return;
+        if (num_rows_ > 0 && state.size() != num_cols_)
+          flush();
+        if (num_rows_ == 0) {
+          num_cols_ = state.size();
+          buffer_.resize(num_cols_ * block_size_);
+        }
+        for (size_t col = 0; col < num_cols_; ++col)
+          buffer_[col * block_size_ + num_rows_] = state[col];
+        if (++num_rows_ == block_size_)
+          flush();
+      }
+
+      /**
+       * Writes an empty comment.
+       */
+      void operator()() {
+        (*this)(std::string());
+      }
+
+      /**
+       * Writes a comment.
+       *
+       * @param[in] message A string
+       */
+      void operator()(const std::string& message) {
+        flush();
+        output_.put(io::stan_binary::comment_record);
+        io::stan_binary::write_string(output_, message);
+      }
+
+      /**
+       * Writes the buffered values, if any, as a block.
+       */
+      void flush() {
+        if (num_rows_ == 0)
+          return;
+        output_.put(io::stan_binary::draws_record);
+        io::stan_binary::write_size(output_, num_rows_);
+        io::stan_binary::write_size(output_, num_cols_);
+        for (size_t col = 0; col < num_cols_; ++col)
+          io::stan_binary::write_doubles(output_, &buffer_[col * block_size_],
+                                         num_rows_);
+        num_rows_ = 0;
+      }
+
+    private:
+      /**
+       * Output stream
+       */
+      std::ostream& output_;
+
+      /**
+       * Maximum number of rows in a block
+       */
+      size_t block_size_;
+
+      /**
+       * Number of rows in the current block
+       */
+      size_t num_rows_;
+
+      /**
+       * Number of columns in the current block
+       */
+      size_t num_cols_;
+
+      /**
+       * Values of the current block, stored by column
+       */
+      std::vector<double> buffer_;
+    };
+
+  }
+}
+#endif
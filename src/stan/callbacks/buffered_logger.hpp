@@ -0,0 +1,100 @@
+#ifndef STAN_CALLBACKS_BUFFERED_LOGGER_HPP
+#define STAN_CALLBACKS_BUFFERED_LOGGER_HPP
+
+#include <stan/callbacks/logger.hpp>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace stan {
+  namespace callbacks {
+
+    /**
+     * <code>buffered_logger</code> is an implementation of
+     * <code>logger</code> that holds on to its messages until they are
+     * flushed to another logger.  It lets work done on other threads
+     * log as if it had been done in order on the calling thread.
+     */
+    class buffered_logger : public logger {
+    public:
+      void debug(const std::string& message) {
+        messages_.push_back(std::make_pair(debug_level, message));
+      }
+
+      void debug(const std::stringstream& message) {
+        debug(message.str());
+      }
+
+      void info(const std::string& message) {
+        messages_.push_back(std::make_pair(info_level, message));
+      }
+
+      void info(const std::stringstream& message) {
+        info(message.str());
+      }
+
+      void warn(const std::string& message) {
+        messages_.push_back(std::make_pair(warn_level, message));
+      }
+
+      void warn(const std::stringstream& message) {
+        warn(message.str());
+      }
+
+      void error(const std::string& message) {
+        messages_.push_back(std::make_pair(error_level, message));
+      }
+
+      void error(const std::stringstream& message) {
+        error(message.str());
+      }
+
+      void fatal(const std::string& message) {
+        messages_.push_back(std::make_pair(fatal_level, message));
+      }
+
+      void fatal(const std::stringstream& message) {
+        fatal(message.str());
+      }
+
+      /**
+       * Send the buffered messages to a logger in the order they were
+       * logged and empty the buffer.
+       *
+       * @param[in,out] logger logger to send the messages to
+       */
+      void flush(logger& logger) {
+        for (size_t n = 0; n < messages_.size(); ++n) {
+          const std::string& message = messages_[n].second;
+          switch (messages_[n].first) {
+          case debug_level:
+            logger.debug(message);
+            break;
+          case info_level:
+            logger.info(message);
+            break;
+          case warn_level:
+            logger.warn(message);
+            break;
+          case error_level:
+            logger.error(message);
+            break;
+          case fatal_level:
+            logger.fatal(message);
+            break;
+          }
+        }
+        messages_.clear();
+      }
+
+    private:
+      enum level { debug_level, info_level, warn_level, error_level,
+                   fatal_level };
+
+      std::vector<std::pair<level, std::string> > messages_;
+    };
+
+  }
+}
+#endif
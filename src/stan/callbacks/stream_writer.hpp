@@ -2,6 +2,8 @@
 #define STAN_CALLBACKS_STREAM_WRITER_HPP
 
 #include <stan/callbacks/writer.hpp>
+#include <stan/io/format_double.hpp>
+#include <algorithm>
 #include <ostream>
 #include <vector>
 #include <string>
@@ -15,17 +17,43 @@ namespace stan {
      */
     class stream_writer : public writer {
     public:
+      enum {
+        /**
+         * Precision which writes each value with the fewest digits
+         * that read back as the same value.
+         */
+        shortest_precision = 0,
+
+        /**
+         * Precision which writes values with the settings of the
+         * stream, as <code>operator<<</code> would.
+         */
+        stream_precision = -1
+      };
+
       /**
        * Constructs a stream writer with an output stream
        * and an optional prefix for comments.
        *
+       * Values are formatted without the stream's locale.  Streams
+       * with formatting flags set or more than 17 digits of precision
+       * are written with <code>operator<<</code>; otherwise the output
+       * matches <code>operator<<</code> in the classic locale.
+       *
        * @param[in, out] output stream to write
        * @param[in] comment_prefix string to stream before
        *   each comment line. Default is "".
+       * @param[in] precision number of significant digits of values,
+       *   <code>shortest_precision</code> to write values so they read
+       *   back exactly, or <code>stream_precision</code> to use the
+       *   precision of the stream. Default is
+       *   <code>stream_precision</code>.
        */
       stream_writer(std::ostream& output,
-                    const std::string& comment_prefix = ""):
-        output_(output), comment_prefix_(comment_prefix) {}
+                    const std::string& comment_prefix = "",
+                    int precision = stream_precision):
+        output_(output), comment_prefix_(comment_prefix),
+        precision_(precision) {}
 
       /**
        * Virtual destructor
@@ -47,13 +75,39 @@ namespace stan {
       /**
        * Writes a set of values in csv format followed by a newline.
        *
-       * Note: the precision of the output is determined by the settings
-       *  of the stream on construction.
+       * Note: the precision of the output is determined by the
+       *  precision given on construction.
        *
        * @param[in] state Values in a std::vector
        */
       void operator()(const std::vector<double>& state) {
-        write_vector(state);
+        if (state.empty()) return;
+
+        int precision = precision_;
+        if (precision == stream_precision) {
+          std::ios_base::fmtflags flags = std::ios_base::floatfield
+            | std::ios_base::showpos | std::ios_base::showpoint
+            | std::ios_base::uppercase;
+          if ((output_.flags() & flags) || output_.width() != 0
+              || output_.precision() > 17) {
+            write_vector(state);
+            return;
+          }
+          precision = std::max(1, static_cast<int>(output_.precision()));
+        }
+
+        line_.resize(state.size() * io::format_double_buffer_size);
+        char* out = &line_[0];
+        for (size_t i = 0; i < state.size(); ++i) {
+          if (i > 0)
+            *out++ = ',';
+          if (precision == shortest_precision)
+            out += io::format_double(state[i], out);
+          else
+            out += io::format_double(state[i], precision, out);
+        }
+        output_.write(&line_[0], out - &line_[0]);
+        output_ << std::endl;
       }
 
       /**
@@ -83,6 +137,16 @@ namespace stan {
        */
       std::string comment_prefix_;
 
+      /**
+       * Number of significant digits of values
+       */
+      int precision_;
+
+      /**
+       * Buffer for a line of formatted values
+       */
+      std::string line_;
+
       /**
        * Writes a set of values in csv format followed by a newline.
        *
@@ -3,9 +3,10 @@
 
 #include <stan/io/var_context.hpp>
 #include <boost/throw_exception.hpp>
-#include <map>
+#include <algorithm>
 #include <sstream>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <utility>
 
@@ -28,12 +29,12 @@ namespace stan {
      */
     class array_var_context : public var_context {
     private:
-      std::map<std::string,
-               std::pair<std::vector<double>,
-                         std::vector<size_t> > > vars_r_;
-      std::map<std::string,
-               std::pair<std::vector<int>,
-                         std::vector<size_t> > > vars_i_;
+      std::unordered_map<std::string,
+                         std::pair<std::vector<double>,
+                                   std::vector<size_t> > > vars_r_;
+      std::unordered_map<std::string,
+                         std::pair<std::vector<int>,
+                                   std::vector<size_t> > > vars_i_;
       std::vector<double> const empty_vec_r_;
       std::vector<int> const empty_vec_i_;
       std::vector<size_t> const empty_vec_ui_;
@@ -234,6 +235,53 @@ namespace stan {
         return empty_vec_ui_;
       }
 
+      /**
+       * Read the double values and dimensions for the variable with
+       * the specified name, converting integer values to doubles.
+       *
+       * @param name Name of variable.
+       * @param vals Set to the values of the variable.
+       * @param dims Set to the dimensions of the variable.
+       * @return <code>true</code> if the variable exists.
+       */
+      bool lookup_r(const std::string& name, std::vector<double>& vals,
+                    std::vector<size_t>& dims) const {
+        if (contains_r_only(name)) {
+          const std::pair<std::vector<double>, std::vector<size_t> >& var
+            = vars_r_.find(name)->second;
+          vals = var.first;
+          dims = var.second;
+          return true;
+        }
+        if (!contains_i(name))
+          return false;
+        const std::pair<std::vector<int>, std::vector<size_t> >& var
+          = vars_i_.find(name)->second;
+        vals.assign(var.first.begin(), var.first.end());
+        dims = var.second;
+        return true;
+      }
+
+      /**
+       * Read the integer values and dimensions for the integer
+       * variable with the specified name.
+       *
+       * @param name Name of variable.
+       * @param vals Set to the values of the variable.
+       * @param dims Set to the dimensions of the variable.
+       * @return <code>true</code> if the integer variable exists.
+       */
+      bool lookup_i(const std::string& name, std::vector<int>& vals,
+                    std::vector<size_t>& dims) const {
+        if (!contains_i(name))
+          return false;
+        const std::pair<std::vector<int>, std::vector<size_t> >& var
+          = vars_i_.find(name)->second;
+        vals = var.first;
+        dims = var.second;
+        return true;
+      }
+
       /**
        * Return a list of the names of the floating point variables in
        * the dump.
@@ -242,12 +290,13 @@ namespace stan {
        */
       virtual void names_r(std::vector<std::string>& names) const {
         names.resize(0);
-        for (std::map<std::string,
-                      std::pair<std::vector<double>,
-                                std::vector<size_t> > >
+        for (std::unordered_map<std::string,
+                                std::pair<std::vector<double>,
+                                          std::vector<size_t> > >
                  ::const_iterator it = vars_r_.begin();
              it != vars_r_.end(); ++it)
           names.push_back((*it).first);
+        std::sort(names.begin(), names.end());
       }
 
       /**
@@ -258,12 +307,13 @@ namespace stan {
        */
       virtual void names_i(std::vector<std::string>& names) const {
         names.resize(0);
-        for (std::map<std::string,
-                      std::pair<std::vector<int>,
-                                std::vector<size_t> > >
+        for (std::unordered_map<std::string,
+                                std::pair<std::vector<int>,
+                                          std::vector<size_t> > >
                  ::const_iterator it = vars_i_.begin();
              it != vars_i_.end(); ++it)
           names.push_back((*it).first);
+        std::sort(names.begin(), names.end());
       }
 
       /**
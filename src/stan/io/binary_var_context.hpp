@@ -0,0 +1,402 @@
+#ifndef STAN_IO_BINARY_VAR_CONTEXT_HPP
+#define STAN_IO_BINARY_VAR_CONTEXT_HPP
+
+#include <stan/io/stan_binary_format.hpp>
+#include <stan/io/var_context.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <ostream>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace stan {
+  namespace io {
+
+    /**
+     * A <code>binary_var_context</code> is a <code>var_context</code>
+     * read from a binary file that is mapped into memory rather than
+     * parsed, so that opening it takes time proportional to the number
+     * of variables rather than the number of values, and processes
+     * reading the same file share its pages.  Files are written from
+     * any other <code>var_context</code>, such as a <code>dump</code>
+     * or <code>json_data</code>, by <code>write</code>.
+     *
+     * <p>A file is laid out as follows, with every size an unsigned
+     * 64 bit integer and every number stored little-endian:
+     *
+     * <ul>
+     * <li>the eight byte <code>magic</code> string;</li>
+     * <li>the number of variables;</li>
+     * <li>for each variable, the length of its name, its characters
+     *   padded with zeros to a multiple of eight bytes, its type
+     *   (<code>real_type</code> or <code>int_type</code>), its number
+     *   of dimensions, each dimension and the offset of its values
+     *   from the start of the file;</li>
+     * <li>the values of each variable in last-index-major order, as
+     *   IEEE 754 doubles or 32 bit signed integers, starting at an
+     *   offset that is a multiple of eight.</li>
+     * </ul>
+     *
+     * <p>On little-endian hosts values are returned by
+     * <code>vals_r_ptr</code> and <code>vals_i_ptr</code> directly
+     * from the mapped file.
+     */
+    class binary_var_context : public var_context {
+    public:
+      static const char* magic() {
+        return "STANVAR1";
+      }
+
+      enum var_type { real_type = 0, int_type = 1 };
+
+      /**
+       * Map the given file and read its index of variables.
+       *
+       * @param file_name name of the file
+       * @throw std::invalid_argument if the file cannot be mapped or
+       * is not in the binary format
+       */
+      explicit binary_var_context(const std::string& file_name) {
+        try {
+          boost::interprocess::file_mapping
+            file(file_name.c_str(), boost::interprocess::read_only);
+          boost::interprocess::mapped_region
+            region(file, boost::interprocess::read_only);
+          region_.swap(region);
+        } catch (const std::exception& e) {
+          throw std::invalid_argument("could not map " + file_name + ": "
+                                      + e.what());
+        }
+        read_index(static_cast<const char*>(region_.get_address()),
+                   region_.get_size());
+      }
+
+      /**
+       * Read the index of variables of a file held in memory, which
+       * must outlive the context.
+       *
+       * @param data first byte of the file
+       * @param size number of bytes
+       * @throw std::invalid_argument if the memory is not in the
+       * binary format
+       */
+      binary_var_context(const char* data, size_t size) {
+        read_index(data, size);
+      }
+
+      bool contains_r(const std::string& name) const {
+        return vars_.find(name) != vars_.end();
+      }
+
+      std::vector<double> vals_r(const std::string& name) const {
+        vars_map::const_iterator it = vars_.find(name);
+        if (it == vars_.end())
+          return std::vector<double>();
+        const var& v = it->second;
+        if (v.type == real_type) {
+          std::vector<double> vals(v.size);
+          read_values(v, vals.data());
+          return vals;
+        }
+        std::vector<int> vals_int(v.size);
+        read_values(v, vals_int.data());
+        return std::vector<double>(vals_int.begin(), vals_int.end());
+      }
+
+      std::vector<size_t> dims_r(const std::string& name) const {
+        vars_map::const_iterator it = vars_.find(name);
+        return it == vars_.end() ? std::vector<size_t>() : it->second.dims;
+      }
+
+      bool contains_i(const std::string& name) const {
+        vars_map::const_iterator it = vars_.find(name);
+        return it != vars_.end() && it->second.type == int_type;
+      }
+
+      std::vector<int> vals_i(const std::string& name) const {
+        if (!contains_i(name))
+          return std::vector<int>();
+        const var& v = vars_.find(name)->second;
+        std::vector<int> vals(v.size);
+        read_values(v, vals.data());
+        return vals;
+      }
+
+      std::vector<size_t> dims_i(const std::string& name) const {
+        return contains_i(name) ? vars_.find(name)->second.dims
+          : std::vector<size_t>();
+      }
+
+      bool lookup_r(const std::string& name, std::vector<double>& vals,
+                    std::vector<size_t>& dims) const {
+        vars_map::const_iterator it = vars_.find(name);
+        if (it == vars_.end())
+          return false;
+        const var& v = it->second;
+        if (v.type == real_type) {
+          vals.resize(v.size);
+          read_values(v, vals.data());
+        } else {
+          std::vector<int> vals_int(v.size);
+          read_values(v, vals_int.data());
+          vals.assign(vals_int.begin(), vals_int.end());
+        }
+        dims = v.dims;
+        return true;
+      }
+
+      bool lookup_i(const std::string& name, std::vector<int>& vals,
+                    std::vector<size_t>& dims) const {
+        vars_map::const_iterator it = vars_.find(name);
+        if (it == vars_.end() || it->second.type != int_type)
+          return false;
+        vals.resize(it->second.size);
+        read_values(it->second, vals.data());
+        dims = it->second.dims;
+        return true;
+      }
+
+      void names_r(std::vector<std::string>& names) const {
+        names.resize(0);
+        for (vars_map::const_iterator it = vars_.begin();
+             it != vars_.end(); ++it)
+          if (it->second.type == real_type)
+            names.push_back(it->first);
+        std::sort(names.begin(), names.end());
+      }
+
+      void names_i(std::vector<std::string>& names) const {
+        names.resize(0);
+        for (vars_map::const_iterator it = vars_.begin();
+             it != vars_.end(); ++it)
+          if (it->second.type == int_type)
+            names.push_back(it->first);
+        std::sort(names.begin(), names.end());
+      }
+
+      /**
+       * Return a pointer to the double values of the variable with the
+       * specified name in the mapped file, or null if there is no such
+       * variable or the host is not little-endian.
+       *
+       * @param name Name of variable.
+       * @param size Set to the number of values.
+       * @return Pointer to the first value or null.
+       */
+      const double* vals_r_ptr(const std::string& name, size_t& size) const {
+        const var* v = find_mapped(name, real_type, sizeof(double));
+        size = v ? v->size : 0;
+        return v ? reinterpret_cast<const double*>(v->values) : 0;
+      }
+
+      /**
+       * Return a pointer to the integer values of the variable with
+       * the specified name in the mapped file, or null if there is no
+       * such variable or the host is not little-endian.
+       *
+       * @param name Name of variable.
+       * @param size Set to the number of values.
+       * @return Pointer to the first value or null.
+       */
+      const int* vals_i_ptr(const std::string& name, size_t& size) const {
+        const var* v = find_mapped(name, int_type, sizeof(boost::int32_t));
+        size = v ? v->size : 0;
+        return v ? reinterpret_cast<const int*>(v->values) : 0;
+      }
+
+      /**
+       * Write the variables of a context in the binary format.  Integer
+       * variables are written as integers and all other variables as
+       * doubles.
+       *
+       * @param context variables to write
+       * @param out stream to write to, opened in binary mode
+       * @throw std::invalid_argument if an integer does not fit in 32
+       * bits
+       */
+      static void write(const var_context& context, std::ostream& out) {
+        std::vector<std::string> names_i;
+        context.names_i(names_i);
+        std::vector<std::string> names_r;
+        context.names_r(names_r);
+        std::set<std::string> ints(names_i.begin(), names_i.end());
+        std::vector<std::string> names;
+        for (size_t n = 0; n < names_r.size(); ++n)
+          if (!ints.count(names_r[n]))
+            names.push_back(names_r[n]);
+        size_t num_real = names.size();
+        names.insert(names.end(), names_i.begin(), names_i.end());
+
+        std::vector<std::vector<size_t> > dims(names.size());
+        boost::uint64_t offset = 16;
+        for (size_t n = 0; n < names.size(); ++n) {
+          dims[n] = n < num_real ? context.dims_r(names[n])
+            : context.dims_i(names[n]);
+          offset += 8 + padded(names[n].size()) + 16 + 8 * dims[n].size()
+            + 8;
+        }
+
+        out.write(magic(), 8);
+        stan_binary::write_size(out, names.size());
+        for (size_t n = 0; n < names.size(); ++n) {
+          stan_binary::write_size(out, names[n].size());
+          write_padded(out, names[n].data(), names[n].size());
+          stan_binary::write_size(out, n < num_real ? real_type : int_type);
+          stan_binary::write_size(out, dims[n].size());
+          size_t size = 1;
+          for (size_t i = 0; i < dims[n].size(); ++i) {
+            stan_binary::write_size(out, dims[n][i]);
+            size *= dims[n][i];
+          }
+          stan_binary::write_size(out, offset);
+          offset += padded(size * (n < num_real ? sizeof(double)
+                                   : sizeof(boost::int32_t)));
+        }
+
+        for (size_t n = 0; n < names.size(); ++n) {
+          if (n < num_real) {
+            std::vector<double> vals = context.vals_r(names[n]);
+            stan_binary::write_doubles(out, vals.data(), vals.size());
+            write_padded(out, 0, vals.size() * sizeof(double));
+          } else {
+            std::vector<int> vals = context.vals_i(names[n]);
+            std::vector<boost::int32_t> vals32(vals.begin(), vals.end());
+            for (size_t i = 0; i < vals.size(); ++i)
+              if (vals32[i] != vals[i])
+                throw std::invalid_argument("integer variable " + names[n]
+                                            + " does not fit in 32 bits");
+            char* bytes = reinterpret_cast<char*>(vals32.data());
+            size_t num_bytes = vals32.size() * sizeof(boost::int32_t);
+            if (!stan_binary::host_is_little_endian())
+              stan_binary::swap_bytes(bytes, vals32.size(),
+                                      sizeof(boost::int32_t));
+            out.write(bytes, num_bytes);
+            write_padded(out, 0, num_bytes);
+          }
+        }
+      }
+
+    private:
+      struct var {
+        var_type type;
+        std::vector<size_t> dims;
+        const char* values;
+        size_t size;
+      };
+
+      typedef std::unordered_map<std::string, var> vars_map;
+
+      static size_t padded(size_t num_bytes) {
+        return (num_bytes + 7) / 8 * 8;
+      }
+
+      /**
+       * Write the given bytes, if any, followed by the zeros needed to
+       * pad them to a multiple of eight bytes.
+       */
+      static void write_padded(std::ostream& out, const char* bytes,
+                               size_t num_bytes) {
+        if (bytes)
+          out.write(bytes, num_bytes);
+        const char zeros[8] = { 0 };
+        out.write(zeros, padded(num_bytes) - num_bytes);
+      }
+
+      /**
+       * Read the size at the given position and move past it.
+       */
+      boost::uint64_t read_size(const char*& p) const {
+        if (end_ - p < 8)
+          throw std::invalid_argument("binary var_context is truncated");
+        char bytes[8];
+        std::memcpy(bytes, p, 8);
+        if (!stan_binary::host_is_little_endian())
+          stan_binary::swap_bytes(bytes, 1, 8);
+        boost::uint64_t x;
+        std::memcpy(&x, bytes, 8);
+        p += 8;
+        return x;
+      }
+
+      void read_index(const char* data, size_t size) {
+        end_ = data + size;
+        if (size < 8 || std::memcmp(data, magic(), 8) != 0)
+          throw std::invalid_argument("not a binary var_context");
+        const char* p = data + 8;
+        boost::uint64_t num_vars = read_size(p);
+        for (boost::uint64_t n = 0; n < num_vars; ++n) {
+          boost::uint64_t name_size = read_size(p);
+          if (name_size > static_cast<boost::uint64_t>(end_ - p)
+              || static_cast<boost::uint64_t>(end_ - p) < padded(name_size))
+            throw std::invalid_argument("binary var_context is truncated");
+          std::string name(p, name_size);
+          p += padded(name_size);
+
+          var v;
+          boost::uint64_t type = read_size(p);
+          if (type != real_type && type != int_type)
+            throw std::invalid_argument("unknown type of variable " + name);
+          v.type = static_cast<var_type>(type);
+          boost::uint64_t num_dims = read_size(p);
+          if (num_dims > static_cast<boost::uint64_t>(end_ - p) / 8)
+            throw std::invalid_argument("binary var_context is truncated");
+          v.dims.resize(num_dims);
+          v.size = 1;
+          for (size_t i = 0; i < v.dims.size(); ++i) {
+            boost::uint64_t dim = read_size(p);
+            if (dim != 0 && v.size > std::numeric_limits<size_t>::max() / dim)
+              throw std::invalid_argument("size of variable " + name
+                                          + " is too large");
+            v.dims[i] = dim;
+            v.size *= dim;
+          }
+          boost::uint64_t offset = read_size(p);
+          size_t value_size = v.type == real_type ? sizeof(double)
+            : sizeof(boost::int32_t);
+          if (offset > size || (size - offset) / value_size < v.size)
+            throw std::invalid_argument("values of variable " + name
+                                        + " are out of range");
+          v.values = data + offset;
+          if (!vars_.insert(std::make_pair(name, v)).second)
+            throw std::invalid_argument("variable " + name
+                                        + " is defined twice");
+        }
+      }
+
+      template <typename T>
+      static void read_values(const var& v, T* x) {
+        std::memcpy(x, v.values, v.size * sizeof(T));
+        if (!stan_binary::host_is_little_endian())
+          stan_binary::swap_bytes(reinterpret_cast<char*>(x), v.size,
+                                  sizeof(T));
+      }
+
+      /**
+       * Return the variable with the given name and type if its values
+       * can be used in place, and null otherwise.
+       */
+      const var* find_mapped(const std::string& name, var_type type,
+                             size_t alignment) const {
+        vars_map::const_iterator it = vars_.find(name);
+        if (it == vars_.end() || it->second.type != type
+            || !stan_binary::host_is_little_endian()
+            || reinterpret_cast<size_t>(it->second.values) % alignment != 0)
+          return 0;
+        return &it->second;
+      }
+
+      boost::interprocess::mapped_region region_;
+      const char* end_;
+      vars_map vars_;
+    };
+
+  }
+}
+#endif
@@ -46,6 +46,28 @@ namespace stan {
         return vc1_.contains_r(name) ? vc1_.dims_i(name) : vc2_.dims_i(name);
       }
 
+      const double* vals_r_ptr(const std::string& name, size_t& size) const {
+        return vc1_.contains_r(name) ? vc1_.vals_r_ptr(name, size)
+          : vc2_.vals_r_ptr(name, size);
+      }
+
+      const int* vals_i_ptr(const std::string& name, size_t& size) const {
+        return vc1_.contains_i(name) ? vc1_.vals_i_ptr(name, size)
+          : vc2_.vals_i_ptr(name, size);
+      }
+
+      bool lookup_r(const std::string& name, std::vector<double>& vals,
+                    std::vector<size_t>& dims) const {
+        return vc1_.lookup_r(name, vals, dims)
+          || vc2_.lookup_r(name, vals, dims);
+      }
+
+      bool lookup_i(const std::string& name, std::vector<int>& vals,
+                    std::vector<size_t>& dims) const {
+        return vc1_.lookup_i(name, vals, dims)
+          || vc2_.lookup_i(name, vals, dims);
+      }
+
       void names_r(std::vector<std::string>& names) const {
         vc1_.names_r(names);
         std::vector<std::string> names2;
@@ -1,24 +1,28 @@
 #ifndef STAN_IO_DUMP_HPP
 #define STAN_IO_DUMP_HPP
 
+#include <stan/io/parse_double.hpp>
 #include <stan/io/validate_zero_buf.hpp>
 #include <stan/io/var_context.hpp>
 #include <stan/math/prim/mat.hpp>
 #include <boost/lexical_cast.hpp>
+#include <boost/math/special_functions/fpclassify.hpp>
 #include <boost/throw_exception.hpp>
 #include <boost/type_traits/is_floating_point.hpp>
 #include <boost/type_traits/is_integral.hpp>
 #include <boost/type_traits/is_arithmetic.hpp>
 #include <boost/utility/enable_if.hpp>
+#include <algorithm>
 #include <iostream>
 #include <limits>
-#include <map>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 #include <cctype>
+#include <cstdio>
 
 namespace stan {
   namespace io {
@@ -141,14 +145,32 @@ namespace stan {
           return false;
       }
 
+      /**
+       * Skip whitespace and return the next character without
+       * consuming it, or <code>EOF</code> at the end of the input,
+       * setting the stream state as <code>operator>></code> would.
+       * Characters are read from the stream buffer directly, which
+       * avoids constructing a stream sentry per character.
+       */
+      int peek_non_space() {
+        if (!in_.good()) {
+          in_.setstate(std::ios::failbit);
+          return EOF;
+        }
+        std::streambuf* buf = in_.rdbuf();
+        int c = buf->sgetc();
+        while (c != EOF && std::isspace(c))
+          c = buf->snextc();
+        if (c == EOF)
+          in_.setstate(std::ios::eofbit | std::ios::failbit);
+        return c;
+      }
+
       bool scan_char(char c_expected) {
-        char c;
-        in_ >> c;
-        if (in_.fail()) return false;
-        if (c != c_expected) {
-          in_.putback(c);
+        int c = peek_non_space();
+        if (c != c_expected)
           return false;
-        }
+        in_.rdbuf()->sbumpc();
         return true;
       }
 
@@ -262,12 +284,17 @@ namespace stan {
         return(get_int());
       }
 
+      // buf_ holds only digits, so only emptiness and range are checked
       int get_int() {
         int n = 0;
-        try {
-          n = boost::lexical_cast<int>(buf_);
-        }
-        catch ( const boost::bad_lexical_cast &exc ) {
+        bool ok = !buf_.empty();
+        for (size_t i = 0; ok && i < buf_.size(); ++i) {
+          int digit = buf_[i] - '0';
+          ok = n <= (std::numeric_limits<int>::max() - digit) / 10;
+          if (ok)
+            n = n * 10 + digit;
+        }
+        if (!ok) {
           std::string msg = "value " + buf_ + " beyond int range";
           BOOST_THROW_EXCEPTION(std::invalid_argument(msg));
         }
@@ -276,52 +303,59 @@ namespace stan {
 
       double scan_double() {
         double x = 0;
-        try {
-          x = boost::lexical_cast<double>(buf_);
-          if (x == 0)
+        bool ok = parse_double(buf_.data(), buf_.data() + buf_.size(), x)
+          && !boost::math::isinf(x);
+        if (ok && x == 0) {
+          try {
             validate_zero_buf(buf_);
+          }
+          catch ( const boost::bad_lexical_cast &exc ) {
+            ok = false;
+          }
         }
-        catch ( const boost::bad_lexical_cast &exc ) {
+        if (!ok) {
           std::string msg = "value " + buf_ + " beyond numeric range";
           BOOST_THROW_EXCEPTION(std::invalid_argument(msg));
         }
         return x;
       }
 
+      static bool is_number_char(int c) {
+        return std::isdigit(c) || c == '.' || c == 'e' || c == 'E'
+          || c == '-' || c == '+';
+      }
+
 
 
       // scan number stores number or throws bad lexical cast exception
       void scan_number(bool negate_val) {
-        // must take longest first!
-        if (scan_chars("Inf")) {
-          scan_chars("inity");  // read past if there
-          stack_r_.push_back(negate_val
-                             ? -std::numeric_limits<double>::infinity()
-                             : std::numeric_limits<double>::infinity());
-          return;
-        }
-        if (scan_chars("NaN", false)) {
-          stack_r_.push_back(std::numeric_limits<double>::quiet_NaN());
-          return;
+        // Inf and NaN cannot start with a number character, so they
+        // are only looked for otherwise; must take longest first!
+        if (!in_.good() || !is_number_char(in_.rdbuf()->sgetc())) {
+          if (scan_chars("Inf")) {
+            scan_chars("inity");  // read past if there
+            stack_r_.push_back(negate_val
+                               ? -std::numeric_limits<double>::infinity()
+                               : std::numeric_limits<double>::infinity());
+            return;
+          }
+          if (scan_chars("NaN", false)) {
+            stack_r_.push_back(std::numeric_limits<double>::quiet_NaN());
+            return;
+          }
         }
 
-        char c;
         bool is_double = false;
         buf_.clear();
-        while (in_.get(c)) {
-          if (std::isdigit(c)) {  // before pre-scan || c == '-' || c == '+') {
-            buf_.push_back(c);
-          } else if (c == '.'
-                     || c == 'e'
-                     || c == 'E'
-                     || c == '-'
-                     || c == '+') {
-            is_double = true;
+        if (in_.good()) {
+          std::streambuf* buf = in_.rdbuf();
+          int c = buf->sgetc();
+          for (; c != EOF && is_number_char(c); c = buf->snextc()) {
+            is_double = is_double || !std::isdigit(c);
             buf_.push_back(c);
-          } else {
-            in_.putback(c);
-            break;
           }
+          if (c == EOF)
+            in_.setstate(std::ios::eofbit | std::ios::failbit);
         }
         if (!is_double && stack_r_.size() == 0) {
           int n = get_int();
@@ -337,12 +371,7 @@ namespace stan {
       }
 
       void scan_number() {
-        char c;
-        while (in_.get(c)) {
-          if (std::isspace(c)) continue;
-          in_.putback(c);
-          break;
-        }
+        peek_non_space();
         bool negate_val = scan_char('-');
         if (!negate_val) scan_char('+');  // flush leading +
         return scan_number(negate_val);
@@ -598,12 +627,12 @@ namespace stan {
      */
     class dump : public stan::io::var_context {
     private:
-      std::map<std::string,
-               std::pair<std::vector<double>,
-                         std::vector<size_t> > > vars_r_;
-      std::map<std::string,
-               std::pair<std::vector<int>,
-                         std::vector<size_t> > > vars_i_;
+      std::unordered_map<std::string,
+                         std::pair<std::vector<double>,
+                                   std::vector<size_t> > > vars_r_;
+      std::unordered_map<std::string,
+                         std::pair<std::vector<int>,
+                                   std::vector<size_t> > > vars_i_;
       std::vector<double> const empty_vec_r_;
       std::vector<int> const empty_vec_i_;
       std::vector<size_t> const empty_vec_ui_;
@@ -735,6 +764,96 @@ namespace stan {
         return empty_vec_ui_;
       }
 
+      /**
+       * Read the double values and dimensions for the variable with
+       * the specified name, converting integer values to doubles.
+       *
+       * @param name Name of variable.
+       * @param vals Set to the values of the variable.
+       * @param dims Set to the dimensions of the variable.
+       * @return <code>true</code> if the variable exists.
+       */
+      bool lookup_r(const std::string& name, std::vector<double>& vals,
+                    std::vector<size_t>& dims) const {
+        if (contains_r_only(name)) {
+          const std::pair<std::vector<double>, std::vector<size_t> >& var
+            = vars_r_.find(name)->second;
+          vals = var.first;
+          dims = var.second;
+          return true;
+        }
+        if (!contains_i(name))
+          return false;
+        const std::pair<std::vector<int>, std::vector<size_t> >& var
+          = vars_i_.find(name)->second;
+        vals.assign(var.first.begin(), var.first.end());
+        dims = var.second;
+        return true;
+      }
+
+      /**
+       * Read the integer values and dimensions for the integer
+       * variable with the specified name.
+       *
+       * @param name Name of variable.
+       * @param vals Set to the values of the variable.
+       * @param dims Set to the dimensions of the variable.
+       * @return <code>true</code> if the integer variable exists.
+       */
+      bool lookup_i(const std::string& name, std::vector<int>& vals,
+                    std::vector<size_t>& dims) const {
+        if (!contains_i(name))
+          return false;
+        const std::pair<std::vector<int>, std::vector<size_t> >& var
+          = vars_i_.find(name)->second;
+        vals = var.first;
+        dims = var.second;
+        return true;
+      }
+
+      /**
+       * Return a pointer to the stored double values for the variable
+       * with the specified name, or null if there is no variable of
+       * that name with double values.  Integer valued variables must
+       * be read with <code>vals_r</code>, which converts them.
+       *
+       * @param name Name of variable.
+       * @param size Set to the number of values.
+       * @return Pointer to the first value, non-null if the variable
+       * has no values, or null.
+       */
+      const double* vals_r_ptr(const std::string& name, size_t& size) const {
+        if (!contains_r_only(name)) {
+          size = 0;
+          return 0;
+        }
+        const std::vector<double>& vals = vars_r_.find(name)->second.first;
+        static const double no_values = 0;
+        size = vals.size();
+        return vals.empty() ? &no_values : vals.data();
+      }
+
+      /**
+       * Return a pointer to the stored integer values for the variable
+       * with the specified name, or null if there is no integer
+       * variable of that name.
+       *
+       * @param name Name of variable.
+       * @param size Set to the number of values.
+       * @return Pointer to the first value, non-null if the variable
+       * has no values, or null.
+       */
+      const int* vals_i_ptr(const std::string& name, size_t& size) const {
+        if (!contains_i(name)) {
+          size = 0;
+          return 0;
+        }
+        const std::vector<int>& vals = vars_i_.find(name)->second.first;
+        static const int no_values = 0;
+        size = vals.size();
+        return vals.empty() ? &no_values : vals.data();
+      }
+
       /**
        * Return a list of the names of the floating point variables in
        * the dump.
@@ -743,12 +862,13 @@ namespace stan {
        */
       virtual void names_r(std::vector<std::string>& names) const {
         names.resize(0);
-        for (std::map<std::string,
-                      std::pair<std::vector<double>,
-                                std::vector<size_t> > >
+        for (std::unordered_map<std::string,
+                                std::pair<std::vector<double>,
+                                          std::vector<size_t> > >
                  ::const_iterator it = vars_r_.begin();
              it != vars_r_.end(); ++it)
           names.push_back((*it).first);
+        std::sort(names.begin(), names.end());
       }
 
       /**
@@ -759,12 +879,13 @@ namespace stan {
        */
       virtual void names_i(std::vector<std::string>& names) const {
         names.resize(0);
-        for (std::map<std::string,
-                      std::pair<std::vector<int>,
-                                std::vector<size_t> > >
+        for (std::unordered_map<std::string,
+                                std::pair<std::vector<int>,
+                                          std::vector<size_t> > >
                  ::const_iterator it = vars_i_.begin();
              it != vars_i_.end(); ++it)
           names.push_back((*it).first);
+        std::sort(names.begin(), names.end());
       }
 
       /**
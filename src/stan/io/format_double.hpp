@@ -0,0 +1,495 @@
+#ifndef STAN_IO_FORMAT_DOUBLE_HPP
+#define STAN_IO_FORMAT_DOUBLE_HPP
+
+#include <boost/cstdint.hpp>
+#include <clocale>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace stan {
+  namespace io {
+
+    /**
+     * Shortest round-trip formatting of doubles with the Grisu2
+     * algorithm of Loitsch, "Printing Floating-Point Numbers Quickly
+     * and Accurately with Integers" (PLDI 2010).  The digits produced
+     * always read back to the same double and are the shortest such
+     * digits for all but a small fraction of values.
+     */
+    namespace grisu {
+
+      typedef boost::uint64_t uint64;
+
+      /**
+       * Floating point number with a 64 bit significand and a binary
+       * exponent, <code>f * 2^e</code>.
+       */
+      struct diy_fp {
+        diy_fp() : f(0), e(0) {}
+        diy_fp(uint64 f_, int e_) : f(f_), e(e_) {}
+
+        explicit diy_fp(double d) {
+          uint64 u;
+          std::memcpy(&u, &d, sizeof(u));
+          int biased_e = static_cast<int>((u & exponent_mask()) >> 52);
+          uint64 significand = u & significand_mask();
+          if (biased_e != 0) {
+            f = significand + hidden_bit();
+            e = biased_e - exponent_bias();
+          } else {
+            f = significand;
+            e = 1 - exponent_bias();
+          }
+        }
+
+        static uint64 exponent_mask() { return 0x7FF0000000000000ULL; }
+        static uint64 significand_mask() { return 0x000FFFFFFFFFFFFFULL; }
+        static uint64 hidden_bit() { return 0x0010000000000000ULL; }
+        static int exponent_bias() { return 0x3FF + 52; }
+
+        diy_fp operator-(const diy_fp& rhs) const {
+          return diy_fp(f - rhs.f, e);
+        }
+
+        /**
+         * Product rounded to the upper 64 bits.
+         */
+        diy_fp operator*(const diy_fp& rhs) const {
+          const uint64 m32 = 0xFFFFFFFFULL;
+          uint64 a = f >> 32, b = f & m32, c = rhs.f >> 32, d = rhs.f & m32;
+          uint64 ac = a * c, bc = b * c, ad = a * d, bd = b * d;
+          uint64 tmp = (bd >> 32) + (ad & m32) + (bc & m32);
+          tmp += 1ULL << 31;
+          return diy_fp(ac + (ad >> 32) + (bc >> 32) + (tmp >> 32),
+                        e + rhs.e + 64);
+        }
+
+        diy_fp normalize() const {
+          diy_fp res = *this;
+          while (!(res.f & (1ULL << 63))) {
+            res.f <<= 1;
+            --res.e;
+          }
+          return res;
+        }
+
+        /**
+         * Return the boundaries of the interval of reals that round to
+         * this double, normalized to a common exponent.
+         */
+        void normalized_boundaries(diy_fp& minus, diy_fp& plus) const {
+          plus = diy_fp((f << 1) + 1, e - 1).normalize();
+          minus = (f == hidden_bit()) ? diy_fp((f << 2) - 1, e - 2)
+                                      : diy_fp((f << 1) - 1, e - 1);
+          minus.f <<= minus.e - plus.e;
+          minus.e = plus.e;
+        }
+
+        uint64 f;
+        int e;
+      };
+
+      /**
+       * Minimal arbitrary precision unsigned integer used to compute
+       * the table of cached powers of ten exactly.
+       */
+      class big_uint {
+      public:
+        explicit big_uint(boost::uint32_t x) : words_(1, x) {}
+
+        void multiply(boost::uint32_t m) {
+          uint64 carry = 0;
+          for (size_t i = 0; i < words_.size(); ++i) {
+            uint64 p = static_cast<uint64>(words_[i]) * m + carry;
+            words_[i] = static_cast<boost::uint32_t>(p);
+            carry = p >> 32;
+          }
+          if (carry)
+            words_.push_back(static_cast<boost::uint32_t>(carry));
+        }
+
+        void shift_left() {
+          boost::uint32_t carry = 0;
+          for (size_t i = 0; i < words_.size(); ++i) {
+            boost::uint32_t next = words_[i] >> 31;
+            words_[i] = (words_[i] << 1) | carry;
+            carry = next;
+          }
+          if (carry)
+            words_.push_back(carry);
+        }
+
+        void subtract(const big_uint& x) {
+          boost::int64_t borrow = 0;
+          for (size_t i = 0; i < words_.size(); ++i) {
+            boost::int64_t d = static_cast<boost::int64_t>(words_[i]) - borrow
+                               - (i < x.words_.size() ? x.words_[i] : 0);
+            borrow = d < 0;
+            words_[i] = static_cast<boost::uint32_t>(d + (borrow << 32));
+          }
+          trim();
+        }
+
+        bool operator>=(const big_uint& x) const {
+          if (words_.size() != x.words_.size())
+            return words_.size() > x.words_.size();
+          for (size_t i = words_.size(); i-- > 0; )
+            if (words_[i] != x.words_[i])
+              return words_[i] > x.words_[i];
+          return true;
+        }
+
+        int bit_length() const {
+          int n = 32 * static_cast<int>(words_.size() - 1);
+          for (boost::uint32_t top = words_.back(); top; top >>= 1)
+            ++n;
+          return n;
+        }
+
+        bool bit(int i) const {
+          if (i < 0 || i >= 32 * static_cast<int>(words_.size()))
+            return false;
+          return (words_[i / 32] >> (i % 32)) & 1;
+        }
+
+        static big_uint power_of_two(int n) {
+          big_uint x(0);
+          x.words_.assign(n / 32 + 1, 0);
+          x.words_.back() = 1U << (n % 32);
+          return x;
+        }
+
+      private:
+        void trim() {
+          while (words_.size() > 1 && words_.back() == 0)
+            words_.pop_back();
+        }
+
+        std::vector<boost::uint32_t> words_;
+      };
+
+      /**
+       * Return <code>10^k</code> correctly rounded to a normalized
+       * 64 bit significand.
+       */
+      inline diy_fp compute_power_of_ten(int k) {
+        big_uint d(1);
+        for (int i = 0; i < (k < 0 ? -k : k); ++i)
+          d.multiply(10);
+        int n = d.bit_length();
+
+        uint64 f = 0;
+        int e;
+        bool round_up;
+        if (k >= 0) {
+          for (int i = 0; i < 64; ++i)
+            f = (f << 1) | d.bit(n - 1 - i);
+          e = n - 64;
+          round_up = d.bit(n - 65);
+        } else {
+          // Long division of 2^(n + 63) by 10^-k one bit at a time
+          big_uint r = big_uint::power_of_two(n);
+          r.subtract(d);
+          f = 1;
+          for (int i = 0; i < 63; ++i) {
+            r.shift_left();
+            f <<= 1;
+            if (r >= d) {
+              r.subtract(d);
+              f |= 1;
+            }
+          }
+          r.shift_left();
+          round_up = r >= d;
+          e = -(n + 63);
+        }
+        if (round_up && ++f == 0) {
+          f = 1ULL << 63;
+          ++e;
+        }
+        return diy_fp(f, e);
+      }
+
+      /**
+       * Return the table of the powers of ten
+       * <code>10^-348, 10^-340, ..., 10^340</code>.
+       */
+      inline const std::vector<diy_fp>& cached_powers() {
+        struct table {
+          table() {
+            for (int k = -348; k <= 340; k += 8)
+              powers.push_back(compute_power_of_ten(k));
+          }
+          std::vector<diy_fp> powers;
+        };
+        static const table powers;
+        return powers.powers;
+      }
+
+      /**
+       * Return a cached power of ten <code>10^-k</code> which scales a
+       * number with binary exponent <code>e</code> to have a binary
+       * exponent between -60 and -32.
+       */
+      inline diy_fp get_cached_power(int e, int& k) {
+        double dk = (-61 - e) * 0.30102999566398114 + 347;
+        int ik = static_cast<int>(dk);
+        if (dk - ik > 0.0)
+          ++ik;
+        unsigned index = static_cast<unsigned>((ik >> 3) + 1);
+        k = -(-348 + static_cast<int>(index << 3));
+        return cached_powers()[index];
+      }
+
+      inline uint64 pow10(int n) {
+        static const uint64 powers[] = {
+          1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL,
+          10000000ULL, 100000000ULL, 1000000000ULL, 10000000000ULL,
+          100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+          100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL,
+          100000000000000000ULL, 1000000000000000000ULL,
+          10000000000000000000ULL
+        };
+        return powers[n];
+      }
+
+      inline int count_decimal_digits(boost::uint32_t n) {
+        if (n < 10) return 1;
+        if (n < 100) return 2;
+        if (n < 1000) return 3;
+        if (n < 10000) return 4;
+        if (n < 100000) return 5;
+        if (n < 1000000) return 6;
+        if (n < 10000000) return 7;
+        if (n < 100000000) return 8;
+        if (n < 1000000000) return 9;
+        return 10;
+      }
+
+      /**
+       * Return the leading digit of the given number of digits of
+       * <code>n</code> and remove it.  Dividing by constants lets the
+       * compiler avoid integer division.
+       */
+      inline boost::uint32_t pop_digit(boost::uint32_t& n, int digits) {
+        boost::uint32_t d;
+        switch (digits) {
+        case 10: d = n / 1000000000; n %= 1000000000; break;
+        case 9: d = n / 100000000; n %= 100000000; break;
+        case 8: d = n / 10000000; n %= 10000000; break;
+        case 7: d = n / 1000000; n %= 1000000; break;
+        case 6: d = n / 100000; n %= 100000; break;
+        case 5: d = n / 10000; n %= 10000; break;
+        case 4: d = n / 1000; n %= 1000; break;
+        case 3: d = n / 100; n %= 100; break;
+        case 2: d = n / 10; n %= 10; break;
+        case 1: d = n; n = 0; break;
+        default: d = 0;
+        }
+        return d;
+      }
+
+      /**
+       * Move the last digit down while the result stays in the
+       * rounding interval and gets closer to the exact value.
+       */
+      inline void round_weed(char* buffer, int length, uint64 delta,
+                             uint64 rest, uint64 ten_kappa, uint64 wp_w) {
+        while (rest < wp_w && delta - rest >= ten_kappa
+               && (rest + ten_kappa < wp_w
+                   || wp_w - rest > rest + ten_kappa - wp_w)) {
+          --buffer[length - 1];
+          rest += ten_kappa;
+        }
+      }
+
+      inline void generate_digits(const diy_fp& w, const diy_fp& mp,
+                                  uint64 delta, char* buffer, int& length,
+                                  int& k) {
+        const diy_fp one(1ULL << -mp.e, mp.e);
+        const diy_fp wp_w = mp - w;
+        boost::uint32_t p1 = static_cast<boost::uint32_t>(mp.f >> -one.e);
+        uint64 p2 = mp.f & (one.f - 1);
+        int kappa = count_decimal_digits(p1);
+        length = 0;
+
+        while (kappa > 0) {
+          boost::uint32_t d = pop_digit(p1, kappa);
+          if (d || length)
+            buffer[length++] = static_cast<char>('0' + d);
+          --kappa;
+          uint64 rest = (static_cast<uint64>(p1) << -one.e) + p2;
+          if (rest <= delta) {
+            k += kappa;
+            round_weed(buffer, length, delta, rest,
+                       pow10(kappa) << -one.e, wp_w.f);
+            return;
+          }
+        }
+
+        while (true) {
+          p2 *= 10;
+          delta *= 10;
+          char d = static_cast<char>(p2 >> -one.e);
+          if (d || length)
+            buffer[length++] = static_cast<char>('0' + d);
+          p2 &= one.f - 1;
+          --kappa;
+          if (p2 < delta) {
+            k += kappa;
+            round_weed(buffer, length, delta, p2, one.f,
+                       -kappa < 20 ? wp_w.f * pow10(-kappa) : 0);
+            return;
+          }
+        }
+      }
+
+      /**
+       * Write the shortest digits of a positive finite double to the
+       * buffer, such that the double is <code>digits * 10^k</code>.
+       *
+       * @param[in] x positive finite value
+       * @param[out] buffer at least 18 characters for the digits
+       * @param[out] length number of digits
+       * @param[out] k decimal exponent of the last digit
+       */
+      inline void grisu2(double x, char* buffer, int& length, int& k) {
+        const diy_fp v(x);
+        diy_fp w_m, w_p;
+        v.normalized_boundaries(w_m, w_p);
+
+        const diy_fp c_mk = get_cached_power(w_p.e, k);
+        const diy_fp w = v.normalize() * c_mk;
+        diy_fp wp = w_p * c_mk;
+        diy_fp wm = w_m * c_mk;
+        ++wm.f;
+        --wp.f;
+        generate_digits(w, wp, wp.f - wm.f, buffer, length, k);
+      }
+
+      inline char* write_exponent(int exponent, char* out) {
+        *out++ = 'e';
+        if (exponent < 0) {
+          *out++ = '-';
+          exponent = -exponent;
+        } else {
+          *out++ = '+';
+        }
+        if (exponent >= 100) {
+          *out++ = static_cast<char>('0' + exponent / 100);
+          exponent %= 100;
+        }
+        *out++ = static_cast<char>('0' + exponent / 10);
+        *out++ = static_cast<char>('0' + exponent % 10);
+        return out;
+      }
+
+    }
+
+    /**
+     * Size of a buffer large enough for any formatted double.
+     */
+    const int format_double_buffer_size = 32;
+
+    /**
+     * Write the shortest decimal representation of a double which reads
+     * back as the same double, independently of the locale.  Numbers
+     * with decimal exponents from -5 to 16 are written in fixed
+     * notation and others in scientific notation, as with
+     * <code>%g</code>; infinities and NaN are written as
+     * <code>inf</code>, <code>-inf</code> and <code>nan</code>.
+     *
+     * @param[in] x value to format
+     * @param[out] buffer at least <code>format_double_buffer_size</code>
+     *   characters
+     * @return number of characters written, not null terminated
+     */
+    inline int format_double(double x, char* buffer) {
+      char* out = buffer;
+      if (std::isnan(x)) {
+        std::memcpy(out, "nan", 3);
+        return 3;
+      }
+      if (std::signbit(x)) {
+        *out++ = '-';
+        x = -x;
+      }
+      if (std::isinf(x)) {
+        std::memcpy(out, "inf", 3);
+        return static_cast<int>(out - buffer) + 3;
+      }
+      if (x == 0) {
+        *out++ = '0';
+        return static_cast<int>(out - buffer);
+      }
+
+      char digits[20];
+      int length;
+      int k;
+      grisu::grisu2(x, digits, length, k);
+
+      // x is 0.d_1 d_2 ... d_length * 10^point
+      int point = length + k;
+      int exponent = point - 1;
+      if (exponent < -5 || exponent >= 17) {
+        *out++ = digits[0];
+        if (length > 1) {
+          *out++ = '.';
+          std::memcpy(out, digits + 1, length - 1);
+          out += length - 1;
+        }
+        out = grisu::write_exponent(exponent, out);
+      } else if (point >= length) {
+        std::memcpy(out, digits, length);
+        out += length;
+        for (int i = length; i < point; ++i)
+          *out++ = '0';
+      } else if (point > 0) {
+        std::memcpy(out, digits, point);
+        out += point;
+        *out++ = '.';
+        std::memcpy(out, digits + point, length - point);
+        out += length - point;
+      } else {
+        *out++ = '0';
+        *out++ = '.';
+        for (int i = point; i < 0; ++i)
+          *out++ = '0';
+        std::memcpy(out, digits, length);
+        out += length;
+      }
+      return static_cast<int>(out - buffer);
+    }
+
+    /**
+     * Write a double with the given number of significant digits as
+     * <code>%g</code> would, with a <code>.</code> as the decimal point
+     * whatever the locale.
+     *
+     * @param[in] x value to format
+     * @param[in] precision number of significant digits, from 1 to 17
+     * @param[out] buffer at least <code>format_double_buffer_size</code>
+     *   characters
+     * @return number of characters written, not null terminated
+     */
+    inline int format_double(double x, int precision, char* buffer) {
+      if (precision < 1)
+        precision = 1;
+      else if (precision > 17)
+        precision = 17;
+      int length = std::snprintf(buffer, format_double_buffer_size, "%.*g",
+                                 precision, x);
+      const char decimal_point = *std::localeconv()->decimal_point;
+      if (decimal_point != '.') {
+        for (int i = 0; i < length; ++i)
+          if (buffer[i] == decimal_point)
+            buffer[i] = '.';
+      }
+      return length;
+    }
+
+  }
+}
+#endif
@@ -7,10 +7,10 @@
 #include <stan/io/json/json_error.hpp>
 #include <stan/io/json/json_parser.hpp>
 #include <stan/io/json/json_data_handler.hpp>
+#include <algorithm>
 #include <cctype>
 #include <iostream>
 #include <limits>
-#include <map>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -109,16 +109,13 @@ namespace stan {
        * @return Values of variable.
        */
       std::vector<double> vals_r(const std::string& name) const {
-        if (contains_r_only(name)) {
-          return (vars_r_.find(name)->second).first;
-        } else if (contains_i(name)) {
-          std::vector<int> vec_int = (vars_i_.find(name)->second).first;
-          std::vector<double> vec_r(vec_int.size());
-          for (size_t ii = 0; ii < vec_int.size(); ii++) {
-            vec_r[ii] = vec_int[ii];
-          }
-          return vec_r;
-        }
+        vars_map_r::const_iterator it_r = vars_r_.find(name);
+        if (it_r != vars_r_.end())
+          return it_r->second.first;
+        vars_map_i::const_iterator it_i = vars_i_.find(name);
+        if (it_i != vars_i_.end())
+          return std::vector<double>(it_i->second.first.begin(),
+                                     it_i->second.first.end());
         return empty_vec_r_;
       }
 
@@ -130,11 +127,12 @@ namespace stan {
        * @return Dimensions of variable.
        */
       std::vector<size_t> dims_r(const std::string& name) const {
-        if (contains_r_only(name)) {
-          return (vars_r_.find(name)->second).second;
-        } else if (contains_i(name)) {
-          return (vars_i_.find(name)->second).second;
-        }
+        vars_map_r::const_iterator it_r = vars_r_.find(name);
+        if (it_r != vars_r_.end())
+          return it_r->second.second;
+        vars_map_i::const_iterator it_i = vars_i_.find(name);
+        if (it_i != vars_i_.end())
+          return it_i->second.second;
         return empty_vec_ui_;
       }
 
@@ -146,10 +144,8 @@ namespace stan {
        * @return Values.
        */
       std::vector<int> vals_i(const std::string& name) const {
-        if (contains_i(name)) {
-          return (vars_i_.find(name)->second).first;
-        }
-        return empty_vec_i_;
+        vars_map_i::const_iterator it = vars_i_.find(name);
+        return it == vars_i_.end() ? empty_vec_i_ : it->second.first;
       }
 
       /**
@@ -160,10 +156,95 @@ namespace stan {
        * @return Dimensions of variable.
        */
       std::vector<size_t> dims_i(const std::string& name) const {
-        if (contains_i(name)) {
-          return (vars_i_.find(name)->second).second;
+        vars_map_i::const_iterator it = vars_i_.find(name);
+        return it == vars_i_.end() ? empty_vec_ui_ : it->second.second;
+      }
+
+      /**
+       * Read the double values and dimensions for the variable with
+       * the specified name, converting integer values to doubles.
+       *
+       * @param name Name of variable.
+       * @param vals Set to the values of the variable.
+       * @param dims Set to the dimensions of the variable.
+       * @return <code>true</code> if the variable exists.
+       */
+      bool lookup_r(const std::string& name, std::vector<double>& vals,
+                    std::vector<size_t>& dims) const {
+        vars_map_r::const_iterator it_r = vars_r_.find(name);
+        if (it_r != vars_r_.end()) {
+          vals = it_r->second.first;
+          dims = it_r->second.second;
+          return true;
         }
-        return empty_vec_ui_;
+        vars_map_i::const_iterator it_i = vars_i_.find(name);
+        if (it_i == vars_i_.end())
+          return false;
+        vals.assign(it_i->second.first.begin(), it_i->second.first.end());
+        dims = it_i->second.second;
+        return true;
+      }
+
+      /**
+       * Read the integer values and dimensions for the integer
+       * variable with the specified name.
+       *
+       * @param name Name of variable.
+       * @param vals Set to the values of the variable.
+       * @param dims Set to the dimensions of the variable.
+       * @return <code>true</code> if the integer variable exists.
+       */
+      bool lookup_i(const std::string& name, std::vector<int>& vals,
+                    std::vector<size_t>& dims) const {
+        vars_map_i::const_iterator it = vars_i_.find(name);
+        if (it == vars_i_.end())
+          return false;
+        vals = it->second.first;
+        dims = it->second.second;
+        return true;
+      }
+
+      /**
+       * Return a pointer to the stored double values for the variable
+       * with the specified name, or null if there is no variable of
+       * that name with double values.  Integer valued variables must
+       * be read with <code>vals_r</code>, which converts them.
+       *
+       * @param name Name of variable.
+       * @param size Set to the number of values.
+       * @return Pointer to the first value, non-null if the variable
+       * has no values, or null.
+       */
+      const double* vals_r_ptr(const std::string& name, size_t& size) const {
+        vars_map_r::const_iterator it = vars_r_.find(name);
+        if (it == vars_r_.end()) {
+          size = 0;
+          return 0;
+        }
+        static const double no_values = 0;
+        size = it->second.first.size();
+        return size == 0 ? &no_values : it->second.first.data();
+      }
+
+      /**
+       * Return a pointer to the stored integer values for the variable
+       * with the specified name, or null if there is no integer
+       * variable of that name.
+       *
+       * @param name Name of variable.
+       * @param size Set to the number of values.
+       * @return Pointer to the first value, non-null if the variable
+       * has no values, or null.
+       */
+      const int* vals_i_ptr(const std::string& name, size_t& size) const {
+        vars_map_i::const_iterator it = vars_i_.find(name);
+        if (it == vars_i_.end()) {
+          size = 0;
+          return 0;
+        }
+        static const int no_values = 0;
+        size = it->second.first.size();
+        return size == 0 ? &no_values : it->second.first.data();
       }
 
       /**
@@ -177,6 +258,7 @@ namespace stan {
         for (vars_map_r::const_iterator it = vars_r_.begin();
              it != vars_r_.end(); ++it)
           names.push_back((*it).first);
+        std::sort(names.begin(), names.end());
       }
 
       /**
@@ -190,6 +272,7 @@ namespace stan {
         for (vars_map_i::const_iterator it = vars_i_.begin();
              it != vars_i_.end(); ++it)
           names.push_back((*it).first);
+        std::sort(names.begin(), names.end());
       }
 
       /**
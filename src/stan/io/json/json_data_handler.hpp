@@ -10,9 +10,9 @@
 #include <cctype>
 #include <iostream>
 #include <limits>
-#include <map>
 #include <sstream>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <utility>
 
@@ -21,15 +21,15 @@ namespace stan {
   namespace json {
 
     typedef
-    std::map<std::string,
-             std::pair<std::vector<double>,
-                       std::vector<size_t> > >
+    std::unordered_map<std::string,
+                       std::pair<std::vector<double>,
+                                 std::vector<size_t> > >
     vars_map_r;
 
     typedef
-    std::map<std::string,
-             std::pair<std::vector<int>,
-                       std::vector<size_t> > >
+    std::unordered_map<std::string,
+                       std::pair<std::vector<int>,
+                                 std::vector<size_t> > >
     vars_map_i;
 
     /**
@@ -193,12 +193,8 @@ namespace stan {
                    << ", error: string values not allowed";
           throw json_error(errorMsg.str());
         }
-        if (is_int_) {
-          for (std::vector<int>::iterator it = values_i_.begin();
-               it != values_i_.end(); ++it)
-            values_r_.push_back(*it);
-        }
-        is_int_ = false;
+        if (is_int_)
+          promote_to_double();
         values_r_.push_back(tmp);
         incr_dim_size();
       }
@@ -211,12 +207,8 @@ namespace stan {
 
       void number_double(double x) {
         set_last_dim();
-        if (is_int_) {
-          for (std::vector<int>::iterator it = values_i_.begin();
-               it != values_i_.end(); ++it)
-            values_r_.push_back(*it);
-        }
-        is_int_ = false;
+        if (is_int_)
+          promote_to_double();
         values_r_.push_back(x);
         incr_dim_size();
       }
@@ -254,33 +246,35 @@ namespace stan {
             throw json_error(errorMsg.str());
         }
 
-        // transpose order of array values to column-major
+        // transpose order of array values to column-major in place and
+        // move them into the map, so no copy of the values is made
         if (is_int_) {
-          std::pair<std::vector<int>,
-                    std::vector<size_t> > pair;
-          if (dims_.size() > 1) {
-            std::vector<int> cm_values_i(values_i_.size());
-            to_column_major(cm_values_i, values_i_, dims_);
-            pair = make_pair(cm_values_i, dims_);
-
-          } else {
-            pair = make_pair(values_i_, dims_);
-          }
-          vars_i_[key_] = pair;
+          if (dims_.size() > 1)
+            to_column_major(values_i_, dims_);
+          std::pair<std::vector<int>, std::vector<size_t> >& var
+            = vars_i_[key_];
+          var.first.swap(values_i_);
+          var.second = dims_;
         } else {
-          std::pair<std::vector<double>,
-                    std::vector<size_t> > pair;
-          if (dims_.size() > 1) {
-            std::vector<double> cm_values_r(values_r_.size());
-            to_column_major(cm_values_r, values_r_, dims_);
-            pair = make_pair(cm_values_r, dims_);
-          } else {
-            pair = make_pair(values_r_, dims_);
-          }
-          vars_r_[key_] = pair;
+          if (dims_.size() > 1)
+            to_column_major(values_r_, dims_);
+          std::pair<std::vector<double>, std::vector<size_t> >& var
+            = vars_r_[key_];
+          var.first.swap(values_r_);
+          var.second = dims_;
         }
       }
 
+      /**
+       * Convert the integer values read so far to double values and
+       * release the memory of the integer values.
+       */
+      void promote_to_double() {
+        values_r_.assign(values_i_.begin(), values_i_.end());
+        std::vector<int>().swap(values_i_);
+        is_int_ = false;
+      }
+
       void incr_dim_size() {
         if (dim_idx_ > 0) {
           if (dims_unknown_[dim_idx_-1])
@@ -290,13 +284,29 @@ namespace stan {
         }
       }
 
+      /**
+       * Permute values in row-major order into column-major order in
+       * place by following the cycles of the permutation, using one
+       * bit of extra memory per value.
+       *
+       * @tparam T type of values
+       * @param[in,out] vals values
+       * @param[in] dims dimensions of the array
+       */
       template <typename T>
-      void to_column_major(std::vector<T>& cm_vals,
-                           const std::vector<T>& rm_vals,
+      void to_column_major(std::vector<T>& vals,
                            const std::vector<size_t>& dims) {
-        for (size_t i = 0; i< rm_vals.size(); i++) {
-          size_t idx = convert_offset_rtl_2_ltr(i, dims);
-          cm_vals[idx] = rm_vals[i];
+        std::vector<bool> placed(vals.size(), false);
+        for (size_t start = 0; start < vals.size(); ++start) {
+          if (placed[start])
+            continue;
+          T x = vals[start];
+          size_t i = start;
+          do {
+            i = convert_offset_rtl_2_ltr(i, dims);
+            std::swap(x, vals[i]);
+            placed[i] = true;
+          } while (i != start);
         }
       }
 
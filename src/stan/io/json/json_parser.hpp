@@ -2,13 +2,16 @@
 #define STAN_IO_JSON_JSON_PARSER_HPP
 
 #include <boost/lexical_cast.hpp>
+#include <boost/math/special_functions/fpclassify.hpp>
 
+#include <stan/io/parse_double.hpp>
 #include <stan/io/validate_zero_buf.hpp>
 #include <stan/io/json/json_error.hpp>
 
 #include <stdexcept>
 #include <iostream>
 #include <istream>
+#include <limits>
 #include <sstream>
 #include <string>
 
@@ -122,12 +125,12 @@ namespace stan {
       void parse_number() {
         bool is_positive = true;
 
-        std::stringstream ss;
+        number_.clear();
         char c = get_non_ws_char();
         // minus
         if (c == '-') {
           is_positive = false;
-          ss << c;
+          number_ += c;
           c = get_char();
         }
 
@@ -135,7 +138,7 @@ namespace stan {
         //   zero / digit1-9
         if (c < '0' || c > '9')
           throw json_exception("expecting int part of number");
-        ss << c;
+        number_ += c;
 
         //   *DIGIT
         bool leading_zero = (c == '0');
@@ -143,7 +146,7 @@ namespace stan {
         if (leading_zero && (c == '0'))
           throw json_exception("zero padded numbers not allowed");
         while (c >= '0' && c <= '9') {
-          ss << c;
+          number_ += c;
           c = get_char();
         }
 
@@ -151,14 +154,14 @@ namespace stan {
         bool is_integer = true;
         if (c == '.') {
           is_integer = false;
-          ss << '.';
+          number_ += '.';
           c = get_char();
           if (c < '0' || c > '9')
             throw json_exception("expected digit after decimal");
-          ss << c;
+          number_ += c;
           c = get_char();
           while (c >= '0' && c <= '9') {
-            ss << c;
+            number_ += c;
             c = get_char();
           }
         }
@@ -166,56 +169,55 @@ namespace stan {
         // exp
         if (c == 'e' || c == 'E') {
           is_integer = false;
-          ss << c;
+          number_ += c;
           c = get_char();
           // minus / plus
           if (c == '+' || c == '-') {
-            ss << c;
+            number_ += c;
             c = get_char();
           }
           // 1*DIGIT
           if (c < '0' || c > '9')
             throw json_exception("expected digit after e/E");
           while (c >= '0' && c <= '9') {
-            ss << c;
+            number_ += c;
             c = get_char();
           }
         }
         unget_char();
 
         if (is_integer) {
-          if (is_positive) {
-            unsigned long n;  // NOLINT(runtime/int)
-            try {
-              // NOLINTNEXTLINE(runtime/int)
-              n = boost::lexical_cast<unsigned long>(ss.str());
-            } catch (const boost::bad_lexical_cast & ) {
+          // digits are validated above, so only the range is checked
+          // NOLINTNEXTLINE(runtime/int)
+          unsigned long max = std::numeric_limits<unsigned long>::max();
+          if (!is_positive)
+            max = std::numeric_limits<long>::max() + 1UL;  // NOLINT
+          unsigned long n = 0;  // NOLINT(runtime/int)
+          for (size_t i = is_positive ? 0 : 1; i < number_.size(); ++i) {
+            unsigned int digit = number_[i] - '0';
+            if (n > (max - digit) / 10)
               throw json_exception("number exceeds integer range");
-            }
-            ss >> n;
-            h_.number_unsigned_long(n);
-          } else {
-            long n;  // NOLINT(runtime/int)
-            try {
-              // NOLINTNEXTLINE(runtime/int)
-              n = boost::lexical_cast<unsigned long>(ss.str());
-            } catch (const boost::bad_lexical_cast & ) {
-              throw json_exception("number exceeds integer range");
-            }
-            ss >> n;
-            h_.number_long(n);
+            n = n * 10 + digit;
           }
+          if (is_positive)
+            h_.number_unsigned_long(n);
+          else if (n == 0)
+            h_.number_long(0);
+          else
+            h_.number_long(-static_cast<long>(n - 1) - 1);  // NOLINT
         } else {
           double x;
-          try {
-            std::string ss_str = ss.str();
-            x = boost::lexical_cast<double>(ss_str);
-            if (x == 0)
-              io::validate_zero_buf(ss_str);
-          } catch (const boost::bad_lexical_cast & ) {
+          if (!io::parse_double(number_.data(),
+                                number_.data() + number_.size(), x)
+              || boost::math::isinf(x))
             throw json_exception("number exceeds double range");
+          if (x == 0) {
+            try {
+              io::validate_zero_buf(number_);
+            } catch (const boost::bad_lexical_cast & ) {
+              throw json_exception("number exceeds double range");
+            }
           }
-          ss >> x;
           h_.number_double(x);
         }
       }
@@ -413,6 +415,7 @@ namespace stan {
       char next_char_;
       size_t line_;
       size_t column_;
+      std::string number_;
     };
 
 
@@ -0,0 +1,291 @@
+#ifndef STAN_IO_MAPPED_STAN_CSV_READER_HPP
+#define STAN_IO_MAPPED_STAN_CSV_READER_HPP
+
+#include <stan/io/parse_double.hpp>
+#include <stan/io/stan_csv_reader.hpp>
+#include <boost/algorithm/string.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <Eigen/Dense>
+#include <cstring>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace stan {
+  namespace io {
+
+    /**
+     * Reads a Stan output csv file mapped into memory.
+     *
+     * The metadata, header and adaptation are parsed on construction.
+     * Draws are parsed on request, for a chosen subset of the columns,
+     * and can be passed to a callback one row at a time so that the
+     * draws never need to be held in memory together.  Numbers are
+     * parsed without iostreams.
+     */
+    class mapped_stan_csv_reader {
+    public:
+      /**
+       * Map the given file and parse everything but the draws.
+       *
+       * @param[in] file_name name of the csv file
+       * @param[out] out output stream to send messages
+       * @throw std::invalid_argument if the file cannot be mapped or
+       *   has no header
+       */
+      explicit mapped_stan_csv_reader(const std::string& file_name,
+                                      std::ostream* out = 0) {
+        try {
+          boost::interprocess::file_mapping
+            file(file_name.c_str(), boost::interprocess::read_only);
+          boost::interprocess::mapped_region
+            region(file, boost::interprocess::read_only);
+          region_.swap(region);
+        } catch (const std::exception& e) {
+          if (out)
+            *out << "Error: could not map " << file_name << ": " << e.what()
+                 << std::endl;
+          throw std::invalid_argument("Error mapping input file");
+        }
+        begin_ = static_cast<const char*>(region_.get_address());
+        end_ = begin_ + region_.get_size();
+        parse_preamble(out);
+      }
+
+      /**
+       * Parse everything but the draws of csv output held in memory.
+       * The memory must outlive the reader.
+       *
+       * @param[in] data first character of the csv output
+       * @param[in] size number of characters
+       * @param[out] out output stream to send messages
+       * @throw std::invalid_argument if there is no header
+       */
+      mapped_stan_csv_reader(const char* data, size_t size,
+                             std::ostream* out = 0)
+        : begin_(data), end_(data + size) {
+        parse_preamble(out);
+      }
+
+      const stan_csv_metadata& metadata() const {
+        return metadata_;
+      }
+
+      const Eigen::Matrix<std::string, Eigen::Dynamic, 1>& header() const {
+        return header_;
+      }
+
+      const stan_csv_adaptation& adaptation() const {
+        return adaptation_;
+      }
+
+      /**
+       * Return the indexes of the named columns.
+       *
+       * @param[in] names column names as they appear in the header, with
+       *   indexes in brackets
+       * @return index of each column
+       * @throw std::invalid_argument if a name is not in the header
+       */
+      std::vector<size_t>
+      column_indexes(const std::vector<std::string>& names) const {
+        std::vector<size_t> indexes;
+        for (size_t n = 0; n < names.size(); ++n) {
+          int index = 0;
+          while (index < header_.size() && header_(index) != names[n])
+            ++index;
+          if (index == header_.size())
+            throw std::invalid_argument("Unknown column " + names[n]);
+          indexes.push_back(index);
+        }
+        return indexes;
+      }
+
+      /**
+       * Return the indexes of all of the columns.
+       */
+      std::vector<size_t> column_indexes() const {
+        std::vector<size_t> indexes(header_.size());
+        for (size_t n = 0; n < indexes.size(); ++n)
+          indexes[n] = n;
+        return indexes;
+      }
+
+      /**
+       * Parse the given columns of each row of draws in turn and pass
+       * them to the callback, adding the times in the comments to the
+       * timing.  Reading stops at the first malformed row.
+       *
+       * @tparam F type of callback with signature
+       *   <code>void(const std::vector<double>&)</code>
+       * @param[in] columns indexes of the columns to read, in the order
+       *   they are passed to the callback
+       * @param[in] f callback
+       * @param[in,out] timing timing to add to
+       * @param[out] out output stream to send messages
+       * @return true if every row was read
+       * @throw std::invalid_argument if a column index is out of range
+       */
+      template <class F>
+      bool read_samples(const std::vector<size_t>& columns, const F& f,
+                        stan_csv_timing& timing, std::ostream* out) const {
+        size_t num_cols = header_.size();
+        std::vector<int> position(num_cols, -1);
+        for (size_t k = 0; k < columns.size(); ++k) {
+          if (columns[k] >= num_cols)
+            throw std::invalid_argument("Column index out of range");
+          position[columns[k]] = k;
+        }
+
+        std::vector<double> row(columns.size());
+        int rows = 0;
+        const char* p = samples_begin_;
+        while (p < end_) {
+          const char* eol = find_end_of_line(p);
+          const char* next = eol < end_ ? eol + 1 : end_;
+          if (eol > p && eol[-1] == '\r')
+            --eol;
+          if (eol == p) {
+            p = next;
+            continue;
+          }
+          if (*p == '#') {
+            stan_csv_reader::read_timing(std::string(p, eol), timing);
+            p = next;
+            continue;
+          }
+
+          size_t col = 0;
+          const char* field = p;
+          while (true) {
+            const char* comma = static_cast<const char*>(
+                std::memchr(field, ',', eol - field));
+            const char* field_end = comma ? comma : eol;
+            if (col < num_cols && position[col] >= 0
+                && !parse_double(field, field_end, row[position[col]])) {
+              if (out)
+                *out << "Error: could not read '"
+                     << std::string(field, field_end) << "' in row "
+                     << rows + 1 << std::endl;
+              return false;
+            }
+            ++col;
+            if (!comma)
+              break;
+            field = comma + 1;
+          }
+          if (col != num_cols) {
+            if (out)
+              *out << "Error: expected " << num_cols << " columns, but found "
+                   << col << " instead for row " << rows + 1 << std::endl;
+            return false;
+          }
+
+          f(row);
+          ++rows;
+          p = next;
+        }
+        return true;
+      }
+
+      /**
+       * Read the given columns of the draws into a matrix.
+       *
+       * @param[in] columns indexes of the columns to read
+       * @param[out] samples draws, one row per draw
+       * @param[in,out] timing timing to add to
+       * @param[out] out output stream to send messages
+       * @return true if every row was read
+       */
+      bool read_samples(const std::vector<size_t>& columns,
+                        Eigen::MatrixXd& samples, stan_csv_timing& timing,
+                        std::ostream* out) const {
+        std::vector<double> values;
+        bool ok = read_samples(columns, append_row(values), timing, out);
+        size_t rows = columns.empty() ? 0 : values.size() / columns.size();
+        samples = Eigen::Map<Eigen::Matrix<double, Eigen::Dynamic,
+                                           Eigen::Dynamic, Eigen::RowMajor> >
+          (values.data(), rows, columns.size());
+        return ok;
+      }
+
+    private:
+      struct append_row {
+        explicit append_row(std::vector<double>& values) : values_(values) {}
+        void operator()(const std::vector<double>& row) const {
+          values_.insert(values_.end(), row.begin(), row.end());
+        }
+        std::vector<double>& values_;
+      };
+
+      const char* find_end_of_line(const char* p) const {
+        const char* eol = static_cast<const char*>(
+            std::memchr(p, '\n', end_ - p));
+        return eol ? eol : end_;
+      }
+
+      /**
+       * Return the comment lines starting at the given position and
+       * move the position past them.
+       */
+      std::string read_comments(const char*& p) const {
+        const char* begin = p;
+        while (p < end_ && *p == '#') {
+          const char* eol = find_end_of_line(p);
+          p = eol < end_ ? eol + 1 : end_;
+        }
+        return std::string(begin, p);
+      }
+
+      void parse_preamble(std::ostream* out) {
+        const char* p = begin_;
+
+        std::stringstream metadata(read_comments(p));
+        if (!stan_csv_reader::read_metadata(metadata, metadata_, out)) {
+          if (out)
+            *out << "Warning: non-fatal error reading metadata" << std::endl;
+        }
+
+        const char* eol = find_end_of_line(p);
+        std::string line(p, eol);
+        boost::trim(line);
+        if (line.empty()) {
+          if (out)
+            *out << "Error: error reading header" << std::endl;
+          throw std::invalid_argument
+            ("Error with header of input file in parse");
+        }
+        std::vector<std::string> names;
+        boost::split(names, line, boost::is_any_of(","));
+        header_.resize(names.size());
+        for (size_t n = 0; n < names.size(); ++n) {
+          boost::trim(names[n]);
+          header_(n) = stan_csv_reader::parse_column_name(names[n]);
+        }
+        p = eol < end_ ? eol + 1 : end_;
+
+        std::stringstream adaptation(read_comments(p));
+        if (!stan_csv_reader::read_adaptation(adaptation, adaptation_, out)) {
+          if (out)
+            *out << "Warning: non-fatal error reading adapation data"
+                 << std::endl;
+        }
+        samples_begin_ = p;
+      }
+
+      boost::interprocess::mapped_region region_;
+      const char* begin_;
+      const char* end_;
+      const char* samples_begin_;
+
+      stan_csv_metadata metadata_;
+      Eigen::Matrix<std::string, Eigen::Dynamic, 1> header_;
+      stan_csv_adaptation adaptation_;
+    };
+
+  }
+}
+#endif
@@ -0,0 +1,119 @@
+#ifndef STAN_IO_PARSE_DOUBLE_HPP
+#define STAN_IO_PARSE_DOUBLE_HPP
+
+#include <boost/cstdint.hpp>
+#include <clocale>
+#include <cstdlib>
+#include <string>
+
+namespace stan {
+  namespace io {
+
+    /**
+     * Parse a decimal number written with a <code>.</code> as the
+     * decimal point, whatever the locale, without iostreams.
+     *
+     * Numbers with at most 19 significant digits whose value can be
+     * computed exactly, which includes numbers written with up to 15
+     * significant digits and a moderate exponent, are converted
+     * directly.  Other numbers, including <code>inf</code> and
+     * <code>nan</code>, are converted with <code>strtod</code>.  The
+     * result is correctly rounded either way.
+     *
+     * @param[in] begin first character of the number
+     * @param[in] end one past the last character of the number
+     * @param[out] x value of the number
+     * @return true if the characters, ignoring surrounding spaces, are
+     *   a number
+     */
+    inline bool parse_double(const char* begin, const char* end, double& x) {
+      while (begin < end && (*begin == ' ' || *begin == '\t'))
+        ++begin;
+      while (end > begin && (end[-1] == ' ' || end[-1] == '\t'
+                             || end[-1] == '\r'))
+        --end;
+      if (begin == end)
+        return false;
+
+      const char* p = begin;
+      bool negative = (*p == '-');
+      if (*p == '-' || *p == '+')
+        ++p;
+
+      boost::uint64_t mantissa = 0;
+      int significant_digits = 0;
+      int exponent = 0;
+      bool any_digits = false;
+      bool exact = true;
+      for (; p < end && *p >= '0' && *p <= '9'; ++p) {
+        any_digits = true;
+        if (significant_digits < 19) {
+          mantissa = mantissa * 10 + (*p - '0');
+          significant_digits += (mantissa != 0);
+        } else {
+          ++exponent;
+          exact = exact && *p == '0';
+        }
+      }
+      if (p < end && *p == '.') {
+        for (++p; p < end && *p >= '0' && *p <= '9'; ++p) {
+          any_digits = true;
+          if (significant_digits < 19) {
+            mantissa = mantissa * 10 + (*p - '0');
+            significant_digits += (mantissa != 0);
+            --exponent;
+          } else {
+            exact = exact && *p == '0';
+          }
+        }
+      }
+      if (any_digits && p < end && (*p == 'e' || *p == 'E')) {
+        ++p;
+        bool negative_exponent = (p < end && *p == '-');
+        if (p < end && (*p == '-' || *p == '+'))
+          ++p;
+        int e = 0;
+        bool exponent_digits = false;
+        for (; p < end && *p >= '0' && *p <= '9'; ++p) {
+          exponent_digits = true;
+          if (e < 100000)
+            e = e * 10 + (*p - '0');
+        }
+        if (!exponent_digits)
+          exact = false;
+        exponent += negative_exponent ? -e : e;
+      }
+
+      if (any_digits && exact && p == end) {
+        static const double powers[] = {
+          1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+          1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+        };
+        if (mantissa == 0) {
+          x = negative ? -0.0 : 0.0;
+          return true;
+        }
+        if (mantissa <= (1ULL << 53) && exponent >= -22 && exponent <= 22) {
+          double value = static_cast<double>(mantissa);
+          value = exponent < 0 ? value / powers[-exponent]
+                               : value * powers[exponent];
+          x = negative ? -value : value;
+          return true;
+        }
+      }
+
+      std::string number(begin, end);
+      const char decimal_point = *std::localeconv()->decimal_point;
+      if (decimal_point != '.') {
+        std::string::size_type point = number.find('.');
+        if (point != std::string::npos)
+          number[point] = decimal_point;
+      }
+      char* number_end;
+      x = std::strtod(number.c_str(), &number_end);
+      return number_end == number.c_str() + number.size();
+    }
+
+  }
+}
+#endif
@@ -3,9 +3,9 @@
 
 #include <stan/io/var_context.hpp>
 #include <boost/random/uniform_real_distribution.hpp>
-#include <algorithm>
 #include <limits>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 namespace stan {
@@ -83,6 +83,8 @@ namespace stan {
                           false, false, 0);
 
         vals_r_ = constrained_to_vals_r(constrained_params, dims_);
+        for (size_t n = 0; n < names_.size(); ++n)
+          index_[names_[n]] = n;
       }
 
       /**
@@ -100,7 +102,7 @@ namespace stan {
        * model.
        */
       bool contains_r(const std::string& name) const {
-        return std::find(names_.begin(), names_.end(), name) != names_.end();
+        return index_.find(name) != index_.end();
       }
 
       /**
@@ -112,11 +114,11 @@ namespace stan {
        *   var_context; an empty vector is returned otherwise
        */
       std::vector<double> vals_r(const std::string& name) const {
-        std::vector<std::string>::const_iterator loc
-          = std::find(names_.begin(), names_.end(), name);
-        if (loc == names_.end())
+        std::unordered_map<std::string, size_t>::const_iterator loc
+          = index_.find(name);
+        if (loc == index_.end())
            return std::vector<double>();
-        return vals_r_[loc - names_.begin()];
+        return vals_r_[loc->second];
       }
 
       /**
@@ -127,11 +129,31 @@ namespace stan {
        *   is returned otherwise
        */
       std::vector<size_t> dims_r(const std::string& name) const {
-        std::vector<std::string>::const_iterator loc
-          = std::find(names_.begin(), names_.end(), name);
-        if (loc == names_.end())
+        std::unordered_map<std::string, size_t>::const_iterator loc
+          = index_.find(name);
+        if (loc == index_.end())
           return std::vector<size_t>();
-        return dims_[loc - names_.begin()];
+        return dims_[loc->second];
+      }
+
+      /**
+       * Read the constrained values and dimensions of the variable.
+       *
+       * @param name Name of variable.
+       * @param vals Set to the constrained values.
+       * @param dims Set to the dimensions of the variable.
+       * @return <code>true</code> if the name is a parameter in the
+       * model.
+       */
+      bool lookup_r(const std::string& name, std::vector<double>& vals,
+                    std::vector<size_t>& dims) const {
+        std::unordered_map<std::string, size_t>::const_iterator loc
+          = index_.find(name);
+        if (loc == index_.end())
+          return false;
+        vals = vals_r_[loc->second];
+        dims = dims_[loc->second];
+        return true;
       }
 
       /**
@@ -203,6 +225,10 @@ namespace stan {
        * Parameter names in the model
        */
       std::vector<std::string> names_;
+      /**
+       * Position of each parameter name in <code>names_</code>
+       */
+      std::unordered_map<std::string, size_t> index_;
       /**
        * Dimensions of parameters in the model
        */
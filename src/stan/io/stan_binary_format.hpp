@@ -0,0 +1,191 @@
+#ifndef STAN_IO_STAN_BINARY_FORMAT_HPP
+#define STAN_IO_STAN_BINARY_FORMAT_HPP
+
+#include <boost/cstdint.hpp>
+#include <cstring>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace stan {
+  namespace io {
+
+    /**
+     * Layout of the binary draw format written by
+     * <code>callbacks::binary_writer</code> and read by
+     * <code>stan_binary_reader</code>.
+     *
+     * A file starts with the eight byte <code>magic</code> string and
+     * is followed by a sequence of records, each introduced by a one
+     * byte tag:
+     *
+     * <ul>
+     * <li><code>names_record</code>: the number of names followed by
+     *   each name as a length and its characters.</li>
+     * <li><code>comment_record</code>: a length and its characters; an
+     *   empty comment is a blank line.</li>
+     * <li><code>draws_record</code>: the number of rows and columns of
+     *   a block of draws followed by the columns of the block, one
+     *   after the other.</li>
+     * </ul>
+     *
+     * Lengths and sizes are unsigned 64 bit integers and draws are
+     * IEEE 754 doubles, both stored little-endian.
+     */
+    namespace stan_binary {
+
+      const char magic[] = "STANDRW1";
+      const size_t magic_size = 8;
+
+      const char names_record = 'N';
+      const char comment_record = 'C';
+      const char draws_record = 'D';
+
+      /**
+       * Return true if the host stores numbers little-endian, in which
+       * case they can be copied to and from the format unchanged.
+       */
+      inline bool host_is_little_endian() {
+        const boost::uint16_t one = 1;
+        unsigned char first;
+        std::memcpy(&first, &one, 1);
+        return first == 1;
+      }
+
+      /**
+       * Reverse the bytes of each of the values in the given buffer.
+       *
+       * @param[in,out] bytes buffer holding the values
+       * @param[in] n number of values
+       * @param[in] size size of each value in bytes
+       */
+      inline void swap_bytes(char* bytes, size_t n, size_t size) {
+        for (size_t i = 0; i < n; ++i) {
+          char* value = bytes + i * size;
+          for (size_t lo = 0, hi = size - 1; lo < hi; ++lo, --hi) {
+            char tmp = value[lo];
+            value[lo] = value[hi];
+            value[hi] = tmp;
+          }
+        }
+      }
+
+      /**
+       * Write an unsigned integer.
+       *
+       * @param[in,out] out stream to write to
+       * @param[in] x value to write
+       */
+      inline void write_size(std::ostream& out, boost::uint64_t x) {
+        char bytes[sizeof(x)];
+        std::memcpy(bytes, &x, sizeof(x));
+        if (!host_is_little_endian())
+          swap_bytes(bytes, 1, sizeof(x));
+        out.write(bytes, sizeof(x));
+      }
+
+      /**
+       * Read an unsigned integer.
+       *
+       * @param[in,out] in stream to read from
+       * @param[out] x value read
+       * @return true if the value was read
+       */
+      inline bool read_size(std::istream& in, boost::uint64_t& x) {
+        char bytes[sizeof(x)];
+        if (!in.read(bytes, sizeof(x)))
+          return false;
+        if (!host_is_little_endian())
+          swap_bytes(bytes, 1, sizeof(x));
+        std::memcpy(&x, bytes, sizeof(x));
+        return true;
+      }
+
+      /**
+       * Return the number of bytes left to read from a stream, which
+       * bounds the sizes read from it.
+       *
+       * @param[in,out] in stream to read from
+       * @return number of bytes left, or the largest size if the stream
+       *   cannot seek
+       */
+      inline boost::uint64_t remaining_size(std::istream& in) {
+        std::istream::pos_type pos = in.tellg();
+        if (pos == std::istream::pos_type(-1))
+          return std::numeric_limits<boost::uint64_t>::max();
+        in.seekg(0, std::ios::end);
+        std::istream::pos_type end = in.tellg();
+        in.seekg(pos);
+        if (end == std::istream::pos_type(-1) || end < pos)
+          return std::numeric_limits<boost::uint64_t>::max();
+        return static_cast<boost::uint64_t>(end - pos);
+      }
+
+      /**
+       * Write a string as its length followed by its characters.
+       *
+       * @param[in,out] out stream to write to
+       * @param[in] x string to write
+       */
+      inline void write_string(std::ostream& out, const std::string& x) {
+        write_size(out, x.size());
+        out.write(x.data(), x.size());
+      }
+
+      /**
+       * Read a string written by <code>write_string</code>.
+       *
+       * @param[in,out] in stream to read from
+       * @param[out] x string read
+       * @return true if the string was read, false if the stream ends
+       *   before it
+       */
+      inline bool read_string(std::istream& in, std::string& x) {
+        boost::uint64_t size;
+        if (!read_size(in, size) || size > remaining_size(in))
+          return false;
+        x.resize(size);
+        return size == 0 || in.read(&x[0], size);
+      }
+
+      /**
+       * Write a contiguous sequence of doubles.
+       *
+       * @param[in,out] out stream to write to
+       * @param[in] x first value to write
+       * @param[in] n number of values
+       */
+      inline void write_doubles(std::ostream& out, const double* x, size_t n) {
+        if (host_is_little_endian()) {
+          out.write(reinterpret_cast<const char*>(x), n * sizeof(double));
+          return;
+        }
+        std::vector<char> bytes(n * sizeof(double));
+        std::memcpy(bytes.data(), x, bytes.size());
+        swap_bytes(bytes.data(), n, sizeof(double));
+        out.write(bytes.data(), bytes.size());
+      }
+
+      /**
+       * Read a contiguous sequence of doubles.
+       *
+       * @param[in,out] in stream to read from
+       * @param[out] x location of the first value read
+       * @param[in] n number of values
+       * @return true if all of the values were read
+       */
+      inline bool read_doubles(std::istream& in, double* x, size_t n) {
+        if (!in.read(reinterpret_cast<char*>(x), n * sizeof(double)))
+          return false;
+        if (!host_is_little_endian())
+          swap_bytes(reinterpret_cast<char*>(x), n, sizeof(double));
+        return true;
+      }
+
+    }
+
+  }
+}
+#endif
@@ -0,0 +1,182 @@
+#ifndef STAN_IO_STAN_BINARY_READER_HPP
+#define STAN_IO_STAN_BINARY_READER_HPP
+
+#include <stan/io/stan_binary_format.hpp>
+#include <stan/io/stan_csv_reader.hpp>
+#include <boost/cstdint.hpp>
+#include <Eigen/Dense>
+#include <istream>
+#include <limits>
+#include <ostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace stan {
+  namespace io {
+
+    /**
+     * Reads Stan output written in the binary format of
+     * <code>callbacks::binary_writer</code> into the same structure as
+     * <code>stan_csv_reader</code>.  Comments are interpreted as the
+     * corresponding comment lines of a csv file would be.
+     */
+    class stan_binary_reader {
+    public:
+      stan_binary_reader() {}
+      ~stan_binary_reader() {}
+
+      /**
+       * Parses the stream.
+       *
+       * @param[in] in input stream to parse, opened in binary mode
+       * @param[out] out output stream to send messages
+       * @throw std::invalid_argument if the stream is not in the binary
+       *   format or has no header
+       */
+      static stan_csv parse(std::istream& in, std::ostream* out) {
+        stan_csv data;
+
+        char magic[stan_binary::magic_size];
+        if (!in.read(magic, stan_binary::magic_size)
+            || std::string(magic, stan_binary::magic_size)
+               != std::string(stan_binary::magic, stan_binary::magic_size)) {
+          if (out)
+            *out << "Error: not a Stan binary output file" << std::endl;
+          throw std::invalid_argument
+            ("Error with format of input file in parse");
+        }
+
+        std::stringstream metadata;
+        std::stringstream adaptation;
+        bool read_header = false;
+        bool read_samples = false;
+        bool samples_ok = true;
+        size_t num_rows = 0;
+        std::vector<std::vector<double> > blocks;
+        std::vector<size_t> block_rows;
+
+        char tag;
+        while (in.get(tag)) {
+          if (tag == stan_binary::comment_record) {
+            std::string comment;
+            if (!stan_binary::read_string(in, comment)) {
+              samples_ok = false;
+              break;
+            }
+            if (!read_header)
+              metadata << "# " << comment << '\n';
+            else if (!read_samples)
+              adaptation << "# " << comment << '\n';
+            else
+              stan_csv_reader::read_timing("# " + comment, data.timing);
+          } else if (tag == stan_binary::names_record && !read_header) {
+            if (!read_names(in, data.header))
+              break;
+            read_header = true;
+          } else if (tag == stan_binary::draws_record && read_header) {
+            read_samples = true;
+            boost::uint64_t rows, cols;
+            if (!stan_binary::read_size(in, rows)
+                || !stan_binary::read_size(in, cols)) {
+              samples_ok = false;
+              break;
+            }
+            if (cols != static_cast<boost::uint64_t>(data.header.size())) {
+              if (out)
+                *out << "Error: expected " << data.header.size()
+                     << " columns, but found " << cols
+                     << " instead for row " << num_rows + 1 << std::endl;
+              samples_ok = false;
+              break;
+            }
+            if ((cols > 0 && rows > std::numeric_limits<size_t>::max()
+                 / sizeof(double) / cols)
+                || rows * cols > stan_binary::remaining_size(in)
+                   / sizeof(double)) {
+              if (out)
+                *out << "Error: block of " << rows << " draws is larger"
+                     << " than the rest of the input" << std::endl;
+              samples_ok = false;
+              break;
+            }
+            blocks.push_back(std::vector<double>(rows * cols));
+            if (!stan_binary::read_doubles(in, blocks.back().data(),
+                                           rows * cols)) {
+              blocks.pop_back();
+              samples_ok = false;
+              break;
+            }
+            block_rows.push_back(rows);
+            num_rows += rows;
+          } else {
+            if (out)
+              *out << "Error: unexpected record in binary output"
+                   << std::endl;
+            samples_ok = false;
+            break;
+          }
+        }
+
+        if (!read_header) {
+          if (out)
+            *out << "Error: error reading header" << std::endl;
+          throw std::invalid_argument
+            ("Error with header of input file in parse");
+        }
+
+        if (!stan_csv_reader::read_metadata(metadata, data.metadata, out)) {
+          if (out)
+            *out << "Warning: non-fatal error reading metadata" << std::endl;
+        }
+
+        if (!stan_csv_reader::read_adaptation(adaptation, data.adaptation,
+                                              out)) {
+          if (out)
+            *out << "Warning: non-fatal error reading adapation data"
+                 << std::endl;
+        }
+
+        if (!samples_ok) {
+          if (out)
+            *out << "Warning: non-fatal error reading samples" << std::endl;
+        }
+
+        size_t num_cols = data.header.size();
+        data.samples.resize(num_rows, num_rows > 0 ? num_cols : 0);
+        size_t row = 0;
+        for (size_t b = 0; b < blocks.size(); ++b) {
+          data.samples.block(row, 0, block_rows[b], num_cols)
+            = Eigen::Map<Eigen::MatrixXd>(blocks[b].data(), block_rows[b],
+                                          num_cols);
+          row += block_rows[b];
+        }
+
+        return data;
+      }
+
+    private:
+      static bool
+      read_names(std::istream& in,
+                 Eigen::Matrix<std::string, Eigen::Dynamic, 1>& header) {
+        boost::uint64_t size;
+        if (!stan_binary::read_size(in, size)
+            || size > stan_binary::remaining_size(in) / 8)
+          return false;
+        header.resize(size);
+        for (boost::uint64_t n = 0; n < size; ++n) {
+          std::string name;
+          if (!stan_binary::read_string(in, name))
+            return false;
+          header(n) = stan_csv_reader::parse_column_name(name);
+        }
+        return true;
+      }
+    };
+
+  }  // io
+
+}  // stan
+
+#endif
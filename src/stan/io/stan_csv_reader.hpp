@@ -183,18 +183,29 @@ namespace stan {
           std::string token;
           std::getline(ss, token, ',');
           boost::trim(token);
-
-          int pos = token.find('.');
-          if (pos > 0) {
-            token.replace(pos, 1, "[");
-            std::replace(token.begin(), token.end(), '.', ',');
-            token += "]";
-          }
-          header(idx++) = token;
+          header(idx++) = parse_column_name(token);
         }
         return true;
       }
 
+      /**
+       * Return the name of a column in the header written by the
+       * services, converting flattened indexes such as
+       * <code>theta.1.2</code> to <code>theta[1,2]</code>.
+       *
+       * @param[in] name column name as written
+       * @return column name with indexes in brackets
+       */
+      static std::string parse_column_name(std::string name) {
+        int pos = name.find('.');
+        if (pos > 0) {
+          name.replace(pos, 1, "[");
+          std::replace(name.begin(), name.end(), '.', ',');
+          name += "]";
+        }
+        return name;
+      }
+
       static bool read_adaptation(std::istream& in,
                                   stan_csv_adaptation& adaptation,
                                   std::ostream* out) {
@@ -254,6 +265,26 @@ namespace stan {
           return true;
       }
 
+      /**
+       * Add the time from a comment line of the elapsed time block,
+       * such as <code>#  Elapsed Time: 0.1 seconds (Warm-up)</code>, to
+       * the timing.  Other lines are ignored.
+       *
+       * @param[in] line comment line
+       * @param[in,out] timing timing to add to
+       */
+      static void read_timing(const std::string& line,
+                              stan_csv_timing& timing) {
+        int left = 17;
+        int right = line.find(" seconds");
+        if (line.find("(Warm-up)") != std::string::npos)
+          timing.warmup
+            += boost::lexical_cast<double>(line.substr(left, right - left));
+        else if (line.find("(Sampling)") != std::string::npos)
+          timing.sampling
+            += boost::lexical_cast<double>(line.substr(left, right - left));
+      }
+
       static bool read_samples(std::istream& in, Eigen::MatrixXd& samples,
                                stan_csv_timing& timing, std::ostream* out) {
         std::stringstream ss;
@@ -277,17 +308,7 @@ namespace stan {
             break;
 
           if (comment_line) {
-            if (line.find("(Warm-up)") != std::string::npos) {
-              int left = 17;
-              int right = line.find(" seconds");
-              timing.warmup
-                += boost::lexical_cast<double>(line.substr(left, right - left));
-            } else if (line.find("(Sampling)") != std::string::npos) {
-              int left = 17;
-              int right = line.find(" seconds");
-              timing.sampling
-                += boost::lexical_cast<double>(line.substr(left, right - left));
-            }
+            read_timing(line, timing);
           } else {
             ss << line << '\n';
             int current_cols = std::count(line.begin(), line.end(), ',') + 1;
@@ -111,6 +111,99 @@ namespace stan {
        */
       virtual void names_i(std::vector<std::string>& names) const = 0;
 
+      /**
+       * Return a pointer to the floating point values for the variable
+       * of the specified name in last-index-major order without
+       * copying them, or null if the context does not hold them as a
+       * contiguous sequence of floating point values, in which case
+       * they must be read with <code>vals_r</code>.  A variable with
+       * no values held this way yields a non-null pointer and a size
+       * of zero.  The values are valid until the context is modified
+       * or destroyed.
+       *
+       * <p>The default implementation returns null.
+       *
+       * @param name Name of variable.
+       * @param size Set to the number of values, or zero if null is
+       * returned.
+       * @return Pointer to the first value or null.
+       */
+      virtual const double* vals_r_ptr(const std::string& /* name */,
+                                       size_t& size) const {
+        size = 0;
+        return 0;
+      }
+
+      /**
+       * Return a pointer to the integer values for the variable of
+       * the specified name in last-index-major order without copying
+       * them, or null if the context does not hold them as a
+       * contiguous sequence of integers, in which case they must be
+       * read with <code>vals_i</code>.  A variable with no values held
+       * this way yields a non-null pointer and a size of zero.  The
+       * values are valid until the context is modified or destroyed.
+       *
+       * <p>The default implementation returns null.
+       *
+       * @param name Name of variable.
+       * @param size Set to the number of values, or zero if null is
+       * returned.
+       * @return Pointer to the first value or null.
+       */
+      virtual const int* vals_i_ptr(const std::string& /* name */,
+                                    size_t& size) const {
+        size = 0;
+        return 0;
+      }
+
+      /**
+       * Read the floating point values and dimensions of the variable
+       * of the specified name with a single lookup, casting integer
+       * values to floating point values.
+       *
+       * <p>The default implementation calls <code>contains_r</code>,
+       * <code>vals_r</code> and <code>dims_r</code>.
+       *
+       * @param name Name of variable.
+       * @param vals Set to the values in last-index-major order.
+       * @param dims Set to the dimensions.
+       * @return <code>true</code> if the variable is defined, otherwise
+       * the values and dimensions are left unchanged.
+       */
+      virtual bool lookup_r(const std::string& name,
+                            std::vector<double>& vals,
+                            std::vector<size_t>& dims) const {
+        if (!contains_r(name))
+          return false;
+        vals = vals_r(name);
+        dims = dims_r(name);
+        return true;
+      }
+
+      /**
+       * Read the integer values and dimensions of the variable of the
+       * specified name with a single lookup.
+       *
+       * <p>The default implementation calls <code>contains_i</code>,
+       * <code>vals_i</code> and <code>dims_i</code>.
+       *
+       * @param name Name of variable.
+       * @param vals Set to the values in last-index-major order.
+       * @param dims Set to the dimensions.
+       * @return <code>true</code> if the variable is defined with
+       * integer values, otherwise the values and dimensions are left
+       * unchanged.
+       */
+      virtual bool lookup_i(const std::string& name,
+                            std::vector<int>& vals,
+                            std::vector<size_t>& dims) const {
+        if (!contains_i(name))
+          return false;
+        vals = vals_i(name);
+        dims = dims_i(name);
+        return true;
+      }
+
       void add_vec(std::stringstream& msg,
                    const std::vector<size_t>& dims) const {
         msg << '(';
@@ -5,9 +5,33 @@ namespace stan {
 
   namespace mcmc {
 
+    class cross_chain_adaptation;
+
     class base_adaptation {
     public:
+      base_adaptation()
+        : cross_chain_(0), chain_(0) {}
+
       virtual void restart() {}
+
+      /**
+       * Pools the adaptation with the other chains sharing
+       * <code>cross_chain</code>.  Passing a null pointer makes the
+       * adaptation use the draws of this chain only, which is the
+       * default.
+       *
+       * @param[in] cross_chain pool shared by all chains
+       * @param[in] chain index of this chain in the pool
+       */
+      void set_cross_chain_adaptation(cross_chain_adaptation* cross_chain,
+                                      int chain) {
+        cross_chain_ = cross_chain;
+        chain_ = chain;
+      }
+
+    protected:
+      cross_chain_adaptation* cross_chain_;
+      int chain_;
     };
 
   }  // mcmc
@@ -32,6 +32,20 @@ namespace stan {
                                    std::vector<std::string>& names) {}
 
       virtual void get_sampler_diagnostics(std::vector<double>& values) {}
+
+      /**
+       * Return the number of gradients of the log density the
+       * sampler has evaluated since it was constructed, or zero if
+       * the sampler does not use gradients.
+       */
+      virtual long get_num_gradients() { return 0; }
+
+      /**
+       * Return the number of leapfrog steps the sampler has taken
+       * since it was constructed, or zero if it does not integrate
+       * Hamiltonian trajectories.
+       */
+      virtual long get_num_leapfrogs() { return 0; }
     };
 
   }  // mcmc
@@ -4,10 +4,10 @@
 #include <stan/io/stan_csv_reader.hpp>
 #include <stan/math/prim/mat.hpp>
 #include <stan/analyze/mcmc/compute_effective_sample_size.hpp>
+#include <stan/analyze/mcmc/compute_summary.hpp>
 #include <boost/accumulators/accumulators.hpp>
 #include <boost/accumulators/statistics/stats.hpp>
 #include <boost/accumulators/statistics/mean.hpp>
-#include <boost/accumulators/statistics/tail_quantile.hpp>
 #include <boost/accumulators/statistics/p_square_quantile.hpp>
 #include <boost/accumulators/statistics/variance.hpp>
 #include <boost/accumulators/statistics/covariance.hpp>
@@ -42,30 +42,36 @@ namespace stan {
      * as global or single-chain read or write methods.
      *
      * <p><b>Storage Order</b>: Storage is column/last-index major.
+     * The draws of each chain are stored in a matrix with spare rows,
+     * whose capacity doubles when it fills, so appending draws takes
+     * amortized constant time per draw.  The column of a parameter in
+     * a chain is contiguous, so it can be returned as a view without
+     * copying.
      */
     template <class RNG = boost::random::ecuyer1988>
     class chains {
     private:
       Eigen::Matrix<std::string, Dynamic, 1> param_names_;
-      Eigen::Matrix<Eigen::MatrixXd, Dynamic, 1> samples_;
+      std::vector<Eigen::MatrixXd> samples_;
+      std::vector<int> num_samples_;
       Eigen::VectorXi warmup_;
 
-      static double mean(const Eigen::VectorXd& x) {
+      static double mean(const Eigen::Ref<const Eigen::VectorXd>& x) {
         return (x.array() / x.size()).sum();
       }
 
-      static double variance(const Eigen::VectorXd& x) {
+      static double variance(const Eigen::Ref<const Eigen::VectorXd>& x) {
         double m = mean(x);
         return ((x.array() - m) / std::sqrt((x.size() - 1.0))).square().sum();
       }
 
-      static double sd(const Eigen::VectorXd& x) {
+      static double sd(const Eigen::Ref<const Eigen::VectorXd>& x) {
         return std::sqrt(variance(x));
       }
 
 
-      static double covariance(const Eigen::VectorXd& x,
-                               const Eigen::VectorXd& y,
+      static double covariance(const Eigen::Ref<const Eigen::VectorXd>& x,
+                               const Eigen::Ref<const Eigen::VectorXd>& y,
                                std::ostream* err = 0) {
         if (x.rows() != y.rows() && err)
           *err << "warning: covariance of different length chains";
@@ -84,8 +90,8 @@ namespace stan {
         return boost::accumulators::covariance(acc) * M / (M-1);
       }
 
-      static double correlation(const Eigen::VectorXd& x,
-                                const Eigen::VectorXd& y,
+      static double correlation(const Eigen::Ref<const Eigen::VectorXd>& x,
+                                const Eigen::Ref<const Eigen::VectorXd>& y,
                                 std::ostream* err = 0) {
         if (x.rows() != y.rows() && err)
           *err << "warning: covariance of different length chains";
@@ -112,71 +118,24 @@ namespace stan {
                                * boost::accumulators::variance(acc_y));
       }
 
-      static double quantile(const Eigen::VectorXd& x, const double prob) {
-        using boost::accumulators::accumulator_set;
-        using boost::accumulators::left;
-        using boost::accumulators::quantile;
-        using boost::accumulators::quantile_probability;
-        using boost::accumulators::right;
-        using boost::accumulators::stats;
-        using boost::accumulators::tag::tail;
-        using boost::accumulators::tag::tail_quantile;
-        double M = x.rows();
-        // size_t cache_size = std::min(prob, 1-prob)*M + 2;
-        size_t cache_size = M;
-
-        if (prob < 0.5) {
-          accumulator_set<double, stats<tail_quantile<left> > >
-            acc(tail<left>::cache_size = cache_size);
-          for (int i = 0; i < M; i++)
-            acc(x(i));
-          return quantile(acc, quantile_probability = prob);
-        }
-        accumulator_set<double, stats<tail_quantile<right> > >
-          acc(tail<right>::cache_size = cache_size);
-        for (int i = 0; i < M; i++)
-          acc(x(i));
-        return quantile(acc, quantile_probability = prob);
+      static double quantile(const Eigen::Ref<const Eigen::VectorXd>& x,
+                             const double prob) {
+        Eigen::VectorXd probs(1);
+        probs << prob;
+        return quantiles(x, probs)(0);
       }
 
       static Eigen::VectorXd
-      quantiles(const Eigen::VectorXd& x, const Eigen::VectorXd& probs) {
-        using boost::accumulators::accumulator_set;
-        using boost::accumulators::left;
-        using boost::accumulators::quantile_probability;
-        using boost::accumulators::quantile;
-        using boost::accumulators::right;
-        using boost::accumulators::stats;
-        using boost::accumulators::tag::tail;
-        using boost::accumulators::tag::tail_quantile;
-        double M = x.rows();
-
-        // size_t cache_size = M/2 + 2;
-        size_t cache_size = M;  // 2 + 2;
-
-        accumulator_set<double, stats<tail_quantile<left> > >
-          acc_left(tail<left>::cache_size = cache_size);
-        accumulator_set<double, stats<tail_quantile<right> > >
-          acc_right(tail<right>::cache_size = cache_size);
-
-        for (int i = 0; i < M; i++) {
-          acc_left(x(i));
-          acc_right(x(i));
-        }
-
-        Eigen::VectorXd q(probs.size());
-        for (int i = 0; i < probs.size(); i++) {
-          if (probs(i) < 0.5)
-            q(i) = quantile(acc_left,
-                            quantile_probability = probs(i));
-          else
-            q(i) = quantile(acc_right,
-                            quantile_probability = probs(i));
-        }
+      quantiles(const Eigen::Ref<const Eigen::VectorXd>& x,
+                const Eigen::VectorXd& probs) {
+        std::vector<double> sample(x.data(), x.data() + x.size());
+        Eigen::VectorXd q;
+        analyze::compute_quantiles(sample, probs, q);
         return q;
       }
 
-      static Eigen::VectorXd autocorrelation(const Eigen::VectorXd& x) {
+      static Eigen::VectorXd
+      autocorrelation(const Eigen::Ref<const Eigen::VectorXd>& x) {
         using std::vector;
         using stan::math::index_type;
         typedef typename index_type<vector<double> >::type idx_t;
@@ -193,7 +152,8 @@ namespace stan {
         return ac2;
       }
 
-      static Eigen::VectorXd autocovariance(const Eigen::VectorXd& x) {
+      static Eigen::VectorXd
+      autocovariance(const Eigen::Ref<const Eigen::VectorXd>& x) {
         using std::vector;
         using stan::math::index_type;
         typedef typename index_type<vector<double> >::type idx_t;
@@ -255,6 +215,21 @@ namespace stan {
         return sqrt((var_between/var_within + n-1)/n);
       }
 
+      /**
+       * Make room for at least the given number of draws in a chain,
+       * at least doubling its capacity if it has to grow.
+       */
+      void reserve(const int chain, const int num_draws) {
+        Eigen::MatrixXd& buffer = samples_[chain];
+        if (num_draws <= buffer.rows())
+          return;
+        int capacity = std::max(num_draws, 2 * static_cast<int>(buffer.rows()));
+        Eigen::MatrixXd grown(capacity, num_params());
+        grown.topRows(num_samples_[chain])
+          = buffer.topRows(num_samples_[chain]);
+        buffer.swap(grown);
+      }
+
     public:
       explicit chains(const Eigen::Matrix<std::string, Dynamic, 1>& param_names)
         : param_names_(param_names) { }
@@ -312,7 +287,7 @@ namespace stan {
       }
 
       int num_samples(const int chain) const {
-        return samples_(chain).rows();
+        return num_samples_[chain];
       }
 
       int num_samples() const {
@@ -333,39 +308,32 @@ namespace stan {
         return n;
       }
 
+      /**
+       * Append draws to a chain, adding empty chains up to it if
+       * needed.  Views of the chain's draws returned before this call
+       * are invalidated.
+       *
+       * @param[in] chain index of the chain
+       * @param[in] sample draws, one row per draw
+       * @throw std::invalid_argument if the number of columns does not
+       *   match the number of parameters
+       */
       void add(const int chain,
                const Eigen::MatrixXd& sample) {
         if (sample.cols() != num_params())
           throw std::invalid_argument("add(chain, sample): number of columns"
                                       " in sample does not match chains");
-        if (num_chains() == 0 || chain >= num_chains()) {
+        if (chain >= num_chains()) {
           int n = num_chains();
-
-          // Need this block for Windows. conservativeResize
-          // does not keep the references.
-          Eigen::Matrix<Eigen::MatrixXd, Dynamic, 1>
-            samples_copy(num_chains());
-          Eigen::VectorXi warmup_copy(num_chains());
-          for (int i = 0; i < n; i++) {
-            samples_copy(i) = samples_(i);
-            warmup_copy(i) = warmup_(i);
-          }
-
-          samples_.resize(chain+1);
-          warmup_.resize(chain+1);
-          for (int i = 0; i < n; i++) {
-            samples_(i) = samples_copy(i);
-            warmup_(i) = warmup_copy(i);
-          }
-          for (int i = n; i < chain+1; i++) {
-            samples_(i) = Eigen::MatrixXd(0, num_params());
-            warmup_(i) = 0;
-          }
+          samples_.resize(chain + 1, Eigen::MatrixXd(0, num_params()));
+          num_samples_.resize(chain + 1, 0);
+          warmup_.conservativeResize(chain + 1);
+          warmup_.tail(chain + 1 - n).setZero();
         }
-        int row = samples_(chain).rows();
-        Eigen::MatrixXd new_samples(row+sample.rows(), num_params());
-        new_samples << samples_(chain), sample;
-        samples_(chain) = new_samples;
+        reserve(chain, num_samples_[chain] + sample.rows());
+        samples_[chain].middleRows(num_samples_[chain], sample.rows())
+          = sample;
+        num_samples_[chain] += sample.rows();
       }
 
       void add(const Eigen::MatrixXd& sample) {
@@ -410,8 +378,18 @@ namespace stan {
           set_warmup(num_chains()-1, stan_csv.metadata.num_warmup);
       }
 
-      Eigen::VectorXd samples(const int chain, const int index) const {
-        return samples_(chain).col(index).bottomRows(num_kept_samples(chain));
+      /**
+       * Return a view of the kept draws of a parameter in a chain,
+       * which is valid until draws are next added to the chain.
+       *
+       * @param[in] chain index of the chain
+       * @param[in] index index of the parameter
+       */
+      Eigen::Map<const Eigen::VectorXd>
+      samples(const int chain, const int index) const {
+        return Eigen::Map<const Eigen::VectorXd>(
+            samples_[chain].col(index).data() + warmup(chain),
+            num_kept_samples(chain));
       }
 
       Eigen::VectorXd samples(const int index) const {
@@ -419,13 +397,14 @@ namespace stan {
         int start = 0;
         for (int chain = 0; chain < num_chains(); chain++) {
           int n = num_kept_samples(chain);
-          s.middleRows(start, n) = samples_(chain).col(index).bottomRows(n);
+          s.middleRows(start, n) = samples(chain, index);
           start += n;
         }
         return s;
       }
 
-      Eigen::VectorXd samples(const int chain, const std::string& name) const {
+      Eigen::Map<const Eigen::VectorXd>
+      samples(const int chain, const std::string& name) const {
         return samples(chain, index(name));
       }
 
@@ -610,12 +589,9 @@ namespace stan {
         int n_chains = num_chains();
         std::vector<const double*> draws(n_chains);
         std::vector<size_t> sizes(n_chains);
-        int n_kept_samples = 0;
         for (int chain = 0; chain < n_chains; ++chain) {
-          n_kept_samples = num_kept_samples(chain);
-          draws[chain]
-            = samples_(chain).col(index).bottomRows(n_kept_samples).data();
-          sizes[chain] = n_kept_samples;
+          draws[chain] = samples(chain, index).data();
+          sizes[chain] = num_kept_samples(chain);
         }
         return analyze::compute_effective_sample_size(draws, sizes);
       }
@@ -636,6 +612,37 @@ namespace stan {
       double split_potential_scale_reduction(const std::string& name) const {
         return split_potential_scale_reduction(index(name));
       }
+
+      /**
+       * Summarize the kept draws of every parameter in one pass per
+       * parameter, on up to the given number of threads.  See
+       * <code>analyze::compute_summary</code>.
+       *
+       * @param[in] probs probabilities of the quantiles
+       * @param[out] summaries summary of each parameter
+       * @param[in] num_threads maximum number of threads to use
+       */
+      void summary(const Eigen::VectorXd& probs,
+                   std::vector<analyze::parameter_summary>& summaries,
+                   int num_threads) const {
+        std::vector<Eigen::Block<const Eigen::MatrixXd> > draws;
+        for (int chain = 0; chain < num_chains(); ++chain)
+          draws.push_back(samples_[chain].middleRows(
+              warmup(chain), num_kept_samples(chain)));
+        analyze::compute_summary(draws, probs, summaries, num_threads);
+      }
+
+      /**
+       * Summarize the kept draws of every parameter, using the number
+       * of threads given by <code>STAN_NUM_THREADS</code>.
+       *
+       * @param[in] probs probabilities of the quantiles
+       * @param[out] summaries summary of each parameter
+       */
+      void summary(const Eigen::VectorXd& probs,
+                   std::vector<analyze::parameter_summary>& summaries) const {
+        summary(probs, summaries, util::get_num_threads(num_params()));
+      }
     };
 
   }
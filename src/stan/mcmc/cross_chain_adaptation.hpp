@@ -0,0 +1,237 @@
+#ifndef STAN_MCMC_CROSS_CHAIN_ADAPTATION_HPP
+#define STAN_MCMC_CROSS_CHAIN_ADAPTATION_HPP
+
+#include <stan/math/prim/mat.hpp>
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+namespace stan {
+
+  namespace mcmc {
+
+    /**
+     * Pools warmup adaptation across chains which run concurrently in
+     * one process.  Every chain hands its own estimate to the pool at
+     * the same point of warmup and blocks until all chains still
+     * running have done so; each chain then receives the same pooled
+     * estimate.  Contributions are combined in chain order, so the
+     * result does not depend on the order in which the chains arrive.
+     *
+     * Because the chains wait for each other, every chain needs its
+     * own thread.  A chain which stops early must call
+     * <code>leave</code> so the remaining chains are not blocked.
+     */
+    class cross_chain_adaptation {
+    public:
+      explicit cross_chain_adaptation(int num_chains)
+        : num_chains_(num_chains), num_active_(num_chains),
+          num_arrived_(0), generation_(0),
+          active_(num_chains, true), arrived_(num_chains, false),
+          weights_(num_chains, 0), payloads_(num_chains) {}
+
+      int num_chains() const {
+        return num_chains_;
+      }
+
+      /**
+       * Replaces <code>var</code> with the sample variance of the
+       * draws of all chains' estimators.
+       *
+       * @param[in] chain index of the calling chain
+       * @param[in] estimator Welford estimator of the calling chain
+       * @param[out] var pooled variance
+       * @return total number of draws pooled
+       */
+      double pool_variance(int chain,
+                           stan::math::welford_var_estimator& estimator,
+                           Eigen::VectorXd& var) {
+        double n = estimator.num_samples();
+        Eigen::MatrixXd payload(var.size(), 2);
+        Eigen::VectorXd mean(var.size());
+        estimator.sample_mean(mean);
+        Eigen::VectorXd m2 = Eigen::VectorXd::Zero(var.size());
+        if (n > 1) {
+          estimator.sample_variance(m2);
+          m2 *= n - 1;
+        }
+        payload << mean, m2;
+
+        Eigen::MatrixXd pooled = exchange(chain, n, payload);
+        double total = pooled(0, 0);
+        if (total > 1)
+          var = pooled.block(1, 1, var.size(), 1) / (total - 1.0);
+        return total;
+      }
+
+      /**
+       * Replaces <code>covar</code> with the sample covariance of the
+       * draws of all chains' estimators.
+       *
+       * @param[in] chain index of the calling chain
+       * @param[in] estimator Welford estimator of the calling chain
+       * @param[out] covar pooled covariance
+       * @return total number of draws pooled
+       */
+      double pool_covariance(int chain,
+                             stan::math::welford_covar_estimator& estimator,
+                             Eigen::MatrixXd& covar) {
+        double n = estimator.num_samples();
+        Eigen::MatrixXd payload(covar.rows(), covar.cols() + 1);
+        Eigen::VectorXd mean(covar.rows());
+        estimator.sample_mean(mean);
+        Eigen::MatrixXd m2
+          = Eigen::MatrixXd::Zero(covar.rows(), covar.cols());
+        if (n > 1) {
+          estimator.sample_covariance(m2);
+          m2 *= n - 1;
+        }
+        payload << mean, m2;
+
+        Eigen::MatrixXd pooled = exchange(chain, n, payload);
+        double total = pooled(0, 0);
+        if (total > 1)
+          covar = pooled.block(1, 1, covar.rows(), covar.cols())
+                  / (total - 1.0);
+        return total;
+      }
+
+      /**
+       * Replaces <code>epsilon</code> with the geometric mean of the
+       * step sizes of all chains.
+       *
+       * @param[in] chain index of the calling chain
+       * @param[in, out] epsilon step size
+       */
+      void pool_stepsize(int chain, double& epsilon) {
+        Eigen::MatrixXd payload(1, 1);
+        payload(0, 0) = std::log(epsilon);
+        epsilon = std::exp(exchange(chain, 1, payload)(1, 0));
+      }
+
+      /**
+       * Removes a chain from the pool, e.g. because it failed to
+       * initialize or was interrupted.  Chains waiting in the pool
+       * are released if the departed chain was the last one they
+       * were waiting for.
+       *
+       * @param[in] chain index of the departing chain
+       */
+      void leave(int chain) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (!active_[chain])
+          return;
+        active_[chain] = false;
+        --num_active_;
+        if (arrived_[chain]) {
+          arrived_[chain] = false;
+          --num_arrived_;
+        }
+        if (num_arrived_ > 0 && num_arrived_ == num_active_)
+          complete();
+      }
+
+    private:
+      /**
+       * Combines per chain means (first column) and sums of squared
+       * deviations (remaining columns) weighted by number of draws
+       * into a matrix holding the total number of draws in the top
+       * left entry, the pooled mean in the rest of the first column
+       * and the pooled sum of squared deviations in the remaining
+       * block.
+       */
+      static Eigen::MatrixXd
+      pool_moments(const std::vector<double>& weights,
+                   const std::vector<Eigen::MatrixXd>& payloads,
+                   const std::vector<bool>& arrived) {
+        Eigen::Index rows = 0;
+        Eigen::Index cols = 0;
+        double total = 0;
+        for (size_t c = 0; c < payloads.size(); ++c) {
+          if (!arrived[c])
+            continue;
+          rows = payloads[c].rows();
+          cols = payloads[c].cols();
+          total += weights[c];
+        }
+
+        Eigen::VectorXd mean = Eigen::VectorXd::Zero(rows);
+        if (total > 0) {
+          for (size_t c = 0; c < payloads.size(); ++c)
+            if (arrived[c])
+              mean += (weights[c] / total) * payloads[c].col(0);
+        }
+
+        Eigen::MatrixXd m2 = Eigen::MatrixXd::Zero(rows, cols - 1);
+        for (size_t c = 0; c < payloads.size(); ++c) {
+          if (!arrived[c] || cols == 1)
+            continue;
+          Eigen::VectorXd diff = payloads[c].col(0) - mean;
+          m2 += payloads[c].rightCols(cols - 1);
+          if (cols == 2)
+            m2 += weights[c] * diff.cwiseProduct(diff);
+          else
+            m2 += weights[c] * diff * diff.transpose();
+        }
+
+        Eigen::MatrixXd pooled = Eigen::MatrixXd::Zero(rows + 1, cols);
+        pooled(0, 0) = total;
+        pooled.block(1, 0, rows, 1) = mean;
+        if (cols > 1)
+          pooled.block(1, 1, rows, cols - 1) = m2;
+        return pooled;
+      }
+
+      /**
+       * Deposits the payload of one chain and blocks until all active
+       * chains have deposited theirs.  The last chain to arrive pools
+       * the payloads; all chains return the same result.
+       */
+      Eigen::MatrixXd exchange(int chain, double weight,
+                               const Eigen::MatrixXd& payload) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        weights_[chain] = weight;
+        payloads_[chain] = payload;
+        arrived_[chain] = true;
+        ++num_arrived_;
+
+        unsigned int generation = generation_;
+        if (num_arrived_ == num_active_)
+          complete();
+        else
+          released_.wait(lock,
+                         [&]() { return generation != generation_; });
+        return result_;
+      }
+
+      /**
+       * Combines the payloads of the chains which arrived and
+       * releases them.  Must be called with the mutex held.
+       */
+      void complete() {
+        result_ = pool_moments(weights_, payloads_, arrived_);
+        std::fill(arrived_.begin(), arrived_.end(), false);
+        num_arrived_ = 0;
+        ++generation_;
+        released_.notify_all();
+      }
+
+      const int num_chains_;
+      int num_active_;
+      int num_arrived_;
+      unsigned int generation_;
+      std::vector<bool> active_;
+      std::vector<bool> arrived_;
+      std::vector<double> weights_;
+      std::vector<Eigen::MatrixXd> payloads_;
+      Eigen::MatrixXd result_;
+      std::mutex mutex_;
+      std::condition_variable released_;
+    };
+
+  }  // mcmc
+
+}  // stan
+#endif
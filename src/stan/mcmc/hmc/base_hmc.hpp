@@ -70,6 +70,14 @@ namespace stan {
         z_.get_params(values);
       }
 
+      long get_num_gradients() {
+        return hamiltonian_.get_num_gradients();
+      }
+
+      long get_num_leapfrogs() {
+        return integrator_.get_num_steps();
+      }
+
       void seed(const Eigen::VectorXd& q) {
         z_.q = q;
       }
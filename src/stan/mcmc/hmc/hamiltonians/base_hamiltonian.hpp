@@ -3,9 +3,10 @@
 
 #include <stan/callbacks/logger.hpp>
 #include <stan/math/prim/mat/fun/Eigen.hpp>
-#include <stan/model/gradient.hpp>
+#include <stan/model/gradient_evaluator.hpp>
 #include <stan/model/log_prob_propto.hpp>
 #include <Eigen/Dense>
+#include <atomic>
 #include <iostream>
 #include <limits>
 #include <stdexcept>
@@ -18,7 +19,7 @@ namespace stan {
     class base_hamiltonian {
     public:
       explicit base_hamiltonian(const Model& model)
-        : model_(model) {}
+        : model_(model), gradient_(model), num_gradients_(0) {}
 
       ~base_hamiltonian() {}
 
@@ -65,9 +66,9 @@ namespace stan {
       }
 
       void update_potential_gradient(Point& z, callbacks::logger& logger) {
+        ++num_gradients_;
         try {
-          stan::model::gradient(model_, z.q, z.V, z.g, logger);
-          z.V = -z.V;
+          z.V = -gradient_.eval(z.q, z.g, logger);
         } catch (const std::exception& e) {
           this->write_error_msg_(e, logger);
           z.V = std::numeric_limits<double>::infinity();
@@ -83,8 +84,19 @@ namespace stan {
         update_potential_gradient(z, logger);
       }
 
+      /**
+       * Return the number of gradients of the log density evaluated
+       * through this Hamiltonian.  The count may be updated from
+       * several threads.
+       */
+      long get_num_gradients() const {
+        return num_gradients_;
+      }
+
     protected:
       const Model& model_;
+      stan::model::gradient_evaluator<Model> gradient_;
+      std::atomic<long> num_gradients_;
 
       void write_error_msg_(const std::exception& e,
                             callbacks::logger& logger) {
@@ -105,6 +105,8 @@ namespace stan {
       }
 
       void update_metric(softabs_point& z, callbacks::logger& logger) {
+        // The gradient is evaluated along with the Hessian
+        ++this->num_gradients_;
         math::hessian<softabs_fun<Model> >(softabs_fun<Model>(this->model_, 0),
                                            z.q, z.V, z.g, z.hessian);
         z.V = -z.V;
@@ -2,6 +2,7 @@
 #define STAN_MCMC_HMC_INTEGRATORS_BASE_INTEGRATOR_HPP
 
 #include <stan/callbacks/logger.hpp>
+#include <atomic>
 
 namespace stan {
   namespace mcmc {
@@ -9,13 +10,24 @@ namespace stan {
     template <class Hamiltonian>
     class base_integrator {
     public:
-      base_integrator() {}
+      base_integrator() : num_steps_(0) {}
 
       virtual void
       evolve(typename Hamiltonian::PointType& z,
              Hamiltonian& hamiltonian,
              const double epsilon,
              callbacks::logger& logger) = 0;
+
+      /**
+       * Return the number of steps taken by the integrator.  The count
+       * may be updated from several threads.
+       */
+      long get_num_steps() const {
+        return num_steps_;
+      }
+
+    protected:
+      std::atomic<long> num_steps_;
     };
 
   }  // mcmc
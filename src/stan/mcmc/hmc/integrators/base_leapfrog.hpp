@@ -19,6 +19,7 @@ namespace stan {
                   Hamiltonian& hamiltonian,
                   const double epsilon,
                   callbacks::logger& logger) {
+        ++this->num_steps_;
         begin_update_p(z, hamiltonian, 0.5 * epsilon,
                        logger);
         update_q(z, hamiltonian, epsilon,
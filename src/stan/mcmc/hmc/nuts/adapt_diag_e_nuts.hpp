@@ -37,6 +37,7 @@ namespace stan {
 
           if (update) {
             this->init_stepsize(logger);
+            this->stepsize_adaptation_.pool_stepsize(this->nom_epsilon_);
 
             this->stepsize_adaptation_.set_mu(log(10 * this->nom_epsilon_));
             this->stepsize_adaptation_.restart();
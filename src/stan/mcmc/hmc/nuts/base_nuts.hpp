@@ -6,7 +6,13 @@
 #include <stan/math/prim/scal.hpp>
 #include <stan/mcmc/hmc/base_hmc.hpp>
 #include <stan/mcmc/hmc/hamiltonians/ps_point.hpp>
+#include <stan/mcmc/hmc/nuts/nuts_workspace.hpp>
+#include <stan/mcmc/hmc/nuts/speculative_subtree.hpp>
+#include <stan/util/parallel_for.hpp>
+#include <boost/random/uniform_01.hpp>
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cmath>
 #include <limits>
 #include <string>
@@ -24,7 +30,10 @@ namespace stan {
       base_nuts(const Model& model, BaseRNG& rng)
         : base_hmc<Model, Hamiltonian, Integrator, BaseRNG>(model, rng),
           depth_(0), max_depth_(5), max_deltaH_(1000),
-          n_leapfrog_(0), divergent_(false), energy_(0) {
+          n_leapfrog_(0), divergent_(false), energy_(0),
+          speculative_(false), wall_time_(0),
+          workspace_(model.num_params_r(), max_depth_),
+          speculative_threads_(1) {
       }
 
       /**
@@ -35,7 +44,10 @@ namespace stan {
         : base_hmc<Model, Hamiltonian, Integrator, BaseRNG>(model, rng,
                                                             inv_e_metric),
           depth_(0), max_depth_(5), max_deltaH_(1000),
-          n_leapfrog_(0), divergent_(false), energy_(0) {
+          n_leapfrog_(0), divergent_(false), energy_(0),
+          speculative_(false), wall_time_(0),
+          workspace_(model.num_params_r(), max_depth_),
+          speculative_threads_(1) {
       }
 
       /**
@@ -46,7 +58,10 @@ namespace stan {
         : base_hmc<Model, Hamiltonian, Integrator, BaseRNG>(model, rng,
                                                             inv_e_metric),
         depth_(0), max_depth_(5), max_deltaH_(1000),
-        n_leapfrog_(0), divergent_(false), energy_(0) {
+        n_leapfrog_(0), divergent_(false), energy_(0),
+        speculative_(false), wall_time_(0),
+        workspace_(model.num_params_r(), max_depth_),
+        speculative_threads_(1) {
       }
 
       ~base_nuts() {}
@@ -60,8 +75,10 @@ namespace stan {
       }
 
       void set_max_depth(int d) {
-        if (d > 0)
+        if (d > 0) {
           max_depth_ = d;
+          workspace_.reserve_depth(d);
+        }
       }
 
       void set_max_delta(double d) {
@@ -71,8 +88,37 @@ namespace stan {
       int get_max_depth() { return this->max_depth_; }
       double get_max_delta() { return this->max_deltaH_; }
 
+      /**
+       * Enable or disable speculative trajectories.
+       *
+       * A speculative trajectory draws the direction of every doubling
+       * and a seed for the multinomial samples within each new
+       * subtree before it is built.  Whenever the next doubling goes
+       * the other way, its subtree is built on a second thread while
+       * the current one is being built, and it is thrown away if the
+       * trajectory ends first.  The draws are exact and depend only on
+       * the seed, not on whether subtrees were built ahead of time,
+       * but differ from those of the default sampler.
+       *
+       * Subtrees are only built on a second thread when compiled with
+       * <code>STAN_THREADS</code> and <code>STAN_NUM_THREADS</code>
+       * allows at least two threads; the logger must then be safe to
+       * call from several threads.  The wall time of each transition is
+       * reported in the sampler parameter <code>wall_time__</code>.
+       *
+       * @param speculative true to build speculative trajectories
+       */
+      void set_speculative(bool speculative) {
+        speculative_ = speculative;
+      }
+
+      bool get_speculative() { return this->speculative_; }
+
       sample
       transition(sample& init_sample, callbacks::logger& logger) {
+        std::chrono::steady_clock::time_point start
+          = std::chrono::steady_clock::now();
+
         // Initialize the algorithm
         this->sample_stepsize();
 
@@ -81,16 +127,25 @@ namespace stan {
         this->hamiltonian_.sample_p(this->z_, this->rand_int_);
         this->hamiltonian_.init(this->z_, logger);
 
-        ps_point z_plus(this->z_);
-        ps_point z_minus(z_plus);
-
-        ps_point z_sample(z_plus);
-        ps_point z_propose(z_plus);
-
-        Eigen::VectorXd p_sharp_plus = this->hamiltonian_.dtau_dp(this->z_);
-        Eigen::VectorXd p_sharp_dummy = p_sharp_plus;
-        Eigen::VectorXd p_sharp_minus = p_sharp_plus;
-        Eigen::VectorXd rho = this->z_.p;
+        // Trajectory state lives in the preallocated workspace
+        ps_point& z_plus = workspace_.z_plus;
+        ps_point& z_minus = workspace_.z_minus;
+        ps_point& z_sample = workspace_.z_sample;
+        ps_point& z_propose = workspace_.z_propose;
+        z_plus = this->z_;
+        z_minus = z_plus;
+        z_sample = z_plus;
+        z_propose = z_plus;
+
+        Eigen::VectorXd& p_sharp_plus = workspace_.p_sharp_plus;
+        Eigen::VectorXd& p_sharp_dummy = workspace_.p_sharp_dummy;
+        Eigen::VectorXd& p_sharp_minus = workspace_.p_sharp_minus;
+        Eigen::VectorXd& rho = workspace_.rho;
+        Eigen::VectorXd& rho_subtree = workspace_.rho_subtree;
+        p_sharp_plus = this->hamiltonian_.dtau_dp(this->z_);
+        p_sharp_dummy = p_sharp_plus;
+        p_sharp_minus = p_sharp_plus;
+        rho = this->z_.p;
 
         double log_sum_weight = 0;  // log(exp(H0 - H0))
         double H0 = this->hamiltonian_.H(this->z_);
@@ -101,14 +156,25 @@ namespace stan {
         this->depth_ = 0;
         this->divergent_ = false;
 
+        // Subtrees built ahead of time are abandoned when these go out
+        // of scope
+        speculative_subtree speculation[2];
+        if (speculative_)
+          begin_speculation();
+
         while (this->depth_ < this->max_depth_) {
           // Build a new subtree in a random direction
-          Eigen::VectorXd rho_subtree = Eigen::VectorXd::Zero(rho.size());
+          rho_subtree.setZero();
           bool valid_subtree = false;
           double log_sum_weight_subtree
             = -std::numeric_limits<double>::infinity();
 
-          if (this->rand_uniform_() > 0.5) {
+          if (speculative_) {
+            valid_subtree
+              = extend_speculatively(speculation, H0, n_leapfrog,
+                                     log_sum_weight_subtree, sum_metro_prob,
+                                     logger);
+          } else if (this->rand_uniform_() > 0.5) {
             this->z_.ps_point::operator=(z_plus);
             valid_subtree
               = build_tree(this->depth_, z_propose,
@@ -160,6 +226,8 @@ namespace stan {
 
         this->z_.ps_point::operator=(z_sample);
         this->energy_ = this->hamiltonian_.H(this->z_);
+        this->wall_time_ = std::chrono::duration<double>(
+            std::chrono::steady_clock::now() - start).count();
         return sample(this->z_.q, -this->z_.V, accept_prob);
       }
 
@@ -169,6 +237,8 @@ namespace stan {
         names.push_back("n_leapfrog__");
         names.push_back("divergent__");
         names.push_back("energy__");
+        if (speculative_)
+          names.push_back("wall_time__");
       }
 
       void get_sampler_params(std::vector<double>& values) {
@@ -177,6 +247,8 @@ namespace stan {
         values.push_back(this->n_leapfrog_);
         values.push_back(this->divergent_);
         values.push_back(this->energy_);
+        if (speculative_)
+          values.push_back(this->wall_time_);
       }
 
       virtual bool compute_criterion(Eigen::VectorXd& p_sharp_minus,
@@ -187,9 +259,15 @@ namespace stan {
       }
 
       /**
-       * Recursively build a new subtree to completion or until
-       * the subtree becomes invalid.  Returns validity of the
-       * resulting subtree.
+       * Build a new subtree to completion or until the subtree
+       * becomes invalid.  Returns validity of the resulting subtree.
+       *
+       * The tree is built iteratively: leaves are generated in
+       * trajectory order and each subtree is merged as soon as its
+       * last leaf is complete, using one checkpoint per level of the
+       * tree from the workspace in place of a recursive call.  Random
+       * numbers are drawn in the same order as a depth first
+       * recursion would draw them.
        *
        * @param depth Depth of the desired subtree
        * @param z_propose State proposed from subtree
@@ -210,93 +288,355 @@ namespace stan {
                       double H0, double sign, int& n_leapfrog,
                       double& log_sum_weight, double& sum_metro_prob,
                       callbacks::logger& logger) {
-        // Base case
-        if (depth == 0) {
-          this->integrator_.evolve(this->z_, this->hamiltonian_,
-                                   sign * this->epsilon_,
-                                   logger);
-          ++n_leapfrog;
+        tree_context context(this->z_, workspace_, this->rand_uniform_,
+                             this->divergent_);
+        return build_tree(context, depth, z_propose,
+                          p_sharp_left, p_sharp_right, rho,
+                          H0, sign, n_leapfrog,
+                          log_sum_weight, sum_metro_prob, logger);
+      }
 
-          double h = this->hamiltonian_.H(this->z_);
-          if (boost::math::isnan(h))
-            h = std::numeric_limits<double>::infinity();
+      int depth_;
+      int max_depth_;
+      double max_deltaH_;
 
-          if ((h - H0) > this->max_deltaH_) this->divergent_ = true;
+      int n_leapfrog_;
+      bool divergent_;
+      double energy_;
 
-          log_sum_weight = math::log_sum_exp(log_sum_weight, H0 - h);
+      bool speculative_;
+      double wall_time_;
 
-          if (H0 - h > 0)
-            sum_metro_prob += 1;
-          else
-            sum_metro_prob += std::exp(H0 - h);
+    protected:
+      typedef typename Hamiltonian<Model, BaseRNG>::PointType point_type;
 
-          z_propose = this->z_;
-          rho += this->z_.p;
+      /**
+       * State a subtree is built from: the end of the trajectory that
+       * is extended, the workspace holding the subtree checkpoints,
+       * the generator for the multinomial samples and the divergence
+       * flag.  A subtree built speculatively is abandoned once
+       * <code>cancel</code> becomes true.
+       */
+      struct tree_context {
+        tree_context(point_type& z_end, nuts_workspace& tree_workspace,
+                     boost::uniform_01<BaseRNG&>& uniform,
+                     bool& divergent_flag,
+                     const std::atomic<bool>* cancel_flag = 0)
+          : z(z_end), workspace(tree_workspace), rand_uniform(uniform),
+            divergent(divergent_flag), cancel(cancel_flag) {}
+
+        point_type& z;
+        nuts_workspace& workspace;
+        boost::uniform_01<BaseRNG&>& rand_uniform;
+        bool& divergent;
+        const std::atomic<bool>* cancel;
+      };
 
-          p_sharp_left = this->hamiltonian_.dtau_dp(this->z_);
-          p_sharp_right = p_sharp_left;
+      /**
+       * One end of a speculatively built trajectory together with the
+       * results of the last subtree added to it.  The subtree's
+       * proposal, outer p_sharp and summed momentum are left in
+       * <code>workspace.z_propose</code>,
+       * <code>workspace.p_sharp_plus</code> and
+       * <code>workspace.rho_subtree</code>.
+       */
+      struct speculative_lane {
+        speculative_lane(int n, int max_depth)
+          : z(n), workspace(n, max_depth), valid(false), divergent(false),
+            n_leapfrog(0), log_sum_weight(0), sum_metro_prob(0) {}
+
+        point_type z;
+        nuts_workspace workspace;
+        bool valid;
+        bool divergent;
+        int n_leapfrog;
+        double log_sum_weight;
+        double sum_metro_prob;
+      };
 
-          return !this->divergent_;
+      /**
+       * Build a new subtree from the given state to completion, until
+       * the subtree becomes invalid or until it is cancelled.
+       * Returns validity of the resulting subtree.
+       *
+       * The tree is built iteratively: leaves are generated in
+       * trajectory order and each subtree is merged as soon as its
+       * last leaf is complete, using one checkpoint per level of the
+       * tree from the workspace in place of a recursive call.  Random
+       * numbers are drawn in the same order as a depth first
+       * recursion would draw them.
+       *
+       * @param context State to build the subtree from
+       * @param depth Depth of the desired subtree
+       * @param z_propose State proposed from subtree
+       * @param p_sharp_left p_sharp from left boundary of returned tree
+       * @param p_sharp_right p_sharp from the right boundary of returned tree
+       * @param rho Summed momentum across trajectory
+       * @param H0 Hamiltonian of initial state
+       * @param sign Direction in time to built subtree
+       * @param n_leapfrog Summed number of leapfrog evaluations
+       * @param log_sum_weight Log of summed weights across trajectory
+       * @param sum_metro_prob Summed Metropolis probabilities across trajectory
+       * @param logger Logger for messages
+       */
+      bool build_tree(tree_context& context, int depth,
+                      ps_point& z_propose,
+                      Eigen::VectorXd& p_sharp_left,
+                      Eigen::VectorXd& p_sharp_right,
+                      Eigen::VectorXd& rho,
+                      double H0, double sign, int& n_leapfrog,
+                      double& log_sum_weight, double& sum_metro_prob,
+                      callbacks::logger& logger) {
+        if (depth == 0)
+          return build_leaf(context, z_propose, p_sharp_left, p_sharp_right,
+                            rho, H0, sign, n_leapfrog, log_sum_weight,
+                            sum_metro_prob, logger);
+
+        // Checkpoints must not move while the tree is built
+        nuts_workspace& workspace = context.workspace;
+        workspace.reserve_depth(depth);
+
+        // Open the subtrees along the left edge of the tree
+        workspace.subtree(depth).begin(z_propose, p_sharp_left,
+                                       p_sharp_right, rho, log_sum_weight);
+        for (int d = depth - 1; d > 0; --d)
+          workspace.subtree(d).begin(workspace.subtree(d + 1));
+
+        while (true) {
+          if (context.cancel && *context.cancel) return false;
+
+          // Add the next leaf to the open subtree of depth one
+          nuts_subtree_workspace& parent = workspace.subtree(1);
+          bool valid_leaf
+            = parent.building_right
+              ? build_leaf(context, parent.z_propose_right,
+                           parent.p_sharp_dummy, *parent.p_sharp_right,
+                           parent.rho_right, H0, sign, n_leapfrog,
+                           parent.log_sum_weight_right, sum_metro_prob,
+                           logger)
+              : build_leaf(context, *parent.z_propose,
+                           *parent.p_sharp_left, parent.p_sharp_dummy,
+                           parent.rho_left, H0, sign, n_leapfrog,
+                           parent.log_sum_weight_left, sum_metro_prob,
+                           logger);
+          if (!valid_leaf) return false;
+
+          // Merge every subtree the leaf completes
+          int d = 1;
+          while (workspace.subtree(d).building_right) {
+            if (!merge_subtree(context, workspace.subtree(d))) return false;
+            if (d == depth) return true;
+            ++d;
+          }
+
+          // Continue with the right half of the lowest open subtree
+          workspace.subtree(d).begin_right();
+          for (--d; d > 0; --d)
+            workspace.subtree(d).begin(workspace.subtree(d + 1));
         }
-        // General recursion
-        Eigen::VectorXd p_sharp_dummy(this->z_.p.size());
+      }
+
+      /**
+       * Take a single leapfrog step, adding the new state to the
+       * trajectory as a subtree of depth zero.  Returns validity of
+       * the new state.
+       *
+       * @param context State to build the subtree from
+       * @param z_propose State proposed from subtree
+       * @param p_sharp_left p_sharp from left boundary of returned tree
+       * @param p_sharp_right p_sharp from the right boundary of returned tree
+       * @param rho Summed momentum across trajectory
+       * @param H0 Hamiltonian of initial state
+       * @param sign Direction in time to built subtree
+       * @param n_leapfrog Summed number of leapfrog evaluations
+       * @param log_sum_weight Log of summed weights across trajectory
+       * @param sum_metro_prob Summed Metropolis probabilities across trajectory
+       * @param logger Logger for messages
+       */
+      bool build_leaf(tree_context& context, ps_point& z_propose,
+                      Eigen::VectorXd& p_sharp_left,
+                      Eigen::VectorXd& p_sharp_right,
+                      Eigen::VectorXd& rho,
+                      double H0, double sign, int& n_leapfrog,
+                      double& log_sum_weight, double& sum_metro_prob,
+                      callbacks::logger& logger) {
+        this->integrator_.evolve(context.z, this->hamiltonian_,
+                                 sign * this->epsilon_,
+                                 logger);
+        ++n_leapfrog;
 
-        // Build the left subtree
-        double log_sum_weight_left = -std::numeric_limits<double>::infinity();
-        Eigen::VectorXd rho_left = Eigen::VectorXd::Zero(rho.size());
+        double h = this->hamiltonian_.H(context.z);
+        if (boost::math::isnan(h))
+          h = std::numeric_limits<double>::infinity();
 
-        bool valid_left
-          = build_tree(depth - 1, z_propose,
-                       p_sharp_left, p_sharp_dummy, rho_left,
-                       H0, sign, n_leapfrog,
-                       log_sum_weight_left, sum_metro_prob,
-                       logger);
+        if ((h - H0) > this->max_deltaH_) context.divergent = true;
 
-        if (!valid_left) return false;
+        log_sum_weight = math::log_sum_exp(log_sum_weight, H0 - h);
 
-        // Build the right subtree
-        ps_point z_propose_right(this->z_);
+        if (H0 - h > 0)
+          sum_metro_prob += 1;
+        else
+          sum_metro_prob += std::exp(H0 - h);
 
-        double log_sum_weight_right = -std::numeric_limits<double>::infinity();
-        Eigen::VectorXd rho_right = Eigen::VectorXd::Zero(rho.size());
+        z_propose = context.z;
+        rho += context.z.p;
 
-        bool valid_right
-          = build_tree(depth - 1, z_propose_right,
-                       p_sharp_dummy, p_sharp_right, rho_right,
-                       H0, sign, n_leapfrog,
-                       log_sum_weight_right, sum_metro_prob,
-                       logger);
+        p_sharp_left = this->hamiltonian_.dtau_dp(context.z);
+        p_sharp_right = p_sharp_left;
 
-        if (!valid_right) return false;
+        return !context.divergent;
+      }
 
+      /**
+       * Combine the completed left and right halves of a subtree,
+       * writing its results to the locations recorded in its
+       * checkpoint.  Returns validity of the subtree.
+       *
+       * @param context State the subtree is built from
+       * @param subtree Checkpoint of the subtree
+       */
+      bool merge_subtree(tree_context& context,
+                         nuts_subtree_workspace& subtree) {
         // Multinomial sample from right subtree
         double log_sum_weight_subtree
-          = math::log_sum_exp(log_sum_weight_left, log_sum_weight_right);
-        log_sum_weight
-          = math::log_sum_exp(log_sum_weight, log_sum_weight_subtree);
-
-        if (log_sum_weight_right > log_sum_weight_subtree) {
-          z_propose = z_propose_right;
+          = math::log_sum_exp(subtree.log_sum_weight_left,
+                              subtree.log_sum_weight_right);
+        *subtree.log_sum_weight
+          = math::log_sum_exp(*subtree.log_sum_weight,
+                              log_sum_weight_subtree);
+
+        if (subtree.log_sum_weight_right > log_sum_weight_subtree) {
+          *subtree.z_propose = subtree.z_propose_right;
         } else {
           double accept_prob
-            = std::exp(log_sum_weight_right - log_sum_weight_subtree);
-          if (this->rand_uniform_() < accept_prob)
-            z_propose = z_propose_right;
+            = std::exp(subtree.log_sum_weight_right - log_sum_weight_subtree);
+          if (context.rand_uniform() < accept_prob)
+            *subtree.z_propose = subtree.z_propose_right;
         }
 
-        Eigen::VectorXd rho_subtree = rho_left + rho_right;
-        rho += rho_subtree;
+        // Summed momentum of the subtree, accumulated in place
+        Eigen::VectorXd& rho_subtree = subtree.rho_left;
+        rho_subtree += subtree.rho_right;
+        *subtree.rho += rho_subtree;
 
-        return compute_criterion(p_sharp_left, p_sharp_right, rho_subtree);
+        return compute_criterion(*subtree.p_sharp_left,
+                                 *subtree.p_sharp_right, rho_subtree);
       }
 
-      int depth_;
-      int max_depth_;
-      double max_deltaH_;
+      /**
+       * Draw the direction and seed of every doubling of a speculative
+       * trajectory and start both of its ends at the current state.
+       */
+      void begin_speculation() {
+        speculative_sign_.resize(this->max_depth_);
+        speculative_seed_.resize(this->max_depth_);
+        for (int d = 0; d < this->max_depth_; ++d) {
+          speculative_sign_[d] = this->rand_uniform_() > 0.5 ? 1 : -1;
+          speculative_seed_[d] = this->rand_int_();
+        }
 
-      int n_leapfrog_;
-      bool divergent_;
-      double energy_;
+        if (lanes_.empty())
+          lanes_.resize(2, speculative_lane(this->z_.q.size(),
+                                            this->max_depth_));
+        lanes_[0].z = this->z_;
+        lanes_[1].z = this->z_;
+        speculative_threads_ = stan::util::get_num_autodiff_threads(2);
+      }
+
+      /**
+       * Build the subtree of the given doubling of a speculative
+       * trajectory at the end of its lane, using a generator seeded
+       * with the doubling's seed.
+       *
+       * @param depth Depth of the subtree, which is also the doubling
+       * @param H0 Hamiltonian of initial state
+       * @param cancel Flag requesting the subtree be abandoned, or null
+       * @param logger Logger for messages
+       */
+      void build_speculative_subtree(int depth, double H0,
+                                     const std::atomic<bool>* cancel,
+                                     callbacks::logger& logger) {
+        double sign = speculative_sign_[depth];
+        speculative_lane& lane = lanes_[sign > 0];
+        BaseRNG rng(speculative_seed_[depth]);
+        boost::uniform_01<BaseRNG&> rand_uniform(rng);
+
+        lane.divergent = false;
+        lane.n_leapfrog = 0;
+        lane.log_sum_weight = -std::numeric_limits<double>::infinity();
+        lane.sum_metro_prob = 0;
+        lane.workspace.rho_subtree.setZero();
+
+        tree_context context(lane.z, lane.workspace, rand_uniform,
+                             lane.divergent, cancel);
+        lane.valid = build_tree(context, depth, lane.workspace.z_propose,
+                                lane.workspace.p_sharp_dummy,
+                                lane.workspace.p_sharp_plus,
+                                lane.workspace.rho_subtree,
+                                H0, sign, lane.n_leapfrog,
+                                lane.log_sum_weight, lane.sum_metro_prob,
+                                logger);
+      }
+
+      /**
+       * Add the subtree of the current doubling to a speculative
+       * trajectory, first starting the subtree of the next doubling on
+       * another thread if it extends the other end of the trajectory.
+       * Returns validity of the added subtree, whose proposal, outer
+       * p_sharp and summed momentum are copied to the workspace.
+       *
+       * @param speculation Subtrees being built ahead of time for the
+       *   backward and forward ends of the trajectory
+       * @param H0 Hamiltonian of initial state
+       * @param n_leapfrog Summed number of leapfrog evaluations
+       * @param log_sum_weight Log of summed weights across subtree
+       * @param sum_metro_prob Summed Metropolis probabilities across trajectory
+       * @param logger Logger for messages
+       */
+      bool extend_speculatively(speculative_subtree (&speculation)[2],
+                                double H0, int& n_leapfrog,
+                                double& log_sum_weight,
+                                double& sum_metro_prob,
+                                callbacks::logger& logger) {
+        int depth = this->depth_;
+        bool forward = speculative_sign_[depth] > 0;
+
+        int next = depth + 1;
+        if (speculative_threads_ > 1 && next < this->max_depth_
+            && (speculative_sign_[next] > 0) != forward) {
+          speculation[!forward].launch(
+              [this, next, H0, &logger](const std::atomic<bool>& cancel) {
+                build_speculative_subtree(next, H0, &cancel, logger);
+              });
+        }
+
+        if (speculation[forward].running())
+          speculation[forward].join();
+        else
+          build_speculative_subtree(depth, H0, 0, logger);
+
+        speculative_lane& lane = lanes_[forward];
+        n_leapfrog += lane.n_leapfrog;
+        sum_metro_prob += lane.sum_metro_prob;
+        if (lane.divergent)
+          this->divergent_ = true;
+        log_sum_weight = lane.log_sum_weight;
+
+        workspace_.z_propose = lane.workspace.z_propose;
+        if (forward)
+          workspace_.p_sharp_plus = lane.workspace.p_sharp_plus;
+        else
+          workspace_.p_sharp_minus = lane.workspace.p_sharp_plus;
+        workspace_.rho_subtree = lane.workspace.rho_subtree;
+        return lane.valid;
+      }
+
+      nuts_workspace workspace_;
+
+      std::vector<speculative_lane> lanes_;
+      std::vector<int> speculative_sign_;
+      std::vector<unsigned int> speculative_seed_;
+      int speculative_threads_;
     };
 
   }  // mcmc
@@ -0,0 +1,159 @@
+#ifndef STAN_MCMC_HMC_NUTS_NUTS_WORKSPACE_HPP
+#define STAN_MCMC_HMC_NUTS_NUTS_WORKSPACE_HPP
+
+#include <stan/mcmc/hmc/hamiltonians/ps_point.hpp>
+#include <Eigen/Dense>
+#include <limits>
+#include <vector>
+
+namespace stan {
+  namespace mcmc {
+
+    /**
+     * Checkpoint of a subtree under construction by the iterative
+     * NUTS tree builder.  Holds the state of the subtree's left and
+     * right halves together with the locations its results are
+     * written to, which belong either to the caller or to the
+     * checkpoint of the enclosing subtree.
+     */
+    struct nuts_subtree_workspace {
+      explicit nuts_subtree_workspace(int n)
+        : z_propose_right(n), p_sharp_dummy(n), rho_left(n), rho_right(n),
+          log_sum_weight_left(0), log_sum_weight_right(0),
+          building_right(false), z_propose(0), p_sharp_left(0),
+          p_sharp_right(0), rho(0), log_sum_weight(0) {}
+
+      /**
+       * Start building the left half of a subtree whose results are
+       * written to the given locations.
+       *
+       * @param z_propose_out State proposed from subtree
+       * @param p_sharp_left_out p_sharp from left boundary of subtree
+       * @param p_sharp_right_out p_sharp from right boundary of subtree
+       * @param rho_out Summed momentum across trajectory
+       * @param log_sum_weight_out Log of summed weights across trajectory
+       */
+      void begin(ps_point& z_propose_out,
+                 Eigen::VectorXd& p_sharp_left_out,
+                 Eigen::VectorXd& p_sharp_right_out,
+                 Eigen::VectorXd& rho_out,
+                 double& log_sum_weight_out) {
+        z_propose = &z_propose_out;
+        p_sharp_left = &p_sharp_left_out;
+        p_sharp_right = &p_sharp_right_out;
+        rho = &rho_out;
+        log_sum_weight = &log_sum_weight_out;
+
+        building_right = false;
+        log_sum_weight_left = -std::numeric_limits<double>::infinity();
+        rho_left.setZero();
+      }
+
+      /**
+       * Start building the left half of a subtree which is the half of
+       * the given enclosing subtree currently under construction.
+       *
+       * @param parent Checkpoint of the enclosing subtree
+       */
+      void begin(nuts_subtree_workspace& parent) {
+        if (parent.building_right)
+          begin(parent.z_propose_right, parent.p_sharp_dummy,
+                *parent.p_sharp_right, parent.rho_right,
+                parent.log_sum_weight_right);
+        else
+          begin(*parent.z_propose, *parent.p_sharp_left,
+                parent.p_sharp_dummy, parent.rho_left,
+                parent.log_sum_weight_left);
+      }
+
+      /**
+       * Start building the right half of the subtree once its left
+       * half is complete.
+       */
+      void begin_right() {
+        building_right = true;
+        log_sum_weight_right = -std::numeric_limits<double>::infinity();
+        rho_right.setZero();
+      }
+
+      ps_point z_propose_right;
+      Eigen::VectorXd p_sharp_dummy;
+      Eigen::VectorXd rho_left;
+      Eigen::VectorXd rho_right;
+      double log_sum_weight_left;
+      double log_sum_weight_right;
+      bool building_right;
+
+      ps_point* z_propose;
+      Eigen::VectorXd* p_sharp_left;
+      Eigen::VectorXd* p_sharp_right;
+      Eigen::VectorXd* rho;
+      double* log_sum_weight;
+    };
+
+    /**
+     * Preallocated trajectory state for the No-U-Turn sampler. The
+     * workspace is sized from the number of parameters and the
+     * maximum tree depth so that building trajectories does not
+     * allocate once the sampler has been constructed.
+     */
+    class nuts_workspace {
+    public:
+      /**
+       * Construct a workspace for trees of up to the given depth.
+       *
+       * @param n number of parameters
+       * @param max_depth maximum tree depth
+       */
+      nuts_workspace(int n, int max_depth)
+        : z_plus(n), z_minus(n), z_sample(n), z_propose(n),
+          p_sharp_plus(n), p_sharp_minus(n), p_sharp_dummy(n),
+          rho(n), rho_subtree(n), n_(n) {
+        reserve_depth(max_depth);
+      }
+
+      /**
+       * Make sure there is a checkpoint for every level of subtrees of
+       * up to the given depth.  Growing the workspace moves the
+       * checkpoints, so this must not be called while a tree is being
+       * built.
+       *
+       * @param max_depth maximum tree depth
+       */
+      void reserve_depth(int max_depth) {
+        subtrees_.reserve(max_depth);
+        while (static_cast<int>(subtrees_.size()) < max_depth)
+          subtrees_.push_back(nuts_subtree_workspace(n_));
+      }
+
+      /**
+       * Return the checkpoint of the level building subtrees of the
+       * given depth, which must be at least one.
+       *
+       * @param depth depth of the subtree
+       * @return checkpoint of the level
+       */
+      nuts_subtree_workspace& subtree(int depth) {
+        reserve_depth(depth);
+        return subtrees_[depth - 1];
+      }
+
+      ps_point z_plus;
+      ps_point z_minus;
+      ps_point z_sample;
+      ps_point z_propose;
+
+      Eigen::VectorXd p_sharp_plus;
+      Eigen::VectorXd p_sharp_minus;
+      Eigen::VectorXd p_sharp_dummy;
+      Eigen::VectorXd rho;
+      Eigen::VectorXd rho_subtree;
+
+    private:
+      int n_;
+      std::vector<nuts_subtree_workspace> subtrees_;
+    };
+
+  }  // mcmc
+}  // stan
+#endif
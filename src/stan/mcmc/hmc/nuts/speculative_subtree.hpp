@@ -0,0 +1,90 @@
+#ifndef STAN_MCMC_HMC_NUTS_SPECULATIVE_SUBTREE_HPP
+#define STAN_MCMC_HMC_NUTS_SPECULATIVE_SUBTREE_HPP
+
+#include <atomic>
+#include <exception>
+#include <thread>
+
+namespace stan {
+  namespace mcmc {
+
+    /**
+     * Builds a NUTS subtree ahead of time on its own thread.  The
+     * subtree may turn out not to be needed, in which case it is
+     * abandoned by <code>cancel</code>; destroying a running
+     * speculation cancels it, so the thread is always joined.
+     */
+    class speculative_subtree {
+    public:
+      speculative_subtree() : running_(false), cancel_(false) {}
+
+      ~speculative_subtree() {
+        cancel();
+      }
+
+      /**
+       * Return true if a subtree has been launched and not yet
+       * joined or cancelled.
+       */
+      bool running() const {
+        return running_;
+      }
+
+      /**
+       * Start calling <code>build(cancel)</code> on a new thread.  The
+       * functor should return early once <code>cancel</code> becomes
+       * true.  No other subtree may be running.
+       *
+       * @tparam F type of functor with signature
+       *   <code>void(const std::atomic<bool>&)</code>
+       * @param[in] build functor building the subtree
+       */
+      template <class F>
+      void launch(const F& build) {
+        cancel_ = false;
+        error_ = std::exception_ptr();
+        thread_ = std::thread([this, build]() {
+            try {
+              build(cancel_);
+            } catch (...) {
+              error_ = std::current_exception();
+            }
+          });
+        running_ = true;
+      }
+
+      /**
+       * Wait for the running subtree to be complete, rethrowing any
+       * exception thrown while building it.
+       */
+      void join() {
+        if (!running_)
+          return;
+        thread_.join();
+        running_ = false;
+        if (error_)
+          std::rethrow_exception(error_);
+      }
+
+      /**
+       * Abandon the running subtree and wait for its thread.  Any
+       * exception thrown while building it is discarded.
+       */
+      void cancel() {
+        if (!running_)
+          return;
+        cancel_ = true;
+        thread_.join();
+        running_ = false;
+      }
+
+    private:
+      bool running_;
+      std::atomic<bool> cancel_;
+      std::exception_ptr error_;
+      std::thread thread_;
+    };
+
+  }  // mcmc
+}  // stan
+#endif
@@ -2,6 +2,7 @@
 #define STAN_MCMC_STEPSIZE_ADAPTATION_HPP
 
 #include <stan/mcmc/base_adaptation.hpp>
+#include <stan/mcmc/cross_chain_adaptation.hpp>
 #include <cmath>
 
 namespace stan {
@@ -83,8 +84,20 @@ namespace stan {
         epsilon = std::exp(x);
       }
 
+      /**
+       * Replaces <code>epsilon</code> with the step size shared by all
+       * chains when pooled across chains, otherwise leaves it as is.
+       *
+       * @param[in, out] epsilon step size
+       */
+      void pool_stepsize(double& epsilon) {
+        if (cross_chain_)
+          cross_chain_->pool_stepsize(chain_, epsilon);
+      }
+
       void complete_adaptation(double& epsilon) {
         epsilon = std::exp(x_bar_);
+        pool_stepsize(epsilon);
       }
 
     protected:
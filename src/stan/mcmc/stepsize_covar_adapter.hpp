@@ -24,6 +24,19 @@ namespace stan {
         return covar_adaptation_;
       }
 
+      /**
+       * Pools the step size and covariance adaptation with the other
+       * chains sharing <code>cross_chain</code>.
+       *
+       * @param[in] cross_chain pool shared by all chains
+       * @param[in] chain index of this chain in the pool
+       */
+      void set_cross_chain_adaptation(cross_chain_adaptation* cross_chain,
+                                      int chain) {
+        stepsize_adaptation_.set_cross_chain_adaptation(cross_chain, chain);
+        covar_adaptation_.set_cross_chain_adaptation(cross_chain, chain);
+      }
+
       void set_window_params(unsigned int num_warmup,
                              unsigned int init_buffer,
                              unsigned int term_buffer,
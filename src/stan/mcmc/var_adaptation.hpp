@@ -2,6 +2,7 @@
 #define STAN_MCMC_VAR_ADAPTATION_HPP
 
 #include <stan/math/prim/mat.hpp>
+#include <stan/mcmc/cross_chain_adaptation.hpp>
 #include <stan/mcmc/windowed_adaptation.hpp>
 #include <vector>
 
@@ -21,9 +22,12 @@ namespace stan {
         if (end_adaptation_window()) {
           compute_next_window();
 
-          estimator_.sample_variance(var);
-
           double n = static_cast<double>(estimator_.num_samples());
+          if (cross_chain_)
+            n = cross_chain_->pool_variance(chain_, estimator_, var);
+          else
+            estimator_.sample_variance(var);
+
           var = (n / (n + 5.0)) * var
                 + 1e-3 * (5.0 / (n + 5.0)) * Eigen::VectorXd::Ones(var.size());
 
@@ -5,6 +5,7 @@
 #include <stan/mcmc/base_adaptation.hpp>
 #include <ostream>
 #include <string>
+#include <vector>
 
 namespace stan {
   namespace mcmc {
@@ -110,6 +111,37 @@ namespace stan {
         }
       }
 
+      /**
+       * Return the number of warmup iterations in each stage of
+       * adaptation: the initial fast interval, each slow window in
+       * turn and the final fast interval.  Returns an empty vector if
+       * there are no slow windows.
+       *
+       * @return number of iterations in each stage
+       */
+      std::vector<unsigned int> stage_lengths() const {
+        windowed_adaptation schedule(*this);
+        schedule.restart();
+
+        std::vector<unsigned int> lengths;
+        unsigned int begin = 0;
+        for (unsigned int n = 0; n < num_warmup_; ++n) {
+          schedule.adapt_window_counter_ = n;
+          if (schedule.end_adaptation_window()) {
+            if (lengths.empty()) {
+              lengths.push_back(adapt_init_buffer_);
+              begin = adapt_init_buffer_;
+            }
+            lengths.push_back(n + 1 - begin);
+            begin = n + 1;
+            schedule.compute_next_window();
+          }
+        }
+        if (!lengths.empty())
+          lengths.push_back(num_warmup_ - begin);
+        return lengths;
+      }
+
     protected:
       std::string estimator_name_;
 
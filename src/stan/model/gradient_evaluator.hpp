@@ -0,0 +1,108 @@
+#ifndef STAN_MODEL_GRADIENT_EVALUATOR_HPP
+#define STAN_MODEL_GRADIENT_EVALUATOR_HPP
+
+#include <stan/callbacks/logger.hpp>
+#include <stan/math/rev/mat.hpp>
+#include <stan/model/gradient.hpp>
+#include <Eigen/Dense>
+#include <atomic>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+namespace stan {
+  namespace model {
+
+    /**
+     * Evaluates the log density of a model, with propto and the
+     * Jacobian adjustment, and its gradient by reverse-mode automatic
+     * differentiation, like <code>gradient</code>, for many points in
+     * turn.
+     *
+     * The autodiff arena already keeps its memory when it is
+     * recovered, so what <code>gradient</code> allocates on every call
+     * is the vector of input variables, the copy of it the model makes
+     * for an Eigen argument and the message stream.  The evaluator
+     * keeps these from one call to the next and passes the model a
+     * <code>std::vector</code> directly, so after the first call it
+     * allocates nothing outside of the model itself.
+     *
+     * The buffers are used by one call at a time.  A call made while
+     * another is in progress on a different thread, as when a
+     * speculative NUTS trajectory is built on a second thread, falls
+     * back to <code>gradient</code>.
+     *
+     * @tparam M type of model
+     */
+    template <class M>
+    class gradient_evaluator {
+    public:
+      /**
+       * Construct an evaluator for the specified model, which must
+       * outlive it.
+       *
+       * @param[in] model model
+       */
+      explicit gradient_evaluator(const M& model) : model_(model) {
+        in_use_.clear();
+      }
+
+      /**
+       * Return the log density at the specified unconstrained
+       * parameters and write its gradient.  Messages from the model
+       * are sent to the logger as info, also when it throws.
+       *
+       * @param[in] x unconstrained parameters
+       * @param[out] grad_f gradient of the log density
+       * @param[in,out] logger logger for messages
+       * @return log density
+       * @throws std::exception thrown by the model
+       */
+      double eval(const Eigen::Matrix<double, Eigen::Dynamic, 1>& x,
+                  Eigen::Matrix<double, Eigen::Dynamic, 1>& grad_f,
+                  callbacks::logger& logger) {
+        if (in_use_.test_and_set()) {
+          double f;
+          gradient(model_, x, f, grad_f, logger);
+          return f;
+        }
+        msgs_.str("");
+        msgs_.clear();
+        double f;
+        try {
+          params_r_.resize(x.size());
+          for (int i = 0; i < x.size(); ++i)
+            params_r_[i] = x(i);
+          stan::math::var lp
+            = model_.template log_prob<true, true>(params_r_, params_i_,
+                                                   &msgs_);
+          f = lp.val();
+          stan::math::grad(lp.vi_);
+          grad_f.resize(x.size());
+          for (int i = 0; i < x.size(); ++i)
+            grad_f(i) = params_r_[i].adj();
+        } catch (const std::exception& e) {
+          stan::math::recover_memory();
+          if (msgs_.str().length() > 0)
+            logger.info(msgs_);
+          in_use_.clear();
+          throw;
+        }
+        stan::math::recover_memory();
+        if (msgs_.str().length() > 0)
+          logger.info(msgs_);
+        in_use_.clear();
+        return f;
+      }
+
+    private:
+      const M& model_;
+      std::vector<stan::math::var> params_r_;
+      std::vector<int> params_i_;
+      std::stringstream msgs_;
+      std::atomic_flag in_use_;
+    };
+
+  }
+}
+#endif
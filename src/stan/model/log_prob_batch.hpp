@@ -0,0 +1,157 @@
+#ifndef STAN_MODEL_LOG_PROB_BATCH_HPP
+#define STAN_MODEL_LOG_PROB_BATCH_HPP
+
+#include <stan/math/rev/mat.hpp>
+#include <stan/model/model_functional.hpp>
+#include <stan/util/parallel_for.hpp>
+#include <Eigen/Dense>
+#include <exception>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <vector>
+
+namespace stan {
+  namespace model {
+
+    /**
+     * Compute the log probability at each of a batch of points.
+     *
+     * The points are evaluated concurrently on up to
+     * <code>STAN_NUM_THREADS</code> threads when compiled with
+     * <code>STAN_THREADS</code>, see
+     * <code>stan::util::get_num_autodiff_threads</code>, and one after
+     * the other otherwise.  This holds with and without
+     * <code>propto</code>: with it the log probability is computed
+     * with autodiff variables, as in <code>log_prob_propto</code>, and
+     * even with doubles a model may use nested autodiff, for instance
+     * in an algebraic solver or an ODE integrator.
+     *
+     * An exception thrown at a point is stored in
+     * <code>errors</code> and its log probability is set to NaN, so a
+     * failure at one point does not affect the others.  Messages from
+     * the model are written to <code>msgs</code> in the order of the
+     * points.  The results do not depend on the number of threads.
+     *
+     * @tparam propto True if calculation is up to proportion
+     * (double-only terms dropped).
+     * @tparam jacobian_adjust_transform True if the log absolute
+     * Jacobian determinant of inverse parameter transforms is added to
+     * the log probability.
+     * @tparam M Class of model.
+     * @param[in] model Model.
+     * @param[in] params_r Real-valued parameters with one point per
+     * column.
+     * @param[out] log_prob Log probability at each point.
+     * @param[out] errors Exception thrown at each point, or null.
+     * @param[in,out] msgs
+     */
+    template <bool propto, bool jacobian_adjust_transform, class M>
+    void log_prob_batch(const M& model,
+                        const Eigen::MatrixXd& params_r,
+                        Eigen::VectorXd& log_prob,
+                        std::vector<std::exception_ptr>& errors,
+                        std::ostream* msgs = 0) {
+      int num_points = params_r.cols();
+      log_prob.resize(num_points);
+      errors.assign(num_points, std::exception_ptr());
+      std::vector<std::stringstream> point_msgs(num_points);
+      stan::util::parallel_for(0, num_points, [&](size_t k) {
+          Eigen::VectorXd x = params_r.col(k);
+          try {
+            if (propto) {
+              model_functional<M, true, jacobian_adjust_transform>
+                f(model, &point_msgs[k]);
+              Eigen::Matrix<stan::math::var, Eigen::Dynamic, 1>
+                x_var(x.size());
+              for (int i = 0; i < x.size(); ++i)
+                x_var(i) = x(i);
+              try {
+                log_prob(k) = f(x_var).val();
+              } catch (const std::exception& e) {
+                stan::math::recover_memory();
+                throw;
+              }
+              stan::math::recover_memory();
+            } else {
+              log_prob(k) = model.template
+                log_prob<false, jacobian_adjust_transform>
+                (x, &point_msgs[k]);
+            }
+          } catch (...) {
+            log_prob(k) = std::numeric_limits<double>::quiet_NaN();
+            errors[k] = std::current_exception();
+          }
+        }, stan::util::get_num_autodiff_threads(num_points));
+      if (msgs)
+        for (int k = 0; k < num_points; ++k)
+          *msgs << point_msgs[k].str();
+    }
+
+    /**
+     * Compute the log probability and its gradient at each of a batch
+     * of points using reverse-mode automatic differentiation.
+     *
+     * The points are evaluated concurrently on up to
+     * <code>STAN_NUM_THREADS</code> threads when compiled with
+     * <code>STAN_THREADS</code>, see
+     * <code>stan::util::get_num_autodiff_threads</code>, and one after
+     * the other otherwise.
+     *
+     * An exception thrown at a point is stored in
+     * <code>errors</code> and its log probability and gradient are set
+     * to NaN, so a failure at one point does not affect the others.
+     * Messages from the model are written to <code>msgs</code> in the
+     * order of the points.  The results do not depend on the number
+     * of threads.
+     *
+     * @tparam propto True if calculation is up to proportion
+     * (double-only terms dropped).
+     * @tparam jacobian_adjust_transform True if the log absolute
+     * Jacobian determinant of inverse parameter transforms is added to
+     * the log probability.
+     * @tparam M Class of model.
+     * @param[in] model Model.
+     * @param[in] params_r Real-valued parameters with one point per
+     * column.
+     * @param[out] log_prob Log probability at each point.
+     * @param[out] gradient Gradient at each point, one per column.
+     * @param[out] errors Exception thrown at each point, or null.
+     * @param[in,out] msgs
+     */
+    template <bool propto, bool jacobian_adjust_transform, class M>
+    void log_prob_grad_batch(const M& model,
+                             const Eigen::MatrixXd& params_r,
+                             Eigen::VectorXd& log_prob,
+                             Eigen::MatrixXd& gradient,
+                             std::vector<std::exception_ptr>& errors,
+                             std::ostream* msgs = 0) {
+      int num_points = params_r.cols();
+      log_prob.resize(num_points);
+      gradient.resize(params_r.rows(), num_points);
+      errors.assign(num_points, std::exception_ptr());
+      std::vector<std::stringstream> point_msgs(num_points);
+      stan::util::parallel_for(0, num_points, [&](size_t k) {
+          Eigen::VectorXd x = params_r.col(k);
+          Eigen::VectorXd grad;
+          try {
+            stan::math::gradient(model_functional<M, propto,
+                                 jacobian_adjust_transform>
+                                 (model, &point_msgs[k]),
+                                 x, log_prob(k), grad);
+            gradient.col(k) = grad;
+          } catch (...) {
+            log_prob(k) = std::numeric_limits<double>::quiet_NaN();
+            gradient.col(k).setConstant(
+                std::numeric_limits<double>::quiet_NaN());
+            errors[k] = std::current_exception();
+          }
+        }, stan::util::get_num_autodiff_threads(num_points));
+      if (msgs)
+        for (int k = 0; k < num_points; ++k)
+          *msgs << point_msgs[k].str();
+    }
+
+  }
+}
+#endif
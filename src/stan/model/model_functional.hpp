@@ -8,7 +8,8 @@ namespace stan {
   namespace model {
 
     // Interface for automatic differentiation of models
-    template <class M>
+    template <class M, bool propto = true,
+              bool jacobian_adjust_transform = true>
     struct model_functional {
       const M& model;
       std::ostream* o;
@@ -20,7 +21,8 @@ namespace stan {
       T operator()(const Eigen::Matrix<T, Eigen::Dynamic, 1>& x) const {
         // log_prob() requires non-const but doesn't modify its argument
         return model.template
-          log_prob<true, true, T>(const_cast<Eigen::Matrix<T, -1, 1>& >(x), o);
+          log_prob<propto, jacobian_adjust_transform, T>
+          (const_cast<Eigen::Matrix<T, -1, 1>& >(x), o);
       }
     };
 
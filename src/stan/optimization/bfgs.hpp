@@ -290,7 +290,16 @@ namespace stan {
       }
     };
 
-    template <class M>
+    /**
+     * Adapts a model to the negated log density and gradient
+     * functor used by <code>BFGSMinimizer</code>.
+     *
+     * @tparam M type of model
+     * @tparam jacobian true if the log absolute Jacobian determinant
+     * of the inverse parameter transforms is included, as it is when
+     * sampling; false for the posterior mode
+     */
+    template <class M, bool jacobian = false>
     class ModelAdaptor {
     private:
       M& _model;
@@ -319,7 +328,7 @@ namespace stan {
           _x[i] = x[i];
 
         try {
-          f = - log_prob_propto<false>(_model, _x, _params_i, _msgs);
+          f = - log_prob_propto<jacobian>(_model, _x, _params_i, _msgs);
         } catch (const std::exception& e) {
           if (_msgs)
             (*_msgs) << e.what() << std::endl;
@@ -351,7 +360,8 @@ namespace stan {
         _fevals++;
 
         try {
-          f = - log_prob_grad<true, false>(_model, _x, _params_i, _g, _msgs);
+          f = - log_prob_grad<true, jacobian>(_model, _x, _params_i, _g,
+                                              _msgs);
         } catch (const std::exception& e) {
           if (_msgs)
             (*_msgs) << e.what() << std::endl;
@@ -387,15 +397,16 @@ namespace stan {
     };
 
     template<typename M, typename QNUpdateType, typename Scalar = double,
-             int DimAtCompile = Eigen::Dynamic>
+             int DimAtCompile = Eigen::Dynamic, bool jacobian = false>
     class BFGSLineSearch
-      : public BFGSMinimizer<ModelAdaptor<M>, QNUpdateType,
+      : public BFGSMinimizer<ModelAdaptor<M, jacobian>, QNUpdateType,
                              Scalar, DimAtCompile> {
     private:
-      ModelAdaptor<M> _adaptor;
+      ModelAdaptor<M, jacobian> _adaptor;
 
     public:
-      typedef BFGSMinimizer<ModelAdaptor<M>, QNUpdateType, Scalar, DimAtCompile>
+      typedef BFGSMinimizer<ModelAdaptor<M, jacobian>, QNUpdateType, Scalar,
+                            DimAtCompile>
       BFGSBase;
       typedef typename BFGSBase::VectorT vector_t;
       typedef typename stan::math::index_type<vector_t>::type idx_t;
@@ -108,6 +108,43 @@ namespace stan {
         }
       }
 
+      /**
+       * Compute the diagonal of the current inverse Hessian
+       * approximation, the matrix applied by
+       * <code>search_direction</code>, without forming it.  This uses
+       * the compact representation of Byrd, Nocedal and Schnabel
+       * (1994) and takes O(n L^2) operations for n dimensions and L
+       * updates.  With no updates the diagonal is all ones.
+       *
+       * @param[out] dk Diagonal of the inverse Hessian approximation.
+       * @param[in] n Number of dimensions.
+       **/
+      inline void inv_hessian_diagonal(VectorT &dk, int n) const {
+        typedef Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic>
+          MatrixT;
+        int L = _buf.size();
+        if (L == 0) {
+          dk.setOnes(n);
+          return;
+        }
+        MatrixT S(n, L), Y(n, L);
+        for (int i = 0; i < L; i++) {
+          Y.col(i) = boost::get<1>(_buf[i]);
+          S.col(i) = boost::get<2>(_buf[i]);
+        }
+        // R is upper triangular with R(i, j) = s_i' y_j for i <= j
+        MatrixT StY = S.transpose() * Y;
+        MatrixT R = StY.template triangularView<Eigen::Upper>();
+        MatrixT C = _gammak * (Y.transpose() * Y);
+        C.diagonal() += StY.diagonal();
+        // row k of Z is the transpose of R^{-1} times row k of S
+        MatrixT Z = R.template triangularView<Eigen::Upper>()
+          .solve(S.transpose()).transpose();
+        dk = ((Z * C).cwiseProduct(Z)).rowwise().sum()
+          - 2 * _gammak * Z.cwiseProduct(Y).rowwise().sum();
+        dk.array() += _gammak;
+      }
+
     protected:
       boost::circular_buffer<UpdateT> _buf;
       Scalar _gammak;
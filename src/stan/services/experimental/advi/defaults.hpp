@@ -188,6 +188,45 @@ namespace stan {
           }
         };
 
+        /**
+         * Optimizer for stochastic gradient ascent.
+         */
+        struct optimizer {
+          /**
+           * Return the string description of optimizer.
+           *
+           * @return description
+           */
+          static std::string description() {
+            return "Optimizer for stochastic gradient ascent:"
+              " sequence, adam, amsgrad or rmsprop.";
+          }
+
+          /**
+           * Validates optimizer; must be one of sequence, adam, amsgrad
+           * or rmsprop.
+           *
+           * @param[in] optimizer argument to validate
+           * @throw std::invalid_argument unless optimizer is one of
+           *   sequence, adam, amsgrad or rmsprop
+           */
+          static void validate(const std::string& optimizer) {
+            if (!(optimizer == "sequence" || optimizer == "adam"
+                  || optimizer == "amsgrad" || optimizer == "rmsprop"))
+              throw std::invalid_argument("optimizer must be sequence,"
+                                          " adam, amsgrad or rmsprop.");
+          }
+
+          /**
+           * Return the default optimizer.
+           *
+           * @return sequence
+           */
+          static std::string default_value() {
+            return "sequence";
+          }
+        };
+
         /**
          * Flag for eta adaptation.
          */
@@ -4,11 +4,12 @@
 #include <stan/callbacks/interrupt.hpp>
 #include <stan/callbacks/logger.hpp>
 #include <stan/callbacks/writer.hpp>
+#include <stan/services/experimental/advi/defaults.hpp>
 #include <stan/services/util/experimental_message.hpp>
 #include <stan/services/util/initialize.hpp>
 #include <stan/services/util/create_rng.hpp>
+#include <stan/services/util/run_advi.hpp>
 #include <stan/io/var_context.hpp>
-#include <stan/variational/advi.hpp>
 #include <boost/random/additive_combine.hpp>
 #include <string>
 #include <vector>
@@ -35,6 +36,8 @@ namespace stan {
          * @param[in] tol_rel_obj convergence tolerance on the relative norm
          *   of the objective
          * @param[in] eta stepsize scaling parameter for variational inference
+         * @param[in] optimizer optimizer for stochastic gradient ascent:
+         *   sequence, adam, amsgrad or rmsprop
          * @param[in] adapt_engaged adaptation engaged?
          * @param[in] adapt_iterations number of iterations for eta adaptation
          * @param[in] eval_elbo evaluate ELBO every Nth iteration
@@ -45,6 +48,7 @@ namespace stan {
          * @param[in,out] init_writer Writer callback for unconstrained inits
          * @param[in,out] parameter_writer output for parameter values
          * @param[in,out] diagnostic_writer output for diagnostic values
+         * @throw std::invalid_argument if the optimizer is not known
          * @return error_codes::OK if successful
          */
         template <class Model>
@@ -52,6 +56,7 @@ namespace stan {
                       unsigned int random_seed, unsigned int chain,
                       double init_radius, int grad_samples, int elbo_samples,
                       int max_iterations, double tol_rel_obj, double eta,
+                      const std::string& optimizer,
                       bool adapt_engaged, int adapt_iterations, int eval_elbo,
                       int output_samples,
                       callbacks::interrupt& interrupt,
@@ -59,6 +64,7 @@ namespace stan {
                       callbacks::writer& init_writer,
                       callbacks::writer& parameter_writer,
                       callbacks::writer& diagnostic_writer) {
+          optimizer::validate(optimizer);
           util::experimental_message(logger);
 
           boost::ecuyer1988 rng = util::create_rng(random_seed, chain);
@@ -77,17 +83,63 @@ namespace stan {
             = Eigen::Map<Eigen::VectorXd>(&cont_vector[0],
                                           cont_vector.size(), 1);
 
-          stan::variational::advi<Model,
-                                  stan::variational::normal_meanfield,
-                                  boost::ecuyer1988>
-            cmd_advi(model, cont_params, rng, grad_samples,
-                     elbo_samples, eval_elbo, output_samples);
-          cmd_advi.run(eta, adapt_engaged, adapt_iterations,
-                       tol_rel_obj, max_iterations,
-                       logger, parameter_writer, diagnostic_writer);
+          util::run_advi<stan::variational::normal_meanfield>
+            (model, cont_params, rng, optimizer, grad_samples, elbo_samples,
+             max_iterations, tol_rel_obj, eta, adapt_engaged,
+             adapt_iterations, eval_elbo, output_samples,
+             logger, parameter_writer, diagnostic_writer);
 
           return 0;
         }
+
+        /**
+         * Runs mean field ADVI with the adaptive step-size sequence.
+         *
+         * @tparam Model A model implementation
+         * @param[in] model Input model to test (with data already instantiated)
+         * @param[in] init var context for initialization
+         * @param[in] random_seed random seed for the random number generator
+         * @param[in] chain chain id to advance the random number generator
+         * @param[in] init_radius radius to initialize
+         * @param[in] grad_samples number of samples for Monte Carlo estimate
+         *   of gradients
+         * @param[in] elbo_samples number of samples for Monte Carlo estimate
+         *   of ELBO
+         * @param[in] max_iterations maximum number of iterations
+         * @param[in] tol_rel_obj convergence tolerance on the relative norm
+         *   of the objective
+         * @param[in] eta stepsize scaling parameter for variational inference
+         * @param[in] adapt_engaged adaptation engaged?
+         * @param[in] adapt_iterations number of iterations for eta adaptation
+         * @param[in] eval_elbo evaluate ELBO every Nth iteration
+         * @param[in] output_samples number of posterior samples to draw and
+         *   save
+         * @param[in,out] interrupt callback to be called every iteration
+         * @param[in,out] logger Logger for messages
+         * @param[in,out] init_writer Writer callback for unconstrained inits
+         * @param[in,out] parameter_writer output for parameter values
+         * @param[in,out] diagnostic_writer output for diagnostic values
+         * @return error_codes::OK if successful
+         */
+        template <class Model>
+        int meanfield(Model& model, stan::io::var_context& init,
+                      unsigned int random_seed, unsigned int chain,
+                      double init_radius, int grad_samples, int elbo_samples,
+                      int max_iterations, double tol_rel_obj, double eta,
+                      bool adapt_engaged, int adapt_iterations, int eval_elbo,
+                      int output_samples,
+                      callbacks::interrupt& interrupt,
+                      callbacks::logger& logger,
+                      callbacks::writer& init_writer,
+                      callbacks::writer& parameter_writer,
+                      callbacks::writer& diagnostic_writer) {
+          return meanfield(model, init, random_seed, chain, init_radius,
+                           grad_samples, elbo_samples, max_iterations,
+                           tol_rel_obj, eta, optimizer::default_value(),
+                           adapt_engaged, adapt_iterations, eval_elbo,
+                           output_samples, interrupt, logger, init_writer,
+                           parameter_writer, diagnostic_writer);
+        }
       }
     }
   }
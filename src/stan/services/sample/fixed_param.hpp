@@ -11,6 +11,7 @@
 #include <stan/services/util/generate_transitions.hpp>
 #include <stan/services/util/create_rng.hpp>
 #include <stan/services/util/initialize.hpp>
+#include <stan/services/util/sampler_timer.hpp>
 #include <vector>
 
 namespace stan {
@@ -53,6 +54,8 @@ namespace stan {
         boost::ecuyer1988 rng = util::create_rng(random_seed, chain);
 
         std::vector<int> disc_vector;
+        util::sampler_timer timer;
+        timer.begin("init");
         std::vector<double> cont_vector
           = util::initialize(model, init, rng, init_radius, false,
                              logger, init_writer);
@@ -69,15 +72,14 @@ namespace stan {
         writer.write_sample_names(s, sampler, model);
         writer.write_diagnostic_names(s, sampler, model);
 
-        clock_t start = clock();
-
+        timer.begin("sampling", sampler);
         util::generate_transitions(sampler, num_samples, 0, num_samples,
                                    num_thin, refresh, true, false, writer,
-                                   s, model, rng, interrupt, logger);
-        clock_t end = clock();
+                                   s, model, rng, interrupt, logger, &timer);
+        timer.end(sampler);
 
-        double sampleDeltaT = static_cast<double>(end - start) / CLOCKS_PER_SEC;
-        writer.write_timing(0.0, sampleDeltaT);
+        writer.write_timing(0.0, timer.phases().back().wall_time);
+        writer.write_phase_timing(timer.phases());
 
         return error_codes::OK;
       }
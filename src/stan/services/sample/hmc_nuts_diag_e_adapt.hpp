@@ -6,13 +6,18 @@
 #include <stan/callbacks/interrupt.hpp>
 #include <stan/callbacks/logger.hpp>
 #include <stan/callbacks/writer.hpp>
+#include <stan/analyze/mcmc/online_diagnostics.hpp>
 #include <stan/mcmc/fixed_param_sampler.hpp>
 #include <stan/services/error_codes.hpp>
 #include <stan/mcmc/hmc/nuts/adapt_diag_e_nuts.hpp>
 #include <stan/services/util/run_adaptive_sampler.hpp>
+#include <stan/services/util/run_chains.hpp>
+#include <stan/services/util/convergence_monitor.hpp>
 #include <stan/services/util/create_rng.hpp>
 #include <stan/services/util/initialize.hpp>
+#include <stan/services/util/sampler_timer.hpp>
 #include <stan/services/util/inv_metric.hpp>
+#include <memory>
 #include <vector>
 
 namespace stan {
@@ -51,6 +56,8 @@ namespace stan {
        * @param[in,out] init_writer Writer callback for unconstrained inits
        * @param[in,out] sample_writer Writer for draws
        * @param[in,out] diagnostic_writer Writer for diagnostic information
+       * @param[in,out] monitor if not null, monitor of the post warmup
+       *   draws which may stop sampling early
        * @return error_codes::OK if successful
        */
       template <class Model>
@@ -68,10 +75,13 @@ namespace stan {
                                 callbacks::logger& logger,
                                 callbacks::writer& init_writer,
                                 callbacks::writer& sample_writer,
-                                callbacks::writer& diagnostic_writer) {
+                                callbacks::writer& diagnostic_writer,
+                                util::convergence_monitor* monitor = 0) {
         boost::ecuyer1988 rng = util::create_rng(random_seed, chain);
 
         std::vector<int> disc_vector;
+        util::sampler_timer timer;
+        timer.begin("init");
         std::vector<double> cont_vector
           = util::initialize(model, init, rng, init_radius, true,
                              logger, init_writer);
@@ -106,7 +116,8 @@ namespace stan {
         util::run_adaptive_sampler(sampler, model, cont_vector, num_warmup,
                                    num_samples, num_thin, refresh, save_warmup,
                                    rng, interrupt, logger,
-                                   sample_writer, diagnostic_writer);
+                                   sample_writer, diagnostic_writer, timer,
+                                   monitor);
 
         return error_codes::OK;
       }
@@ -173,6 +184,204 @@ namespace stan {
                                      diagnostic_writer);
       }
 
+      /**
+       * Runs multiple chains of HMC with NUTS with adaptation using
+       * diagonal Euclidean metric with a pre-specified Euclidean
+       * metric for each chain.
+       *
+       * The chains share the model and its data. Chain
+       * <code>n</code> uses the random number generator for chain id
+       * <code>init_chain_id + n</code>, so its draws are identical to
+       * those of a single chain run with that chain id. When compiled
+       * with <code>STAN_THREADS</code> the chains run concurrently on
+       * <code>STAN_NUM_THREADS</code> threads, in which case the
+       * interrupt and logger must be safe to call from several
+       * threads.
+       *
+       * @tparam Model Model class
+       * @param[in] model Input model to test (with data already instantiated)
+       * @param[in] num_chains Number of chains
+       * @param[in] init var context for initialization of each chain
+       * @param[in] init_inv_metric var context exposing an initial diagonal
+                    inverse Euclidean metric for each chain (must be
+                    positive definite)
+       * @param[in] random_seed random seed for the random number generator
+       * @param[in] init_chain_id chain id of the first chain
+       * @param[in] init_radius radius to initialize
+       * @param[in] num_warmup Number of warmup samples
+       * @param[in] num_samples Number of samples
+       * @param[in] num_thin Number to thin the samples
+       * @param[in] save_warmup Indicates whether to save the warmup iterations
+       * @param[in] refresh Controls the output
+       * @param[in] stepsize initial stepsize for discrete evolution
+       * @param[in] stepsize_jitter uniform random jitter of stepsize
+       * @param[in] max_depth Maximum tree depth
+       * @param[in] delta adaptation target acceptance statistic
+       * @param[in] gamma adaptation regularization scale
+       * @param[in] kappa adaptation relaxation exponent
+       * @param[in] t0 adaptation iteration offset
+       * @param[in] init_buffer width of initial fast adaptation interval
+       * @param[in] term_buffer width of final fast adaptation interval
+       * @param[in] window initial width of slow adaptation interval
+       * @param[in,out] interrupt Callback for interrupts
+       * @param[in,out] logger Logger for messages
+       * @param[in,out] init_writer Writer callback for unconstrained inits
+       *   of each chain
+       * @param[in,out] sample_writer Writer for draws of each chain
+       * @param[in,out] diagnostic_writer Writer for diagnostic information
+       *   of each chain
+       * @param[in] min_ess if positive, sampling stops early once the
+       *   effective sample size of the log density and of every
+       *   unconstrained parameter is at least min_ess.  Sampling can
+       *   only stop once every chain has enough draws, so when the
+       *   chains run one after the other the first always runs to
+       *   completion.
+       * @param[in] max_rhat maximum split R hat of the log density and
+       *   of every unconstrained parameter for sampling to stop early;
+       *   must be at least 1 if min_ess is positive
+       * @return error_codes::OK if successful
+       */
+      template <class Model>
+      int hmc_nuts_diag_e_adapt(Model& model, size_t num_chains,
+                                const std::vector<stan::io::var_context*>& init,
+                                const std::vector<stan::io::var_context*>&
+                                init_inv_metric,
+                                unsigned int random_seed,
+                                unsigned int init_chain_id,
+                                double init_radius, int num_warmup,
+                                int num_samples, int num_thin, bool save_warmup,
+                                int refresh, double stepsize,
+                                double stepsize_jitter, int max_depth,
+                                double delta, double gamma, double kappa,
+                                double t0, unsigned int init_buffer,
+                                unsigned int term_buffer, unsigned int window,
+                                callbacks::interrupt& interrupt,
+                                callbacks::logger& logger,
+                                const std::vector<callbacks::writer*>&
+                                init_writer,
+                                const std::vector<callbacks::writer*>&
+                                sample_writer,
+                                const std::vector<callbacks::writer*>&
+                                diagnostic_writer,
+                                double min_ess = 0, double max_rhat = 1.01) {
+        if (init.size() != num_chains || init_inv_metric.size() != num_chains
+            || init_writer.size() != num_chains
+            || sample_writer.size() != num_chains
+            || diagnostic_writer.size() != num_chains) {
+          logger.error("Expecting one init, inverse metric and set of "
+                       "writers per chain.");
+          return error_codes::CONFIG;
+        }
+        if (min_ess > 0 && !(max_rhat >= 1)) {
+          logger.error("max_rhat must be at least 1 for sampling to stop "
+                       "early.");
+          return error_codes::CONFIG;
+        }
+        std::unique_ptr<analyze::online_diagnostics> diagnostics;
+        if (min_ess > 0)
+          diagnostics.reset(new analyze::online_diagnostics(
+              num_chains, model.num_params_r() + 1));
+        return util::run_chains(num_chains, [&](size_t n) {
+            std::unique_ptr<util::convergence_monitor> monitor;
+            if (diagnostics)
+              monitor.reset(new util::convergence_monitor(
+                  *diagnostics, n, min_ess, max_rhat,
+                  refresh > 0 ? refresh : 100));
+            return hmc_nuts_diag_e_adapt(model, *init[n], *init_inv_metric[n],
+                                         random_seed, init_chain_id + n,
+                                         init_radius, num_warmup, num_samples,
+                                         num_thin, save_warmup, refresh,
+                                         stepsize, stepsize_jitter, max_depth,
+                                         delta, gamma, kappa, t0,
+                                         init_buffer, term_buffer, window,
+                                         interrupt, logger, *init_writer[n],
+                                         *sample_writer[n],
+                                         *diagnostic_writer[n], monitor.get());
+          });
+      }
+
+      /**
+       * Runs multiple chains of HMC with NUTS with adaptation using
+       * diagonal Euclidean metric. See the overload taking an initial
+       * inverse metric per chain for how the chains are run.
+       *
+       * @tparam Model Model class
+       * @param[in] model Input model to test (with data already instantiated)
+       * @param[in] num_chains Number of chains
+       * @param[in] init var context for initialization of each chain
+       * @param[in] random_seed random seed for the random number generator
+       * @param[in] init_chain_id chain id of the first chain
+       * @param[in] init_radius radius to initialize
+       * @param[in] num_warmup Number of warmup samples
+       * @param[in] num_samples Number of samples
+       * @param[in] num_thin Number to thin the samples
+       * @param[in] save_warmup Indicates whether to save the warmup iterations
+       * @param[in] refresh Controls the output
+       * @param[in] stepsize initial stepsize for discrete evolution
+       * @param[in] stepsize_jitter uniform random jitter of stepsize
+       * @param[in] max_depth Maximum tree depth
+       * @param[in] delta adaptation target acceptance statistic
+       * @param[in] gamma adaptation regularization scale
+       * @param[in] kappa adaptation relaxation exponent
+       * @param[in] t0 adaptation iteration offset
+       * @param[in] init_buffer width of initial fast adaptation interval
+       * @param[in] term_buffer width of final fast adaptation interval
+       * @param[in] window initial width of slow adaptation interval
+       * @param[in,out] interrupt Callback for interrupts
+       * @param[in,out] logger Logger for messages
+       * @param[in,out] init_writer Writer callback for unconstrained inits
+       *   of each chain
+       * @param[in,out] sample_writer Writer for draws of each chain
+       * @param[in,out] diagnostic_writer Writer for diagnostic information
+       *   of each chain
+       * @param[in] min_ess if positive, sampling stops early once the
+       *   effective sample size of the log density and of every
+       *   unconstrained parameter is at least min_ess.  Sampling can
+       *   only stop once every chain has enough draws, so when the
+       *   chains run one after the other the first always runs to
+       *   completion.
+       * @param[in] max_rhat maximum split R hat of the log density and
+       *   of every unconstrained parameter for sampling to stop early;
+       *   must be at least 1 if min_ess is positive
+       * @return error_codes::OK if successful
+       */
+      template <class Model>
+      int hmc_nuts_diag_e_adapt(Model& model, size_t num_chains,
+                                const std::vector<stan::io::var_context*>& init,
+                                unsigned int random_seed,
+                                unsigned int init_chain_id,
+                                double init_radius, int num_warmup,
+                                int num_samples, int num_thin, bool save_warmup,
+                                int refresh, double stepsize,
+                                double stepsize_jitter, int max_depth,
+                                double delta, double gamma, double kappa,
+                                double t0, unsigned int init_buffer,
+                                unsigned int term_buffer, unsigned int window,
+                                callbacks::interrupt& interrupt,
+                                callbacks::logger& logger,
+                                const std::vector<callbacks::writer*>&
+                                init_writer,
+                                const std::vector<callbacks::writer*>&
+                                sample_writer,
+                                const std::vector<callbacks::writer*>&
+                                diagnostic_writer,
+                                double min_ess = 0, double max_rhat = 1.01) {
+        stan::io::dump dmp =
+          util::create_unit_e_diag_inv_metric(model.num_params_r());
+        std::vector<stan::io::var_context*> unit_e_metric(num_chains, &dmp);
+
+        return hmc_nuts_diag_e_adapt(model, num_chains, init, unit_e_metric,
+                                     random_seed, init_chain_id, init_radius,
+                                     num_warmup, num_samples, num_thin,
+                                     save_warmup, refresh,
+                                     stepsize, stepsize_jitter, max_depth,
+                                     delta, gamma, kappa, t0,
+                                     init_buffer, term_buffer, window,
+                                     interrupt, logger,
+                                     init_writer, sample_writer,
+                                     diagnostic_writer, min_ess, max_rhat);
+      }
+
     }
   }
 }
@@ -0,0 +1,237 @@
+#ifndef STAN_SERVICES_SAMPLE_HMC_NUTS_DIAG_E_POOLED_ADAPT_HPP
+#define STAN_SERVICES_SAMPLE_HMC_NUTS_DIAG_E_POOLED_ADAPT_HPP
+
+#include <stan/math/prim/mat/fun/Eigen.hpp>
+#include <stan/math/prim/mat.hpp>
+#include <stan/callbacks/interrupt.hpp>
+#include <stan/callbacks/logger.hpp>
+#include <stan/callbacks/writer.hpp>
+#include <stan/io/var_context.hpp>
+#include <stan/mcmc/cross_chain_adaptation.hpp>
+#include <stan/services/error_codes.hpp>
+#include <stan/mcmc/hmc/nuts/adapt_diag_e_nuts.hpp>
+#include <stan/services/util/run_adaptive_sampler.hpp>
+#include <stan/services/util/run_chains.hpp>
+#include <stan/services/util/create_rng.hpp>
+#include <stan/services/util/initialize.hpp>
+#include <stan/services/util/sampler_timer.hpp>
+#include <stan/services/util/inv_metric.hpp>
+#include <vector>
+
+namespace stan {
+  namespace services {
+    namespace sample {
+
+      /**
+       * Runs multiple chains of HMC with NUTS with adaptation using
+       * diagonal Euclidean metric, pooling the warmup adaptation
+       * across chains.
+       *
+       * At the end of each slow adaptation window the chains combine
+       * their variance estimators into a single estimate computed
+       * from the draws of all chains, and all chains continue with
+       * that metric. The step sizes found after each metric update
+       * and at the end of warmup are replaced by their geometric mean
+       * over chains, so all chains sample with the same metric and
+       * step size.
+       *
+       * The chains wait for each other at the end of each window, so
+       * each chain runs on its own thread. This requires compiling with
+       * <code>STAN_THREADS</code>; otherwise error_codes::CONFIG is
+       * returned. The interrupt and logger must be safe to call from
+       * several threads.
+       *
+       * @tparam Model Model class
+       * @param[in] model Input model to test (with data already instantiated)
+       * @param[in] num_chains Number of chains
+       * @param[in] init var context for initialization of each chain
+       * @param[in] init_inv_metric var context exposing an initial diagonal
+                    inverse Euclidean metric for each chain (must be
+                    positive definite)
+       * @param[in] random_seed random seed for the random number generator
+       * @param[in] init_chain_id chain id of the first chain
+       * @param[in] init_radius radius to initialize
+       * @param[in] num_warmup Number of warmup samples
+       * @param[in] num_samples Number of samples
+       * @param[in] num_thin Number to thin the samples
+       * @param[in] save_warmup Indicates whether to save the warmup iterations
+       * @param[in] refresh Controls the output
+       * @param[in] stepsize initial stepsize for discrete evolution
+       * @param[in] stepsize_jitter uniform random jitter of stepsize
+       * @param[in] max_depth Maximum tree depth
+       * @param[in] delta adaptation target acceptance statistic
+       * @param[in] gamma adaptation regularization scale
+       * @param[in] kappa adaptation relaxation exponent
+       * @param[in] t0 adaptation iteration offset
+       * @param[in] init_buffer width of initial fast adaptation interval
+       * @param[in] term_buffer width of final fast adaptation interval
+       * @param[in] window initial width of slow adaptation interval
+       * @param[in,out] interrupt Callback for interrupts
+       * @param[in,out] logger Logger for messages
+       * @param[in,out] init_writer Writer callback for unconstrained inits
+       *   of each chain
+       * @param[in,out] sample_writer Writer for draws of each chain
+       * @param[in,out] diagnostic_writer Writer for diagnostic information
+       *   of each chain
+       * @return error_codes::OK if successful
+       */
+      template <class Model>
+      int hmc_nuts_diag_e_pooled_adapt(
+          Model& model, size_t num_chains,
+          const std::vector<stan::io::var_context*>& init,
+          const std::vector<stan::io::var_context*>& init_inv_metric,
+          unsigned int random_seed, unsigned int init_chain_id,
+          double init_radius, int num_warmup, int num_samples, int num_thin,
+          bool save_warmup, int refresh, double stepsize,
+          double stepsize_jitter, int max_depth, double delta, double gamma,
+          double kappa, double t0, unsigned int init_buffer,
+          unsigned int term_buffer, unsigned int window,
+          callbacks::interrupt& interrupt, callbacks::logger& logger,
+          const std::vector<callbacks::writer*>& init_writer,
+          const std::vector<callbacks::writer*>& sample_writer,
+          const std::vector<callbacks::writer*>& diagnostic_writer) {
+        if (init.size() != num_chains || init_inv_metric.size() != num_chains
+            || init_writer.size() != num_chains
+            || sample_writer.size() != num_chains
+            || diagnostic_writer.size() != num_chains) {
+          logger.error("Expecting one init, inverse metric and set of "
+                       "writers per chain.");
+          return error_codes::CONFIG;
+        }
+#ifndef STAN_THREADS
+        if (num_chains > 1) {
+          logger.error("Pooled adaptation runs the chains concurrently "
+                       "and requires STAN_THREADS.");
+          return error_codes::CONFIG;
+        }
+#endif
+
+        stan::mcmc::cross_chain_adaptation cross_chain(num_chains);
+
+        return util::run_chains(num_chains, [&](size_t n) {
+            try {
+              boost::ecuyer1988 rng
+                = util::create_rng(random_seed, init_chain_id + n);
+
+              util::sampler_timer timer;
+              timer.begin("init");
+              std::vector<double> cont_vector
+                = util::initialize(model, *init[n], rng, init_radius, true,
+                                   logger, *init_writer[n]);
+
+              Eigen::VectorXd inv_metric;
+              try {
+                inv_metric =
+                  util::read_diag_inv_metric(*init_inv_metric[n],
+                                             model.num_params_r(), logger);
+                util::validate_diag_inv_metric(inv_metric, logger);
+              } catch (const std::domain_error& e) {
+                cross_chain.leave(n);
+                return static_cast<int>(error_codes::CONFIG);
+              }
+
+              stan::mcmc::adapt_diag_e_nuts<Model, boost::ecuyer1988>
+                sampler(model, rng);
+
+              sampler.set_metric(inv_metric);
+              sampler.set_nominal_stepsize(stepsize);
+              sampler.set_stepsize_jitter(stepsize_jitter);
+              sampler.set_max_depth(max_depth);
+
+              sampler.get_stepsize_adaptation().set_mu(log(10 * stepsize));
+              sampler.get_stepsize_adaptation().set_delta(delta);
+              sampler.get_stepsize_adaptation().set_gamma(gamma);
+              sampler.get_stepsize_adaptation().set_kappa(kappa);
+              sampler.get_stepsize_adaptation().set_t0(t0);
+
+              sampler.set_window_params(num_warmup, init_buffer, term_buffer,
+                                        window, logger);
+              sampler.set_cross_chain_adaptation(&cross_chain, n);
+
+              util::run_adaptive_sampler(sampler, model, cont_vector,
+                                         num_warmup, num_samples, num_thin,
+                                         refresh, save_warmup, rng,
+                                         interrupt, logger,
+                                         *sample_writer[n],
+                                         *diagnostic_writer[n], timer);
+            } catch (...) {
+              cross_chain.leave(n);
+              throw;
+            }
+            cross_chain.leave(n);
+            return static_cast<int>(error_codes::OK);
+          }, num_chains);
+      }
+
+      /**
+       * Runs multiple chains of HMC with NUTS with adaptation using
+       * diagonal Euclidean metric, pooling the warmup adaptation
+       * across chains. See the overload taking an initial inverse
+       * metric per chain for how the adaptation is pooled.
+       *
+       * @tparam Model Model class
+       * @param[in] model Input model to test (with data already instantiated)
+       * @param[in] num_chains Number of chains
+       * @param[in] init var context for initialization of each chain
+       * @param[in] random_seed random seed for the random number generator
+       * @param[in] init_chain_id chain id of the first chain
+       * @param[in] init_radius radius to initialize
+       * @param[in] num_warmup Number of warmup samples
+       * @param[in] num_samples Number of samples
+       * @param[in] num_thin Number to thin the samples
+       * @param[in] save_warmup Indicates whether to save the warmup iterations
+       * @param[in] refresh Controls the output
+       * @param[in] stepsize initial stepsize for discrete evolution
+       * @param[in] stepsize_jitter uniform random jitter of stepsize
+       * @param[in] max_depth Maximum tree depth
+       * @param[in] delta adaptation target acceptance statistic
+       * @param[in] gamma adaptation regularization scale
+       * @param[in] kappa adaptation relaxation exponent
+       * @param[in] t0 adaptation iteration offset
+       * @param[in] init_buffer width of initial fast adaptation interval
+       * @param[in] term_buffer width of final fast adaptation interval
+       * @param[in] window initial width of slow adaptation interval
+       * @param[in,out] interrupt Callback for interrupts
+       * @param[in,out] logger Logger for messages
+       * @param[in,out] init_writer Writer callback for unconstrained inits
+       *   of each chain
+       * @param[in,out] sample_writer Writer for draws of each chain
+       * @param[in,out] diagnostic_writer Writer for diagnostic information
+       *   of each chain
+       * @return error_codes::OK if successful
+       */
+      template <class Model>
+      int hmc_nuts_diag_e_pooled_adapt(
+          Model& model, size_t num_chains,
+          const std::vector<stan::io::var_context*>& init,
+          unsigned int random_seed, unsigned int init_chain_id,
+          double init_radius, int num_warmup, int num_samples, int num_thin,
+          bool save_warmup, int refresh, double stepsize,
+          double stepsize_jitter, int max_depth, double delta, double gamma,
+          double kappa, double t0, unsigned int init_buffer,
+          unsigned int term_buffer, unsigned int window,
+          callbacks::interrupt& interrupt, callbacks::logger& logger,
+          const std::vector<callbacks::writer*>& init_writer,
+          const std::vector<callbacks::writer*>& sample_writer,
+          const std::vector<callbacks::writer*>& diagnostic_writer) {
+        stan::io::dump dmp =
+          util::create_unit_e_diag_inv_metric(model.num_params_r());
+        std::vector<stan::io::var_context*> unit_e_metric(num_chains, &dmp);
+
+        return hmc_nuts_diag_e_pooled_adapt(model, num_chains, init,
+                                            unit_e_metric, random_seed,
+                                            init_chain_id, init_radius,
+                                            num_warmup, num_samples, num_thin,
+                                            save_warmup, refresh,
+                                            stepsize, stepsize_jitter,
+                                            max_depth, delta, gamma, kappa,
+                                            t0, init_buffer, term_buffer,
+                                            window, interrupt, logger,
+                                            init_writer, sample_writer,
+                                            diagnostic_writer);
+      }
+
+    }
+  }
+}
+#endif
@@ -9,6 +9,7 @@
 #include <stan/services/error_codes.hpp>
 #include <stan/services/util/create_rng.hpp>
 #include <stan/services/util/initialize.hpp>
+#include <stan/services/util/sampler_timer.hpp>
 #include <stan/services/util/run_adaptive_sampler.hpp>
 #include <vector>
 
@@ -62,6 +63,8 @@ namespace stan {
         boost::ecuyer1988 rng = util::create_rng(random_seed, chain);
 
         std::vector<int> disc_vector;
+        util::sampler_timer timer;
+        timer.begin("init");
         std::vector<double> cont_vector
           = util::initialize(model, init, rng, init_radius, true,
                              logger, init_writer);
@@ -81,7 +84,7 @@ namespace stan {
         util::run_adaptive_sampler(sampler, model, cont_vector, num_warmup,
                                    num_samples, num_thin, refresh, save_warmup,
                                    rng, interrupt, logger,
-                                   sample_writer, diagnostic_writer);
+                                   sample_writer, diagnostic_writer, timer);
 
         return error_codes::OK;
       }
@@ -11,6 +11,7 @@
 #include <stan/services/util/run_sampler.hpp>
 #include <stan/services/util/create_rng.hpp>
 #include <stan/services/util/initialize.hpp>
+#include <stan/services/util/sampler_timer.hpp>
 #include <stan/services/util/inv_metric.hpp>
 #include <vector>
 
@@ -61,6 +62,8 @@ namespace stan {
         boost::ecuyer1988 rng = util::create_rng(random_seed, chain);
 
         std::vector<int> disc_vector;
+        util::sampler_timer timer;
+        timer.begin("init");
         std::vector<double> cont_vector
           = util::initialize(model, init, rng, init_radius, true,
                              logger, init_writer);
@@ -85,7 +88,7 @@ namespace stan {
         util::run_sampler(sampler, model, cont_vector, num_warmup, num_samples,
                           num_thin, refresh, save_warmup, rng, interrupt,
                           logger,
-                          sample_writer, diagnostic_writer);
+                          sample_writer, diagnostic_writer, timer);
 
         return error_codes::OK;
       }
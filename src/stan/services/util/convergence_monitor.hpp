@@ -0,0 +1,91 @@
+#ifndef STAN_SERVICES_UTIL_CONVERGENCE_MONITOR_HPP
+#define STAN_SERVICES_UTIL_CONVERGENCE_MONITOR_HPP
+
+#include <stan/analyze/mcmc/online_diagnostics.hpp>
+#include <stan/callbacks/logger.hpp>
+#include <stan/mcmc/sample.hpp>
+#include <Eigen/Dense>
+#include <cstddef>
+#include <sstream>
+
+namespace stan {
+  namespace services {
+    namespace util {
+
+      /**
+       * Feeds the draws of one chain to online convergence diagnostics
+       * shared by all chains, reports the running diagnostics and
+       * decides when sampling may stop.
+       *
+       * Each draw is the log density followed by the unconstrained
+       * parameters, so the diagnostics must have
+       * <code>num_params_r() + 1</code> parameters.  Diagnostics are
+       * only checked every <code>check_every</code> draws because
+       * checking takes time proportional to the number of chains,
+       * parameters and batches.
+       */
+      class convergence_monitor {
+      public:
+        /**
+         * Construct a monitor for one chain.
+         *
+         * @param[in,out] diagnostics diagnostics shared by all chains
+         * @param[in] chain index of the chain in the diagnostics
+         * @param[in] min_ess minimum effective sample size of every
+         *   parameter for sampling to stop
+         * @param[in] max_rhat maximum split R hat of every parameter
+         *   for sampling to stop
+         * @param[in] check_every number of draws between checks; must
+         *   be positive
+         */
+        convergence_monitor(analyze::online_diagnostics& diagnostics,
+                            size_t chain, double min_ess, double max_rhat,
+                            int check_every = 100)
+          : diagnostics_(diagnostics), chain_(chain), min_ess_(min_ess),
+            max_rhat_(max_rhat), check_every_(check_every), num_draws_(0),
+            draw_(diagnostics.num_params()) {}
+
+        /**
+         * Add a draw and, every <code>check_every</code> draws, log
+         * the smallest effective sample size and largest split R hat
+         * and check whether the targets have been reached.
+         *
+         * @param[in] s draw
+         * @param[in,out] logger logger for messages
+         * @return true if sampling may stop
+         */
+        bool update(const stan::mcmc::sample& s, callbacks::logger& logger) {
+          draw_(0) = s.log_prob();
+          draw_.tail(draw_.size() - 1) = s.cont_params();
+          diagnostics_.add_sample(chain_, draw_);
+          if (++num_draws_ % check_every_ != 0)
+            return false;
+
+          Eigen::VectorXd ess = diagnostics_.effective_sample_size();
+          Eigen::VectorXd rhat = diagnostics_.split_potential_scale_reduction();
+          std::stringstream message;
+          message << "Convergence: minimum ESS = " << ess.minCoeff()
+                  << ", maximum split R hat = " << rhat.maxCoeff();
+          logger.info(message);
+
+          if (!diagnostics_.converged(min_ess_, max_rhat_))
+            return false;
+          logger.info("Stopping sampling early: all parameters reached the"
+                      " target ESS and split R hat.");
+          return true;
+        }
+
+      private:
+        analyze::online_diagnostics& diagnostics_;
+        size_t chain_;
+        double min_ess_;
+        double max_rhat_;
+        int check_every_;
+        long num_draws_;
+        Eigen::VectorXd draw_;
+      };
+
+    }
+  }
+}
+#endif
@@ -0,0 +1,35 @@
+#ifndef STAN_SERVICES_UTIL_CREATE_DIAG_INV_METRIC_HPP
+#define STAN_SERVICES_UTIL_CREATE_DIAG_INV_METRIC_HPP
+
+#include <stan/io/array_var_context.hpp>
+#include <Eigen/Dense>
+#include <string>
+#include <vector>
+
+namespace stan {
+  namespace services {
+    namespace util {
+
+      /**
+       * Create a var_context which contains vector "inv_metric"
+       * holding the specified diagonal of an inverse Euclidean
+       * metric, as read by <code>read_diag_inv_metric</code>.
+       *
+       * @param[in] inv_metric diagonal of the inverse metric
+       * @return var_context
+       */
+      inline
+      stan::io::array_var_context
+      create_diag_inv_metric(const Eigen::VectorXd& inv_metric) {
+        std::vector<std::string> names(1, "inv_metric");
+        std::vector<double> values(inv_metric.data(),
+                                   inv_metric.data() + inv_metric.size());
+        std::vector<std::vector<size_t> >
+          dims(1, std::vector<size_t>(1, inv_metric.size()));
+        return stan::io::array_var_context(names, values, dims);
+      }
+    }
+  }
+}
+
+#endif
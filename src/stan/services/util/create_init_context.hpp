@@ -0,0 +1,64 @@
+#ifndef STAN_SERVICES_UTIL_CREATE_INIT_CONTEXT_HPP
+#define STAN_SERVICES_UTIL_CREATE_INIT_CONTEXT_HPP
+
+#include <stan/io/array_var_context.hpp>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace stan {
+  namespace services {
+    namespace util {
+
+      /**
+       * Create a var_context holding the parameters of a model on the
+       * constrained scale at the specified unconstrained values, so
+       * that the values can be passed as initial values to a service.
+       *
+       * @tparam Model type of model
+       * @tparam RNG type of random number generator
+       * @param[in] model the model
+       * @param[in] unconstrained unconstrained parameter values
+       * @param[in,out] rng random number generator passed to
+       *   <code>write_array</code>
+       * @return var_context with the constrained parameter values
+       */
+      template <class Model, class RNG>
+      stan::io::array_var_context
+      create_init_context(Model& model,
+                          const std::vector<double>& unconstrained,
+                          RNG& rng) {
+        std::vector<std::string> names;
+        std::vector<std::vector<size_t> > dims;
+        model.get_param_names(names);
+        model.get_dims(dims);
+
+        std::vector<double> params_r(unconstrained);
+        std::vector<int> params_i;
+        std::vector<double> constrained;
+        std::stringstream msg;
+        model.write_array(rng, params_r, params_i, constrained,
+                          false, false, &msg);
+
+        // the names and dims also cover transformed parameters and
+        // generated quantities, which are not written
+        size_t num = 0;
+        size_t keep = 0;
+        for (; keep < dims.size(); ++keep) {
+          size_t size = 1;
+          for (size_t n = 0; n < dims[keep].size(); ++n)
+            size *= dims[keep][n];
+          if (num + size > constrained.size())
+            break;
+          num += size;
+        }
+        names.erase(names.begin() + keep, names.end());
+        dims.erase(dims.begin() + keep, dims.end());
+        return stan::io::array_var_context(names, constrained, dims);
+      }
+
+    }
+  }
+}
+
+#endif
@@ -0,0 +1,58 @@
+#ifndef STAN_SERVICES_UTIL_CREATE_WRITER_HPP
+#define STAN_SERVICES_UTIL_CREATE_WRITER_HPP
+
+#include <stan/callbacks/binary_writer.hpp>
+#include <stan/callbacks/stream_writer.hpp>
+#include <stan/callbacks/writer.hpp>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+
+namespace stan {
+  namespace services {
+    namespace util {
+
+      /**
+       * Formats in which draws can be written.
+       */
+      struct output_format {
+        enum {
+          CSV = 0,
+          BINARY = 1
+        };
+      };
+
+      /**
+       * Creates a writer for draws in the given format.  Any writer
+       * can be passed to the services as the sample or diagnostic
+       * writer, so the format of the output is independent of the
+       * algorithm producing it.
+       *
+       * @param[in] format one of the <code>output_format</code> values
+       * @param[in,out] output stream to write, opened in binary mode
+       *   for binary output
+       * @param[in] comment_prefix string to stream before each comment
+       *   line in csv output
+       * @return writer for the given format
+       * @throw std::invalid_argument if the format is not known
+       */
+      inline std::unique_ptr<callbacks::writer>
+      create_writer(int format, std::ostream& output,
+                    const std::string& comment_prefix = "") {
+        switch (format) {
+        case output_format::CSV:
+          return std::unique_ptr<callbacks::writer>(
+              new callbacks::stream_writer(output, comment_prefix));
+        case output_format::BINARY:
+          return std::unique_ptr<callbacks::writer>(
+              new callbacks::binary_writer(output));
+        default:
+          throw std::invalid_argument("Unknown output format");
+        }
+      }
+
+    }
+  }
+}
+#endif
@@ -4,7 +4,9 @@
 #include <stan/callbacks/writer.hpp>
 #include <stan/callbacks/interrupt.hpp>
 #include <stan/mcmc/base_mcmc.hpp>
+#include <stan/services/util/convergence_monitor.hpp>
 #include <stan/services/util/mcmc_writer.hpp>
+#include <stan/services/util/sampler_timer.hpp>
 #include <string>
 
 namespace stan {
@@ -36,6 +38,11 @@ namespace stan {
        * @param[in,out] base_rng random number generator
        * @param[in,out] callback interrupt callback called once an iteration
        * @param[in,out] logger logger for messages
+       * @param[in,out] timer if not null, each transition is recorded
+       *   in the current phase of the timer
+       * @param[in,out] monitor if not null, each saved post warmup
+       *   transition is passed to the monitor, and transitions stop
+       *   early once the monitor reports convergence
        */
       template <class Model, class RNG>
       void generate_transitions(stan::mcmc::base_mcmc& sampler,
@@ -46,7 +53,9 @@ namespace stan {
                                 stan::mcmc::sample& init_s,
                                 Model& model, RNG& base_rng,
                                 callbacks::interrupt& callback,
-                                callbacks::logger& logger) {
+                                callbacks::logger& logger,
+                                util::sampler_timer* timer = 0,
+                                util::convergence_monitor* monitor = 0) {
         for (int m = 0; m < num_iterations; ++m) {
           callback();
 
@@ -69,10 +78,14 @@ namespace stan {
           }
 
           init_s = sampler.transition(init_s, logger);
+          if (timer)
+            timer->record_transition(sampler);
 
           if (save && ((m % num_thin) == 0)) {
             mcmc_writer.write_sample_params(base_rng, init_s, sampler, model);
             mcmc_writer.write_diagnostic_params(init_s, sampler);
+            if (monitor && !warmup && monitor->update(init_s, logger))
+              break;
           }
         }
       }
@@ -1,6 +1,7 @@
 #ifndef STAN_SERVICES_UTIL_INITIALIZE_HPP
 #define STAN_SERVICES_UTIL_INITIALIZE_HPP
 
+#include <stan/callbacks/buffered_logger.hpp>
 #include <stan/callbacks/logger.hpp>
 #include <stan/callbacks/writer.hpp>
 #include <stan/io/var_context.hpp>
@@ -8,6 +9,11 @@
 #include <stan/io/chained_var_context.hpp>
 #include <stan/model/log_prob_grad.hpp>
 #include <stan/math/prim/arr/fun/sum.hpp>
+#include <stan/util/parallel_for.hpp>
+#include <algorithm>
+#include <ctime>
+#include <exception>
+#include <memory>
 #include <sstream>
 #include <string>
 #include <vector>
@@ -16,6 +22,137 @@ namespace stan {
 namespace services {
 namespace util {
 
+/**
+ * Evaluates a candidate initial value, logging why it is rejected.
+ * Exceptions other than <code>std::domain_error</code> are logged and
+ * returned rather than thrown so that candidates can be evaluated on
+ * other threads.
+ *
+ * @tparam Jacobian indicates whether to include the Jacobian term when
+ *   evaluating the log density function
+ * @tparam Model the type of the model class
+ *
+ * @param[in] model the model
+ * @param[in] init a var_context with initial values
+ * @param[in] any_initialized indicates whether init provides any of
+ *   the parameters
+ * @param[in] random_context random values for the parameters
+ * @param[out] unconstrained unconstrained parameters of the candidate
+ * @param[out] gradient_time processor time taken to evaluate the gradient
+ * @param[out] error fatal exception thrown by the model, if any
+ * @param[in,out] logger logger for messages
+ * @return true if the log probability and its gradient are finite
+ */
+template <bool Jacobian, class Model>
+bool evaluate_initialization(Model& model,
+                             stan::io::var_context& init,
+                             bool any_initialized,
+                             const stan::io::random_var_context&
+                             random_context,
+                             std::vector<double>& unconstrained,
+                             double& gradient_time,
+                             std::exception_ptr& error,
+                             stan::callbacks::logger& logger) {
+  std::vector<int> disc_vector;
+  std::stringstream msg;
+  try {
+    if (!any_initialized) {
+      unconstrained = random_context.get_unconstrained();
+    } else {
+      stan::io::chained_var_context context(init, random_context);
+
+      model.transform_inits(context,
+                            disc_vector,
+                            unconstrained,
+                            &msg);
+    }
+  } catch (std::domain_error& e) {
+    if (msg.str().length() > 0)
+      logger.info(msg);
+    logger.info("Rejecting initial value:");
+    logger.info("  Error evaluating the log probability"
+                " at the initial value.");
+    logger.info(e.what());
+    return false;
+  } catch (std::exception& e) {
+    if (msg.str().length() > 0)
+      logger.info(msg);
+    logger.info("Unrecoverable error evaluating the log probability"
+                " at the initial value.");
+    logger.info(e.what());
+    error = std::current_exception();
+    return false;
+  }
+
+  msg.str("");
+  double log_prob(0);
+  try {
+    // we evaluate the log_prob function with propto=false
+    // because we're evaluating with `double` as the type of
+    // the parameters.
+    log_prob = model.template log_prob<false, Jacobian>
+               (unconstrained, disc_vector, &msg);
+    if (msg.str().length() > 0)
+      logger.info(msg);
+  } catch (std::domain_error& e) {
+    if (msg.str().length() > 0)
+      logger.info(msg);
+    logger.info("Rejecting initial value:");
+    logger.info("  Error evaluating the log probability"
+                " at the initial value.");
+    logger.info(e.what());
+    return false;
+  } catch (std::exception& e) {
+    if (msg.str().length() > 0)
+      logger.info(msg);
+    logger.info("Unrecoverable error evaluating the log probability"
+                " at the initial value.");
+    logger.info(e.what());
+    error = std::current_exception();
+    return false;
+  }
+  if (!boost::math::isfinite(log_prob)) {
+    logger.info("Rejecting initial value:");
+    logger.info("  Log probability evaluates to log(0),"
+                " i.e. negative infinity.");
+    logger.info("  Stan can't start sampling from this"
+                " initial value.");
+    return false;
+  }
+  std::stringstream log_prob_msg;
+  std::vector<double> gradient;
+  clock_t start_check = clock();
+  try {
+    // we evaluate this with propto=true since we're
+    // evaluating with autodiff variables
+    log_prob = stan::model::log_prob_grad<true, Jacobian>
+               (model, unconstrained, disc_vector,
+                gradient, &log_prob_msg);
+  } catch (const std::exception& e) {
+    if (log_prob_msg.str().length() > 0)
+      logger.info(log_prob_msg);
+    logger.info(e.what());
+    error = std::current_exception();
+    return false;
+  }
+  clock_t end_check = clock();
+  gradient_time = static_cast<double>(end_check - start_check)
+                  / CLOCKS_PER_SEC;
+  if (log_prob_msg.str().length() > 0)
+    logger.info(log_prob_msg);
+
+  bool gradient_ok = boost::math::isfinite(stan::math::sum(gradient));
+
+  if (!gradient_ok) {
+    logger.info("Rejecting initial value:");
+    logger.info("  Gradient evaluated at the initial value"
+                " is not finite.");
+    logger.info("  Stan can't start sampling from this"
+                " initial value.");
+  }
+  return gradient_ok;
+}
+
 /**
  * Returns a valid initial value of the parameters of the model
  * on the unconstrained scale.
@@ -42,6 +179,17 @@ namespace util {
  * evaluation of the log probability density function and all its
  * gradients.
  *
+ * Candidate initial values are evaluated in batches of
+ * <code>num_threads</code>, concurrently.  The random values of the
+ * candidates are drawn in order on the calling thread and the first
+ * valid candidate is chosen, with its messages and those of the
+ * candidates before it logged in order, so the result, the messages
+ * and the state of the random number generator afterwards do not
+ * depend on the number of threads.  The gradient is evaluated on
+ * <code>stan::util::get_num_autodiff_threads(num_threads)</code>
+ * threads, so on more than one only when compiled with
+ * <code>STAN_THREADS</code>.
+ *
  * @tparam Jacobian indicates whether to include the Jacobian term when
  *   evaluating the log density function
  * @tparam Model the type of the model class
@@ -57,6 +205,8 @@ namespace util {
  *   be printed to the logger
  * @param[in,out] logger logger for messages
  * @param[in,out] init_writer init writer (on the unconstrained scale)
+ * @param[in] num_threads maximum number of candidates to evaluate at
+ *   once
  * @throws exception passed through from the model if the model has a
  *   fatal error (not a std::domain_error)
  * @throws std::domain_error if the model can not be initialized and
@@ -72,10 +222,8 @@ std::vector<double> initialize(Model& model,
                                bool print_timing,
                                stan::callbacks::logger& logger,
                                stan::callbacks::writer&
-                               init_writer) {
-  std::vector<double> unconstrained;
-  std::vector<int> disc_vector;
-
+                               init_writer,
+                               int num_threads) {
   bool is_fully_initialized = true;
   bool any_initialized = false;
   std::vector<std::string> param_names;
@@ -89,123 +237,74 @@ std::vector<double> initialize(Model& model,
 
   int MAX_INIT_TRIES = is_fully_initialized || is_initialized_with_zero
                        ? 1 : 100;
-  int num_init_tries = 0;
-  for (; num_init_tries < MAX_INIT_TRIES; num_init_tries++) {
-    std::stringstream msg;
-    try {
-      stan::io::random_var_context
-          random_context(model, rng, init_radius, is_initialized_with_zero);
-
-      if (!any_initialized) {
-        unconstrained = random_context.get_unconstrained();
-      } else {
-        stan::io::chained_var_context context(init, random_context);
-
-        model.transform_inits(context,
-                              disc_vector,
-                              unconstrained,
-                              &msg);
+  num_threads = stan::util::get_num_autodiff_threads(num_threads);
+  for (int first_try = 0; first_try < MAX_INIT_TRIES;
+       first_try += num_threads) {
+    int num_tries = std::min(num_threads, MAX_INIT_TRIES - first_try);
+    std::vector<stan::callbacks::buffered_logger> loggers(num_tries);
+    std::vector<std::unique_ptr<stan::io::random_var_context> >
+      random_contexts(num_tries);
+    std::vector<RNG> rngs;
+    std::vector<std::exception_ptr> errors(num_tries);
+
+    // random values are drawn in order so that they are the same for
+    // any number of threads
+    for (int n = 0; n < num_tries; ++n) {
+      try {
+        random_contexts[n].reset(new stan::io::random_var_context
+                                 (model, rng, init_radius,
+                                  is_initialized_with_zero));
+      } catch (std::domain_error& e) {
+        loggers[n].info("Rejecting initial value:");
+        loggers[n].info("  Error evaluating the log probability"
+                        " at the initial value.");
+        loggers[n].info(e.what());
+      } catch (std::exception& e) {
+        loggers[n].info("Unrecoverable error evaluating the log"
+                        " probability at the initial value.");
+        loggers[n].info(e.what());
+        errors[n] = std::current_exception();
+        num_tries = n + 1;
       }
-    } catch (std::domain_error& e) {
-      if (msg.str().length() > 0)
-        logger.info(msg);
-      logger.info("Rejecting initial value:");
-      logger.info("  Error evaluating the log probability"
-                  " at the initial value.");
-      logger.info(e.what());
-      continue;
-    } catch (std::exception& e) {
-      if (msg.str().length() > 0)
-        logger.info(msg);
-      logger.info("Unrecoverable error evaluating the log probability"
-                  " at the initial value.");
-      logger.info(e.what());
-      throw;
+      rngs.push_back(rng);
     }
 
-    msg.str("");
-    double log_prob(0);
-    try {
-      // we evaluate the log_prob function with propto=false
-      // because we're evaluating with `double` as the type of
-      // the parameters.
-      log_prob = model.template log_prob<false, Jacobian>
-                 (unconstrained, disc_vector, &msg);
-      if (msg.str().length() > 0)
-        logger.info(msg);
-    } catch (std::domain_error& e) {
-      if (msg.str().length() > 0)
-        logger.info(msg);
-      logger.info("Rejecting initial value:");
-      logger.info("  Error evaluating the log probability"
-                  " at the initial value.");
-      logger.info(e.what());
-      continue;
-    } catch (std::exception& e) {
-      if (msg.str().length() > 0)
-        logger.info(msg);
-      logger.info("Unrecoverable error evaluating the log probability"
-                  " at the initial value.");
-      logger.info(e.what());
-      throw;
-    }
-    if (!boost::math::isfinite(log_prob)) {
-      logger.info("Rejecting initial value:");
-      logger.info("  Log probability evaluates to log(0),"
-                  " i.e. negative infinity.");
-      logger.info("  Stan can't start sampling from this"
-                  " initial value.");
-      continue;
-    }
-    std::stringstream log_prob_msg;
-    std::vector<double> gradient;
-    clock_t start_check = clock();
-    try {
-      // we evaluate this with propto=true since we're
-      // evaluating with autodiff variables
-      log_prob = stan::model::log_prob_grad<true, Jacobian>
-                 (model, unconstrained, disc_vector,
-                  gradient, &log_prob_msg);
-    } catch (const std::exception& e) {
-      if (log_prob_msg.str().length() > 0)
-        logger.info(log_prob_msg);
-      logger.info(e.what());
-      throw;
-    }
-    clock_t end_check = clock();
-    double deltaT = static_cast<double>(end_check - start_check)
-                    / CLOCKS_PER_SEC;
-    if (log_prob_msg.str().length() > 0)
-      logger.info(log_prob_msg);
+    std::vector<std::vector<double> > unconstrained(num_tries);
+    std::vector<double> gradient_times(num_tries);
+    std::vector<char> valid(num_tries, false);
+    stan::util::parallel_for(0, num_tries, [&](size_t n) {
+        if (random_contexts[n])
+          valid[n] = evaluate_initialization<Jacobian>
+            (model, init, any_initialized, *random_contexts[n],
+             unconstrained[n], gradient_times[n], errors[n], loggers[n]);
+      }, num_threads);
 
-    bool gradient_ok = boost::math::isfinite(stan::math::sum(gradient));
+    for (int n = 0; n < num_tries; ++n) {
+      loggers[n].flush(logger);
+      if (errors[n])
+        std::rethrow_exception(errors[n]);
+      if (!valid[n])
+        continue;
+      rng = rngs[n];
+      if (print_timing) {
+        logger.info("");
+        std::stringstream msg1;
+        msg1 << "Gradient evaluation took " << gradient_times[n]
+             << " seconds";
+        logger.info(msg1);
 
-    if (!gradient_ok) {
-      logger.info("Rejecting initial value:");
-      logger.info("  Gradient evaluated at the initial value"
-                  " is not finite.");
-      logger.info("  Stan can't start sampling from this"
-                  " initial value.");
-    }
-    if (gradient_ok && print_timing) {
-      logger.info("");
-      std::stringstream msg1;
-      msg1 << "Gradient evaluation took " << deltaT << " seconds";
-      logger.info(msg1);
-
-      std::stringstream msg2;
-      msg2 << "1000 transitions using 10 leapfrog steps"
-           << " per transition would take"
-           << " " << 1e4 * deltaT << " seconds.";
-      logger.info(msg2);
-
-      logger.info("Adjust your expectations accordingly!");
-      logger.info("");
-      logger.info("");
-    }
-    if (gradient_ok) {
-      init_writer(unconstrained);
-      return unconstrained;
+        std::stringstream msg2;
+        msg2 << "1000 transitions using 10 leapfrog steps"
+             << " per transition would take"
+             << " " << 1e4 * gradient_times[n] << " seconds.";
+        logger.info(msg2);
+
+        logger.info("Adjust your expectations accordingly!");
+        logger.info("");
+        logger.info("");
+      }
+      init_writer(unconstrained[n]);
+      return unconstrained[n];
     }
   }
 
@@ -223,6 +322,67 @@ std::vector<double> initialize(Model& model,
   throw std::domain_error("Initialization failed.");
 }
 
+/**
+ * Returns a valid initial value of the parameters of the model
+ * on the unconstrained scale.
+ *
+ * For identical inputs (model, init, rng, init_radius), this
+ * function will produce the same initialization.
+ *
+ * Initialization first tries to use the provided
+ * <code>stan::io::var_context</code>, then it will generate
+ * random uniform values from -init_radius to +init_radius for missing
+ * parameters.
+ *
+ * When the <code>var_context</code> provides all variables or
+ * the init_radius is 0, this function will only evaluate the
+ * log probability of the model with the unconstrained
+ * parameters once to see if it's valid.
+ *
+ * When at least some of the initialization is random, it will
+ * randomly initialize until it finds a set of unconstrained
+ * parameters that are valid or it hits <code>MAX_INIT_TRIES =
+ * 100</code> (hard-coded).
+ *
+ * Valid initialization is defined as a finite, non-NaN value for the
+ * evaluation of the log probability density function and all its
+ * gradients.
+ *
+ * @tparam Jacobian indicates whether to include the Jacobian term when
+ *   evaluating the log density function
+ * @tparam Model the type of the model class
+ * @tparam RNG the type of the random number generator
+ *
+ * @param[in] model the model
+ * @param[in] init a var_context with initial values
+ * @param[in,out] rng random number generator
+ * @param[in] init_radius the radius for generating random values.
+ *   A value of 0 indicates that the unconstrained parameters (not
+ *   provided by init) should be initialized with 0.
+ * @param[in] print_timing indicates whether a timing message should
+ *   be printed to the logger
+ * @param[in,out] logger logger for messages
+ * @param[in,out] init_writer init writer (on the unconstrained scale)
+ * @throws exception passed through from the model if the model has a
+ *   fatal error (not a std::domain_error)
+ * @throws std::domain_error if the model can not be initialized and
+ *   the model does not have a fatal error (only allows for
+ *   std::domain_error)
+ * @return valid unconstrained parameters for the model
+ */
+template <bool Jacobian = true, class Model, class RNG>
+std::vector<double> initialize(Model& model,
+                               stan::io::var_context& init,
+                               RNG& rng,
+                               double init_radius,
+                               bool print_timing,
+                               stan::callbacks::logger& logger,
+                               stan::callbacks::writer&
+                               init_writer) {
+  return initialize<Jacobian>(model, init, rng, init_radius, print_timing,
+                              logger, init_writer, 1);
+}
+
 }
 }
 }
@@ -0,0 +1,181 @@
+#ifndef STAN_SERVICES_UTIL_INITIALIZE_LBFGS_HPP
+#define STAN_SERVICES_UTIL_INITIALIZE_LBFGS_HPP
+
+#include <stan/callbacks/logger.hpp>
+#include <stan/callbacks/writer.hpp>
+#include <stan/io/var_context.hpp>
+#include <stan/optimization/bfgs.hpp>
+#include <stan/services/util/initialize.hpp>
+#include <boost/math/special_functions/fpclassify.hpp>
+#include <boost/random/normal_distribution.hpp>
+#include <Eigen/Dense>
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace stan {
+namespace services {
+namespace util {
+
+/**
+ * Estimates the evidence lower bound (ELBO) of a normal approximation
+ * with diagonal covariance to the log density on the unconstrained
+ * scale, up to a constant, by Monte Carlo.  The estimate is negative
+ * infinity if the log density is not finite at any of the draws.
+ *
+ * @tparam Model the type of the model class
+ * @tparam RNG the type of the random number generator
+ *
+ * @param[in] model the model
+ * @param[in] mean mean of the approximation
+ * @param[in] variance diagonal of the covariance of the approximation
+ * @param[in] num_draws number of draws
+ * @param[in,out] rng random number generator
+ * @param[in,out] msg stream for messages from the model
+ * @return the estimate
+ */
+template <class Model, class RNG>
+double normal_approximation_elbo(Model& model,
+                                 const Eigen::VectorXd& mean,
+                                 const Eigen::VectorXd& variance,
+                                 int num_draws, RNG& rng,
+                                 std::stringstream& msg) {
+  boost::random::normal_distribution<double> unit_normal;
+  std::vector<double> draw(mean.size());
+  std::vector<int> disc_vector;
+  double log_prob = 0;
+  for (int m = 0; m < num_draws; ++m) {
+    for (int n = 0; n < mean.size(); ++n)
+      draw[n] = mean(n) + std::sqrt(variance(n)) * unit_normal(rng);
+    double lp;
+    try {
+      lp = model.template log_prob<false, true>(draw, disc_vector, &msg);
+    } catch (const std::domain_error& e) {
+      return -std::numeric_limits<double>::infinity();
+    }
+    if (!boost::math::isfinite(lp))
+      return -std::numeric_limits<double>::infinity();
+    log_prob += lp;
+  }
+  return log_prob / num_draws + 0.5 * variance.array().log().sum();
+}
+
+/**
+ * Returns initial values for sampling on the unconstrained scale
+ * found by a short L-BFGS trajectory on the log density, including the
+ * Jacobian, and the diagonal of an inverse Euclidean metric for them.
+ *
+ * The trajectory starts from the values returned by
+ * <code>initialize</code>.  At each iterate the diagonal of the L-BFGS
+ * approximation to the inverse Hessian, computed from the curvature
+ * history, defines a normal approximation to the posterior.  As in
+ * Pathfinder (Zhang et al., 2022), the iterate whose approximation has
+ * the highest ELBO estimate is chosen rather than the end of the
+ * trajectory, which for hierarchical models may be far from the
+ * typical set.  If no iterate has a finite estimate, the starting
+ * values are returned with a unit metric.
+ *
+ * To use the results with the sampling services, pass
+ * <code>create_init_context</code> of the values as the initial values
+ * and <code>create_diag_inv_metric</code> of the metric as the initial
+ * inverse metric.
+ *
+ * @tparam Model the type of the model class
+ * @tparam RNG the type of the random number generator
+ *
+ * @param[in] model the model
+ * @param[in] init a var_context with initial values
+ * @param[in,out] rng random number generator
+ * @param[in] init_radius the radius for generating random values.
+ *   A value of 0 indicates that the unconstrained parameters (not
+ *   provided by init) should be initialized with 0.
+ * @param[in] num_iterations maximum number of L-BFGS iterations
+ * @param[in] history_size amount of history to keep for L-BFGS
+ * @param[in] num_elbo_draws number of draws to estimate each ELBO
+ * @param[out] inv_metric diagonal of the inverse metric
+ * @param[in,out] logger logger for messages
+ * @param[in,out] init_writer init writer (on the unconstrained scale)
+ * @throws std::domain_error if the model can't be initialized
+ * @return valid unconstrained parameters for the model
+ */
+template <class Model, class RNG>
+std::vector<double> initialize_lbfgs(Model& model,
+                                     stan::io::var_context& init,
+                                     RNG& rng,
+                                     double init_radius,
+                                     int num_iterations,
+                                     int history_size,
+                                     int num_elbo_draws,
+                                     Eigen::VectorXd& inv_metric,
+                                     stan::callbacks::logger& logger,
+                                     stan::callbacks::writer& init_writer) {
+  stan::callbacks::writer start_writer;
+  std::vector<double> cont_vector
+    = initialize<true>(model, init, rng, init_radius, false,
+                       logger, start_writer);
+  inv_metric.setOnes(cont_vector.size());
+
+  std::vector<int> disc_vector;
+  std::stringstream lbfgs_ss;
+  typedef stan::optimization::LBFGSUpdate<> QNUpdate;
+  typedef stan::optimization::BFGSLineSearch
+    <Model, QNUpdate, double, Eigen::Dynamic, true> Optimizer;
+  Optimizer lbfgs(model, cont_vector, disc_vector, &lbfgs_ss);
+  lbfgs.get_qnupdate().set_history_size(history_size);
+  lbfgs._conv_opts.maxIts = num_iterations;
+
+  double best_elbo = -std::numeric_limits<double>::infinity();
+  int best_iteration = 0;
+  Eigen::VectorXd variance;
+  std::stringstream msg;
+  int ret = 0;
+  while (ret == 0 && num_iterations > 0) {
+    ret = lbfgs.step();
+    if (ret < 0)
+      break;
+    lbfgs.get_qnupdate().inv_hessian_diagonal(variance,
+                                              cont_vector.size());
+    if (!boost::math::isfinite(variance.sum())
+        || !(variance.minCoeff() > 0))
+      continue;
+    double elbo = normal_approximation_elbo(model, lbfgs.curr_x(),
+                                            variance, num_elbo_draws,
+                                            rng, msg);
+    if (elbo > best_elbo) {
+      best_elbo = elbo;
+      best_iteration = lbfgs.iter_num();
+      lbfgs.params_r(cont_vector);
+      inv_metric = variance;
+    }
+  }
+  if (lbfgs_ss.str().length() > 0)
+    logger.info(lbfgs_ss);
+  if (msg.str().length() > 0)
+    logger.info(msg);
+
+  std::stringstream result_msg;
+  if (best_iteration > 0) {
+    result_msg << "L-BFGS initialization chose iteration "
+               << best_iteration << " of " << lbfgs.iter_num()
+               << " with ELBO estimate " << best_elbo << ".";
+  } else {
+    result_msg << "L-BFGS initialization found no normal approximation"
+               << " with a finite ELBO estimate;"
+               << " using the initial values and a unit metric.";
+  }
+  logger.info(result_msg);
+  if (ret < 0)
+    logger.info("  " + lbfgs.get_code_string(ret));
+
+  init_writer(cont_vector);
+  return cont_vector;
+}
+
+}
+}
+}
+
+#endif
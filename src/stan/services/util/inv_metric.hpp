@@ -1,3 +1,4 @@
+#include <stan/services/util/create_diag_inv_metric.hpp>
 #include <stan/services/util/create_unit_e_diag_inv_metric.hpp>
 #include <stan/services/util/create_unit_e_dense_inv_metric.hpp>
 #include <stan/services/util/read_diag_inv_metric.hpp>
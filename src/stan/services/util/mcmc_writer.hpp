@@ -6,6 +6,7 @@
 #include <stan/mcmc/base_mcmc.hpp>
 #include <stan/mcmc/sample.hpp>
 #include <stan/model/prob_grad.hpp>
+#include <stan/services/util/sampler_timer.hpp>
 #include <iomanip>
 #include <limits>
 #include <sstream>
@@ -265,6 +266,42 @@ class mcmc_writer {
     write_timing(warmDeltaT, sampleDeltaT, diagnostic_writer_);
     log_timing(warmDeltaT, sampleDeltaT);
   }
+
+  /**
+   * Internal method
+   *
+   * Writes the wall time and the work done by the sampler in each
+   * phase of the run, one phase per line of space separated
+   * <code>key=value</code> pairs, followed by a blank line if there
+   * are any phases.
+   *
+   * @param[in] phases timed phases of the run
+   * @param[in,out] writer output stream
+   */
+  void write_phase_timing(const std::vector<sampler_phase>& phases,
+                          callbacks::writer& writer) {
+    for (size_t n = 0; n < phases.size(); ++n) {
+      std::stringstream ss;
+      ss << " Timing: phase=" << phases[n].name
+         << " wall_time=" << phases[n].wall_time
+         << " transitions=" << phases[n].num_transitions
+         << " leapfrogs=" << phases[n].num_leapfrogs
+         << " gradients=" << phases[n].num_gradients;
+      writer(ss.str());
+    }
+    if (!phases.empty())
+      writer();
+  }
+
+  /**
+   * Print the timing of each phase of the run to the diagnostic
+   * stream, leaving the sample stream unchanged
+   *
+   * @param[in] phases timed phases of the run
+   */
+  void write_phase_timing(const std::vector<sampler_phase>& phases) {
+    write_phase_timing(phases, diagnostic_writer_);
+  }
 };
 
 }
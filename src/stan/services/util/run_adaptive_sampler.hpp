@@ -3,9 +3,11 @@
 
 #include <stan/callbacks/logger.hpp>
 #include <stan/callbacks/writer.hpp>
+#include <stan/services/util/convergence_monitor.hpp>
 #include <stan/services/util/generate_transitions.hpp>
 #include <stan/services/util/mcmc_writer.hpp>
-#include <ctime>
+#include <stan/services/util/sampler_timer.hpp>
+#include <string>
 #include <vector>
 
 namespace stan {
@@ -13,7 +15,11 @@ namespace stan {
     namespace util {
 
       /**
-       * Runs the sampler with adaptation.
+       * Runs the sampler with adaptation, timing step size
+       * initialization, each stage of warmup adaptation and sampling
+       * with the given timer.  The timing of every phase recorded by
+       * the timer, including any phases timed before this call, is
+       * written to the diagnostic writer.
        *
        * @tparam Sampler Type of adaptive sampler.
        * @tparam Model Type of model
@@ -33,6 +39,9 @@ namespace stan {
        * @param[in,out] logger logger for messages
        * @param[in,out] sample_writer writer for draws
        * @param[in,out] diagnostic_writer writer for diagnostic information
+       * @param[in,out] timer timer for the phases of the run
+       * @param[in,out] monitor if not null, monitor of the post warmup
+       *   draws which may stop sampling early
        */
       template <class Sampler, class Model, class RNG>
       void run_adaptive_sampler(Sampler& sampler, Model& model,
@@ -43,19 +52,24 @@ namespace stan {
                                 callbacks::interrupt& interrupt,
                                 callbacks::logger& logger,
                                 callbacks::writer& sample_writer,
-                                callbacks::writer& diagnostic_writer) {
+                                callbacks::writer& diagnostic_writer,
+                                util::sampler_timer& timer,
+                                util::convergence_monitor* monitor = 0) {
         Eigen::Map<Eigen::VectorXd> cont_params(cont_vector.data(),
                                                 cont_vector.size());
 
         sampler.engage_adaptation();
+        timer.begin("stepsize_init", sampler);
         try {
           sampler.z().q = cont_params;
           sampler.init_stepsize(logger);
         } catch (const std::exception& e) {
+          timer.end(sampler);
           logger.info("Exception initializing step size.");
           logger.info(e.what());
           return;
         }
+        timer.end(sampler);
 
         services::util::mcmc_writer
           writer(sample_writer, diagnostic_writer, logger);
@@ -65,32 +79,78 @@ namespace stan {
         writer.write_sample_names(s, sampler, model);
         writer.write_diagnostic_names(s, sampler, model);
 
-        clock_t start = clock();
+        std::vector<std::string> warmup_phases;
+        std::vector<int> warmup_transitions;
+        util::get_warmup_phases(util::get_windowed_adaptation(&sampler),
+                                num_warmup, warmup_phases,
+                                warmup_transitions);
+        size_t first_warmup_phase = timer.phases().size();
+        timer.begin(warmup_phases, warmup_transitions, sampler);
         util::generate_transitions(sampler, num_warmup, 0,
                                    num_warmup + num_samples, num_thin,
                                    refresh, save_warmup, true,
                                    writer,
                                    s, model, rng,
-                                   interrupt, logger);
-        clock_t end = clock();
-        double warm_delta_t = static_cast<double>(end - start) / CLOCKS_PER_SEC;
+                                   interrupt, logger, &timer);
+        timer.end(sampler);
+        double warm_delta_t
+          = timer.wall_time(first_warmup_phase, timer.phases().size());
 
         sampler.disengage_adaptation();
         writer.write_adapt_finish(sampler);
         sampler.write_sampler_state(sample_writer);
 
-        start = clock();
+        timer.begin("sampling", sampler);
         util::generate_transitions(sampler, num_samples, num_warmup,
                                    num_warmup + num_samples, num_thin,
                                    refresh, true, false,
                                    writer,
                                    s, model, rng,
-                                   interrupt, logger);
-        end = clock();
-        double sample_delta_t
-          = static_cast<double>(end - start) / CLOCKS_PER_SEC;
+                                   interrupt, logger, &timer, monitor);
+        timer.end(sampler);
+        double sample_delta_t = timer.phases().back().wall_time;
 
         writer.write_timing(warm_delta_t, sample_delta_t);
+        writer.write_phase_timing(timer.phases());
+      }
+
+      /**
+       * Runs the sampler with adaptation.
+       *
+       * @tparam Sampler Type of adaptive sampler.
+       * @tparam Model Type of model
+       * @tparam RNG Type of random number generator
+       * @param[in,out] sampler the mcmc sampler to use on the model
+       * @param[in] model the model concept to use for computing log probability
+       * @param[in] cont_vector initial parameter values
+       * @param[in] num_warmup number of warmup draws
+       * @param[in] num_samples number of post warmup draws
+       * @param[in] num_thin number to thin the draws. Must be greater than
+       *   or equal to 1.
+       * @param[in] refresh controls output to the <code>logger</code>
+       * @param[in] save_warmup indicates whether the warmup draws should be
+       *   sent to the sample writer
+       * @param[in,out] rng random number generator
+       * @param[in,out] interrupt interrupt callback
+       * @param[in,out] logger logger for messages
+       * @param[in,out] sample_writer writer for draws
+       * @param[in,out] diagnostic_writer writer for diagnostic information
+       */
+      template <class Sampler, class Model, class RNG>
+      void run_adaptive_sampler(Sampler& sampler, Model& model,
+                                std::vector<double>& cont_vector,
+                                int num_warmup, int num_samples,
+                                int num_thin, int refresh, bool save_warmup,
+                                RNG& rng,
+                                callbacks::interrupt& interrupt,
+                                callbacks::logger& logger,
+                                callbacks::writer& sample_writer,
+                                callbacks::writer& diagnostic_writer) {
+        util::sampler_timer timer;
+        run_adaptive_sampler(sampler, model, cont_vector, num_warmup,
+                             num_samples, num_thin, refresh, save_warmup,
+                             rng, interrupt, logger, sample_writer,
+                             diagnostic_writer, timer);
       }
     }
   }
@@ -0,0 +1,85 @@
+#ifndef STAN_SERVICES_UTIL_RUN_ADVI_HPP
+#define STAN_SERVICES_UTIL_RUN_ADVI_HPP
+
+#include <stan/callbacks/logger.hpp>
+#include <stan/callbacks/writer.hpp>
+#include <stan/variational/advi.hpp>
+#include <stan/variational/optimizers/adam.hpp>
+#include <stan/variational/optimizers/rmsprop.hpp>
+#include <stan/variational/optimizers/stepsize_sequence.hpp>
+#include <Eigen/Dense>
+#include <string>
+
+namespace stan {
+  namespace services {
+    namespace util {
+
+      /**
+       * Runs ADVI with the named optimizer.
+       *
+       * @tparam Q Type of variational family
+       * @tparam Model Type of model
+       * @tparam RNG Type of random number generator
+       * @param[in] model the model
+       * @param[in,out] cont_params initial parameter values
+       * @param[in,out] rng random number generator
+       * @param[in] optimizer name of the optimizer: adam, amsgrad or
+       *   rmsprop, or else the adaptive step-size sequence
+       * @param[in] grad_samples number of samples for Monte Carlo estimate
+       *   of gradients
+       * @param[in] elbo_samples number of samples for Monte Carlo estimate
+       *   of ELBO
+       * @param[in] max_iterations maximum number of iterations
+       * @param[in] tol_rel_obj convergence tolerance on the relative norm
+       *   of the objective
+       * @param[in] eta stepsize scaling parameter for variational inference
+       * @param[in] adapt_engaged adaptation engaged?
+       * @param[in] adapt_iterations number of iterations for eta adaptation
+       * @param[in] eval_elbo evaluate ELBO every Nth iteration
+       * @param[in] output_samples number of posterior samples to draw and
+       *   save
+       * @param[in,out] logger Logger for messages
+       * @param[in,out] parameter_writer output for parameter values
+       * @param[in,out] diagnostic_writer output for diagnostic values
+       */
+      template <class Q, class Model, class RNG>
+      void run_advi(Model& model, Eigen::VectorXd& cont_params, RNG& rng,
+                    const std::string& optimizer, int grad_samples,
+                    int elbo_samples, int max_iterations, double tol_rel_obj,
+                    double eta, bool adapt_engaged, int adapt_iterations,
+                    int eval_elbo, int output_samples,
+                    callbacks::logger& logger,
+                    callbacks::writer& parameter_writer,
+                    callbacks::writer& diagnostic_writer) {
+        if (optimizer == "adam" || optimizer == "amsgrad") {
+          stan::variational::advi<Model, Q, RNG,
+                                  stan::variational::adam<Q> >
+            cmd_advi(model, cont_params, rng, grad_samples, elbo_samples,
+                     eval_elbo, output_samples,
+                     stan::variational::adam<Q>(cont_params.size(),
+                                                optimizer == "amsgrad"));
+          cmd_advi.run(eta, adapt_engaged, adapt_iterations,
+                       tol_rel_obj, max_iterations,
+                       logger, parameter_writer, diagnostic_writer);
+        } else if (optimizer == "rmsprop") {
+          stan::variational::advi<Model, Q, RNG,
+                                  stan::variational::rmsprop<Q> >
+            cmd_advi(model, cont_params, rng, grad_samples, elbo_samples,
+                     eval_elbo, output_samples);
+          cmd_advi.run(eta, adapt_engaged, adapt_iterations,
+                       tol_rel_obj, max_iterations,
+                       logger, parameter_writer, diagnostic_writer);
+        } else {
+          stan::variational::advi<Model, Q, RNG>
+            cmd_advi(model, cont_params, rng, grad_samples, elbo_samples,
+                     eval_elbo, output_samples);
+          cmd_advi.run(eta, adapt_engaged, adapt_iterations,
+                       tol_rel_obj, max_iterations,
+                       logger, parameter_writer, diagnostic_writer);
+        }
+      }
+
+    }
+  }
+}
+#endif
@@ -0,0 +1,68 @@
+#ifndef STAN_SERVICES_UTIL_RUN_CHAINS_HPP
+#define STAN_SERVICES_UTIL_RUN_CHAINS_HPP
+
+#include <stan/services/error_codes.hpp>
+#include <stan/util/parallel_for.hpp>
+#include <cstddef>
+#include <vector>
+
+namespace stan {
+  namespace services {
+    namespace util {
+
+      /**
+       * Runs <code>num_chains</code> chains, calling
+       * <code>run_chain(n)</code> for each chain index
+       * <code>n</code> on up to <code>num_threads</code> threads.
+       *
+       * Each chain must only touch its own sampler, random number
+       * generator and writers; the model is shared and is only used
+       * through its <code>const</code> methods.
+       *
+       * @tparam F type of functor with signature <code>int(size_t)</code>
+       *   returning a service return code
+       * @param[in] num_chains number of chains
+       * @param[in] run_chain functor running a single chain
+       * @param[in] num_threads maximum number of threads to use
+       * @return error_codes::OK if all chains were successful,
+       *   otherwise the return code of the first chain which failed
+       */
+      template <class F>
+      int run_chains(size_t num_chains, const F& run_chain, int num_threads) {
+        std::vector<int> return_codes(num_chains, error_codes::OK);
+        stan::util::parallel_for(0, num_chains,
+                                 [&](size_t n) {
+                                   return_codes[n] = run_chain(n);
+                                 },
+                                 num_threads);
+        for (size_t n = 0; n < num_chains; ++n)
+          if (return_codes[n] != error_codes::OK)
+            return return_codes[n];
+        return error_codes::OK;
+      }
+
+      /**
+       * Runs <code>num_chains</code> chains, calling
+       * <code>run_chain(n)</code> for each chain index
+       * <code>n</code>.  Chains run concurrently on a pool of threads
+       * whose size is given by <code>STAN_NUM_THREADS</code> when
+       * compiled with <code>STAN_THREADS</code>; otherwise they run one
+       * after the other on the calling thread.
+       *
+       * @tparam F type of functor with signature <code>int(size_t)</code>
+       *   returning a service return code
+       * @param[in] num_chains number of chains
+       * @param[in] run_chain functor running a single chain
+       * @return error_codes::OK if all chains were successful,
+       *   otherwise the return code of the first chain which failed
+       */
+      template <class F>
+      int run_chains(size_t num_chains, const F& run_chain) {
+        return run_chains(num_chains, run_chain,
+                          stan::util::get_num_autodiff_threads(num_chains));
+      }
+
+    }
+  }
+}
+#endif
@@ -0,0 +1,276 @@
+#ifndef STAN_SERVICES_UTIL_SAMPLER_TIMER_HPP
+#define STAN_SERVICES_UTIL_SAMPLER_TIMER_HPP
+
+#include <stan/mcmc/base_mcmc.hpp>
+#include <stan/mcmc/stepsize_covar_adapter.hpp>
+#include <stan/mcmc/stepsize_var_adapter.hpp>
+#include <stan/mcmc/windowed_adaptation.hpp>
+#include <chrono>
+#include <cstddef>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace stan {
+  namespace services {
+    namespace util {
+
+      /**
+       * Wall clock time taken by one phase of a run and the work the
+       * sampler did in it.
+       */
+      struct sampler_phase {
+        explicit sampler_phase(const std::string& phase_name)
+          : name(phase_name), wall_time(0), num_transitions(0),
+            num_leapfrogs(0), num_gradients(0) {}
+
+        std::string name;
+        double wall_time;
+        long num_transitions;
+        long num_leapfrogs;
+        long num_gradients;
+      };
+
+      /**
+       * Measures the wall clock time of consecutive phases of a run,
+       * such as initialization, step size initialization, each
+       * adaptation window and sampling.  Wall clock time is used
+       * rather than processor time so that time spent on other
+       * threads is not counted.
+       *
+       * The leapfrog steps and gradient evaluations of each phase are
+       * taken from the sampler's running counts whenever the sampler
+       * is passed in, so work done before the sampler is first seen
+       * is not attributed to any phase.
+       */
+      class sampler_timer {
+      public:
+        sampler_timer()
+          : running_(false), num_leapfrogs_(0), num_gradients_(0),
+            next_scheduled_(0) {}
+
+        /**
+         * End the current phase, if any, and start a phase with the
+         * given name.
+         *
+         * @param[in] name name of the phase
+         */
+        void begin(const std::string& name) {
+          end();
+          scheduled_names_.clear();
+          scheduled_lengths_.clear();
+          next_scheduled_ = 0;
+          start(name);
+        }
+
+        /**
+         * Attribute the sampler's work so far to the current phase, if
+         * any, then start a phase with the given name.
+         *
+         * @param[in] name name of the phase
+         * @param[in,out] sampler sampler whose work is counted
+         */
+        void begin(const std::string& name, stan::mcmc::base_mcmc& sampler) {
+          update(sampler);
+          begin(name);
+        }
+
+        /**
+         * Attribute the sampler's work so far to the current phase, if
+         * any, then start a sequence of phases.  Each phase but the
+         * last ends after the given number of transitions have been
+         * recorded; the last continues until the next phase begins.
+         * Phases without transitions are skipped.
+         *
+         * @param[in] names names of the phases
+         * @param[in] num_transitions number of transitions in each phase
+         * @param[in,out] sampler sampler whose work is counted
+         */
+        void begin(const std::vector<std::string>& names,
+                   const std::vector<int>& num_transitions,
+                   stan::mcmc::base_mcmc& sampler) {
+          update(sampler);
+          end();
+          scheduled_names_ = names;
+          scheduled_lengths_ = num_transitions;
+          next_scheduled_ = 0;
+          start_next_scheduled();
+        }
+
+        /**
+         * Count one transition of the sampler in the current phase,
+         * moving on to the next scheduled phase when the current one
+         * is complete.
+         *
+         * @param[in,out] sampler sampler whose work is counted
+         */
+        void record_transition(stan::mcmc::base_mcmc& sampler) {
+          update(sampler);
+          if (!running_)
+            return;
+          ++phases_.back().num_transitions;
+          if (next_scheduled_ > 0
+              && next_scheduled_ < scheduled_names_.size()
+              && phases_.back().num_transitions
+                 >= scheduled_lengths_[next_scheduled_ - 1]) {
+            end();
+            start_next_scheduled();
+          }
+        }
+
+        /**
+         * Add the sampler's work since it was last seen to the current
+         * phase, if any.
+         *
+         * @param[in,out] sampler sampler whose work is counted
+         */
+        void update(stan::mcmc::base_mcmc& sampler) {
+          long num_leapfrogs = sampler.get_num_leapfrogs();
+          long num_gradients = sampler.get_num_gradients();
+          if (running_) {
+            phases_.back().num_leapfrogs += num_leapfrogs - num_leapfrogs_;
+            phases_.back().num_gradients += num_gradients - num_gradients_;
+          }
+          num_leapfrogs_ = num_leapfrogs;
+          num_gradients_ = num_gradients;
+        }
+
+        /**
+         * End the current phase, if any.
+         */
+        void end() {
+          if (!running_)
+            return;
+          phases_.back().wall_time
+            = std::chrono::duration<double>(
+                std::chrono::steady_clock::now() - start_).count();
+          running_ = false;
+        }
+
+        /**
+         * Attribute the sampler's work so far to the current phase and
+         * end it.
+         *
+         * @param[in,out] sampler sampler whose work is counted
+         */
+        void end(stan::mcmc::base_mcmc& sampler) {
+          update(sampler);
+          end();
+        }
+
+        /**
+         * Return the phases timed so far, in order.
+         */
+        const std::vector<sampler_phase>& phases() const {
+          return phases_;
+        }
+
+        /**
+         * Return the total wall time of the phases with indexes in
+         * <code>[first, last)</code>.
+         *
+         * @param[in] first index of the first phase
+         * @param[in] last index one past the last phase
+         * @return wall time in seconds
+         */
+        double wall_time(size_t first, size_t last) const {
+          double total = 0;
+          for (size_t n = first; n < last && n < phases_.size(); ++n)
+            total += phases_[n].wall_time;
+          return total;
+        }
+
+      private:
+        void start(const std::string& name) {
+          phases_.push_back(sampler_phase(name));
+          start_ = std::chrono::steady_clock::now();
+          running_ = true;
+        }
+
+        void start_next_scheduled() {
+          // The last phase is started even if it is empty
+          while (next_scheduled_ + 1 < scheduled_names_.size()
+                 && scheduled_lengths_[next_scheduled_] <= 0)
+            ++next_scheduled_;
+          if (next_scheduled_ < scheduled_names_.size()) {
+            start(scheduled_names_[next_scheduled_]);
+            ++next_scheduled_;
+          }
+        }
+
+        bool running_;
+        std::chrono::steady_clock::time_point start_;
+        long num_leapfrogs_;
+        long num_gradients_;
+        std::vector<sampler_phase> phases_;
+        std::vector<std::string> scheduled_names_;
+        std::vector<int> scheduled_lengths_;
+        size_t next_scheduled_;
+      };
+
+      /**
+       * Return the windowed adaptation of a sampler adapting a
+       * diagonal metric.
+       */
+      inline stan::mcmc::windowed_adaptation*
+      get_windowed_adaptation(stan::mcmc::stepsize_var_adapter* sampler) {
+        return &sampler->get_var_adaptation();
+      }
+
+      /**
+       * Return the windowed adaptation of a sampler adapting a dense
+       * metric.
+       */
+      inline stan::mcmc::windowed_adaptation*
+      get_windowed_adaptation(stan::mcmc::stepsize_covar_adapter* sampler) {
+        return &sampler->get_covar_adaptation();
+      }
+
+      /**
+       * Return null for samplers without windowed adaptation.
+       */
+      inline stan::mcmc::windowed_adaptation*
+      get_windowed_adaptation(void* sampler) {
+        return 0;
+      }
+
+      /**
+       * Split warmup into the phases of the given adaptation schedule:
+       * the initial fast interval, each slow adaptation window and the
+       * final fast interval.  Without a schedule, warmup is a single
+       * phase.
+       *
+       * @param[in] adaptation windowed adaptation, or null
+       * @param[in] num_warmup number of warmup iterations
+       * @param[out] names names of the phases
+       * @param[out] num_transitions number of transitions in each phase
+       */
+      inline void
+      get_warmup_phases(const stan::mcmc::windowed_adaptation* adaptation,
+                        int num_warmup, std::vector<std::string>& names,
+                        std::vector<int>& num_transitions) {
+        names.clear();
+        num_transitions.clear();
+        std::vector<unsigned int> lengths;
+        if (adaptation)
+          lengths = adaptation->stage_lengths();
+        if (lengths.empty()) {
+          names.push_back("warmup");
+          num_transitions.push_back(num_warmup);
+          return;
+        }
+
+        names.push_back("init_buffer");
+        for (size_t n = 1; n + 1 < lengths.size(); ++n) {
+          std::stringstream name;
+          name << "adapt_window_" << n;
+          names.push_back(name.str());
+        }
+        names.push_back("term_buffer");
+        num_transitions.assign(lengths.begin(), lengths.end());
+      }
+
+    }
+  }
+}
+#endif
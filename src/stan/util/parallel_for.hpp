@@ -0,0 +1,129 @@
+#ifndef STAN_UTIL_PARALLEL_FOR_HPP
+#define STAN_UTIL_PARALLEL_FOR_HPP
+
+#include <boost/lexical_cast.hpp>
+#include <cstddef>
+#include <cstdlib>
+#include <exception>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace stan {
+  namespace util {
+
+    /**
+     * Returns the number of threads to use for <code>num_jobs</code>
+     * independent jobs.  The number is read from the
+     * <code>STAN_NUM_THREADS</code> environment variable, following
+     * the convention used by <code>map_rect</code>: if it is not set
+     * one thread is used, if it is set to -1 all hardware threads are
+     * used and otherwise the given positive number of threads is
+     * used.  The result is never larger than <code>num_jobs</code>
+     * and never smaller than one.
+     *
+     * @param[in] num_jobs number of jobs to be run
+     * @return number of threads
+     * @throw std::invalid_argument if <code>STAN_NUM_THREADS</code>
+     *   is not -1 or a positive integer
+     */
+    inline int get_num_threads(int num_jobs) {
+      int num_threads = 1;
+      const char* env = std::getenv("STAN_NUM_THREADS");
+      if (env != NULL) {
+        try {
+          num_threads = boost::lexical_cast<int>(env);
+        } catch (const boost::bad_lexical_cast&) {
+          throw std::invalid_argument("STAN_NUM_THREADS must be a positive "
+                                      "integer or -1, found "
+                                      + std::string(env));
+        }
+        if (num_threads == -1)
+          num_threads = std::thread::hardware_concurrency();
+        else if (num_threads < 1)
+          throw std::invalid_argument("STAN_NUM_THREADS must be a positive "
+                                      "integer or -1, found "
+                                      + std::string(env));
+      }
+      if (num_threads > num_jobs)
+        num_threads = num_jobs;
+      return num_threads < 1 ? 1 : num_threads;
+    }
+
+    /**
+     * Returns the number of threads to use for <code>num_jobs</code>
+     * independent jobs which evaluate the log density with reverse
+     * mode autodiff.  The autodiff stack is only thread local when
+     * compiled with <code>STAN_THREADS</code>, so without it this
+     * always returns one.
+     *
+     * @param[in] num_jobs number of jobs to be run
+     * @return number of threads
+     */
+    inline int get_num_autodiff_threads(int num_jobs) {
+#ifdef STAN_THREADS
+      return get_num_threads(num_jobs);
+#else
+      (void) num_jobs;
+      return 1;
+#endif
+    }
+
+    /**
+     * Calls <code>f(i)</code> for every <code>i</code> in
+     * <code>[begin, end)</code> using up to <code>num_threads</code>
+     * threads.  Indexes are assigned to threads round-robin, so the
+     * jobs must be independent of each other.
+     *
+     * With a single thread the jobs run in order on the calling
+     * thread and the first exception is propagated immediately.
+     * Otherwise, if any job throws, the remaining jobs still run and
+     * the exception of the job with the smallest index is rethrown
+     * once all threads have finished.
+     *
+     * @tparam F type of functor with signature
+     *   <code>void(std::size_t)</code>
+     * @param[in] begin first index
+     * @param[in] end one past the last index
+     * @param[in] f functor to call for each index
+     * @param[in] num_threads maximum number of threads to use
+     */
+    template <class F>
+    void parallel_for(std::size_t begin, std::size_t end, const F& f,
+                      int num_threads) {
+      if (end <= begin)
+        return;
+      std::size_t num_jobs = end - begin;
+      if (num_threads <= 1 || num_jobs == 1) {
+        for (std::size_t i = begin; i < end; ++i)
+          f(i);
+        return;
+      }
+      if (static_cast<std::size_t>(num_threads) > num_jobs)
+        num_threads = num_jobs;
+
+      std::vector<std::exception_ptr> errors(num_jobs);
+      std::vector<std::thread> threads;
+      threads.reserve(num_threads);
+      for (int t = 0; t < num_threads; ++t) {
+        threads.emplace_back([&, t]() {
+            for (std::size_t n = t; n < num_jobs; n += num_threads) {
+              try {
+                f(begin + n);
+              } catch (...) {
+                errors[n] = std::current_exception();
+              }
+            }
+          });
+      }
+      for (std::size_t t = 0; t < threads.size(); ++t)
+        threads[t].join();
+      for (std::size_t n = 0; n < num_jobs; ++n)
+        if (errors[n])
+          std::rethrow_exception(errors[n]);
+    }
+
+  }
+}
+#endif
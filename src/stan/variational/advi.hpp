@@ -6,13 +6,16 @@
 #include <stan/callbacks/writer.hpp>
 #include <stan/callbacks/stream_writer.hpp>
 #include <stan/io/dump.hpp>
+#include <stan/model/log_prob_batch.hpp>
 #include <stan/services/error_codes.hpp>
 #include <stan/variational/print_progress.hpp>
 #include <stan/variational/families/normal_fullrank.hpp>
 #include <stan/variational/families/normal_meanfield.hpp>
+#include <stan/variational/optimizers/stepsize_sequence.hpp>
 #include <boost/circular_buffer.hpp>
 #include <boost/lexical_cast.hpp>
 #include <algorithm>
+#include <exception>
 #include <limits>
 #include <numeric>
 #include <ostream>
@@ -34,8 +37,11 @@ namespace stan {
      * @tparam Model class of model
      * @tparam Q class of variational distribution
      * @tparam BaseRNG class of random number generator
+     * @tparam Optimizer class of the stochastic gradient ascent step,
+     * see <code>stepsize_sequence</code>
      */
-    template <class Model, class Q, class BaseRNG>
+    template <class Model, class Q, class BaseRNG,
+              class Optimizer = stepsize_sequence<Q> >
     class advi {
     public:
       /**
@@ -48,6 +54,8 @@ namespace stan {
        * @param[in] n_monte_carlo_elbo number of samples for ELBO computation
        * @param[in] eval_elbo evaluate ELBO at every "eval_elbo" iters
        * @param[in] n_posterior_samples number of samples to draw from posterior
+       * @param[in] optimizer optimizer, restarted for every run of
+       * stochastic gradient ascent
        * @throw std::runtime_error if n_monte_carlo_grad is not positive
        * @throw std::runtime_error if n_monte_carlo_elbo is not positive
        * @throw std::runtime_error if eval_elbo is not positive
@@ -59,14 +67,16 @@ namespace stan {
            int n_monte_carlo_grad,
            int n_monte_carlo_elbo,
            int eval_elbo,
-           int n_posterior_samples)
+           int n_posterior_samples,
+           const Optimizer& optimizer)
         : model_(m),
           cont_params_(cont_params),
           rng_(rng),
           n_monte_carlo_grad_(n_monte_carlo_grad),
           n_monte_carlo_elbo_(n_monte_carlo_elbo),
           eval_elbo_(eval_elbo),
-          n_posterior_samples_(n_posterior_samples) {
+          n_posterior_samples_(n_posterior_samples),
+          optimizer_(optimizer) {
         static const char* function = "stan::variational::advi";
         math::check_positive(function,
                              "Number of Monte Carlo samples for gradients",
@@ -82,6 +92,37 @@ namespace stan {
                              n_posterior_samples_);
       }
 
+      /**
+       * Constructor with the default optimizer for the dimension of
+       * the model.
+       *
+       * @param[in] m stan model
+       * @param[in] cont_params initialization of continuous parameters
+       * @param[in,out] rng random number generator
+       * @param[in] n_monte_carlo_grad number of samples for gradient
+       * computation
+       * @param[in] n_monte_carlo_elbo number of samples for ELBO computation
+       * @param[in] eval_elbo evaluate ELBO at every "eval_elbo" iters
+       * @param[in] n_posterior_samples number of samples to draw from
+       * posterior
+       * @throw std::runtime_error if n_monte_carlo_grad is not positive
+       * @throw std::runtime_error if n_monte_carlo_elbo is not positive
+       * @throw std::runtime_error if eval_elbo is not positive
+       * @throw std::runtime_error if n_posterior_samples is not positive
+       */
+      advi(Model& m,
+           Eigen::VectorXd& cont_params,
+           BaseRNG& rng,
+           int n_monte_carlo_grad,
+           int n_monte_carlo_elbo,
+           int eval_elbo,
+           int n_posterior_samples)
+        : advi(m, cont_params, rng, n_monte_carlo_grad, n_monte_carlo_elbo,
+               eval_elbo, n_posterior_samples,
+               Optimizer(m.num_params_r())) { }
+
+      virtual ~advi() { }
+
       /**
        * Calculates the Evidence Lower BOund (ELBO) by sampling from
        * the variational distribution and then evaluating the log joint,
@@ -102,30 +143,49 @@ namespace stan {
         static const char* function =
           "stan::variational::advi::calc_ELBO";
 
+        next_minibatch();
+
         double elbo = 0.0;
         int dim = variational.dimension();
         Eigen::VectorXd zeta(dim);
+        Eigen::MatrixXd zetas;
+        Eigen::VectorXd log_probs;
+        std::vector<std::exception_ptr> errors;
 
+        // The draws still missing are made in order and their log
+        // densities evaluated as a batch, which may run in parallel, so
+        // the ELBO does not depend on the number of threads.
         int n_dropped_evaluations = 0;
         for (int i = 0; i < n_monte_carlo_elbo_;) {
-          variational.sample(rng_, zeta);
-          try {
-            std::stringstream ss;
-            double log_prob = model_.template log_prob<false, true>(zeta, &ss);
-            if (ss.str().length() > 0)
-              logger.info(ss);
-            stan::math::check_finite(function, "log_prob", log_prob);
-            elbo += log_prob;
-            ++i;
-          } catch (const std::domain_error& e) {
-            ++n_dropped_evaluations;
-            if (n_dropped_evaluations >= n_monte_carlo_elbo_) {
-              const char* name = "The number of dropped evaluations";
-              const char* msg1 = "has reached its maximum amount (";
-              const char* msg2 = "). Your model may be either severely "
-                "ill-conditioned or misspecified.";
-              stan::math::domain_error(function, name, n_monte_carlo_elbo_,
-                                       msg1, msg2);
+          int n_draws = n_monte_carlo_elbo_ - i;
+          zetas.resize(dim, n_draws);
+          for (int n = 0; n < n_draws; ++n) {
+            variational.sample(rng_, zeta);
+            zetas.col(n) = zeta;
+          }
+          std::stringstream ss;
+          stan::model::log_prob_batch<false, true>(model_, zetas, log_probs,
+                                                   errors, &ss);
+          if (ss.str().length() > 0)
+            logger.info(ss);
+          for (int n = 0; n < n_draws; ++n) {
+            try {
+              if (errors[n])
+                std::rethrow_exception(errors[n]);
+              double log_prob = log_probs(n);
+              stan::math::check_finite(function, "log_prob", log_prob);
+              elbo += log_prob;
+              ++i;
+            } catch (const std::domain_error& e) {
+              ++n_dropped_evaluations;
+              if (n_dropped_evaluations >= n_monte_carlo_elbo_) {
+                const char* name = "The number of dropped evaluations";
+                const char* msg1 = "has reached its maximum amount (";
+                const char* msg2 = "). Your model may be either severely "
+                  "ill-conditioned or misspecified.";
+                stan::math::domain_error(function, name, n_monte_carlo_elbo_,
+                                         msg1, msg2);
+              }
             }
           }
         }
@@ -159,6 +219,7 @@ namespace stan {
                                      "Dimension of variables in model",
                                      cont_params_.size());
 
+        next_minibatch();
         variational.calc_grad(elbo_grad,
                               model_, cont_params_, n_monte_carlo_grad_, rng_,
                               logger);
@@ -210,20 +271,17 @@ namespace stan {
         Q elbo_grad = Q(model_.num_params_r());
 
         // Adaptive step-size sequence
-        Q history_grad_squared = Q(model_.num_params_r());
-        double tau = 1.0;
-        double pre_factor  = 0.9;
-        double post_factor = 0.1;
+        Optimizer optimizer(optimizer_);
 
         double eta_best = 0.0;
         double eta;
-        double eta_scaled;
 
         bool do_more_tuning = true;
         int eta_sequence_index = 0;
         while (do_more_tuning) {
           // Try next eta
           eta = eta_sequence[eta_sequence_index];
+          optimizer.restart();
 
           int print_progress_m;
           for (int iter_tune = 1; iter_tune <= adapt_iterations; ++iter_tune) {
@@ -242,17 +300,8 @@ namespace stan {
               elbo_grad.set_to_zero();
             }
 
-            // Update step-size
-            if (iter_tune == 1) {
-              history_grad_squared += elbo_grad.square();
-            } else {
-              history_grad_squared = pre_factor * history_grad_squared
-                + post_factor * elbo_grad.square();
-            }
-            eta_scaled = eta / sqrt(static_cast<double>(iter_tune));
             // Stochastic gradient update
-            variational += eta_scaled * elbo_grad
-              / (tau + history_grad_squared.sqrt());
+            optimizer.update(variational, elbo_grad, eta);
           }
 
           // (ROBUST) Compute ELBO. It's OK if it has diverged.
@@ -301,8 +350,6 @@ namespace stan {
                 stan::math::domain_error(function, name, "", msg1);
               }
             }
-            // Reset
-            history_grad_squared.set_to_zero();
           }
           ++eta_sequence_index;
           variational = Q(cont_params_);
@@ -311,7 +358,7 @@ namespace stan {
       }
 
       /**
-       * Runs stochastic gradient ascent with an adaptive stepsize sequence.
+       * Runs stochastic gradient ascent with the optimizer.
        *
        * @param[in,out] variational initia variational distribution
        * @param[in] eta stepsize scaling parameter
@@ -343,12 +390,9 @@ namespace stan {
         // Gradient parameters
         Q elbo_grad = Q(model_.num_params_r());
 
-        // Stepsize sequence parameters
-        Q history_grad_squared = Q(model_.num_params_r());
-        double tau = 1.0;
-        double pre_factor  = 0.9;
-        double post_factor = 0.1;
-        double eta_scaled;
+        // Stepsize sequence
+        Optimizer optimizer(optimizer_);
+        optimizer.restart();
 
         // Initialize ELBO and convergence tracking variables
         double elbo(0.0);
@@ -382,18 +426,8 @@ namespace stan {
           // Compute gradient using Monte Carlo integration
           calc_ELBO_grad(variational, elbo_grad, logger);
 
-          // Update step-size
-          if (iter_counter == 1) {
-            history_grad_squared += elbo_grad.square();
-          } else {
-            history_grad_squared = pre_factor * history_grad_squared
-              + post_factor * elbo_grad.square();
-          }
-          eta_scaled = eta / sqrt(static_cast<double>(iter_counter));
-
           // Stochastic gradient update
-          variational += eta_scaled * elbo_grad
-            / (tau + history_grad_squared.sqrt());
+          optimizer.update(variational, elbo_grad, eta);
 
           // Check for convergence every "eval_elbo_"th iteration
           if (iter_counter % eval_elbo_ == 0) {
@@ -506,6 +540,7 @@ namespace stan {
                                    logger, diagnostic_writer);
 
         // Write mean of posterior approximation on first output line
+        full_data();
         cont_params_ = variational.mean();
         std::vector<double> cont_vector(cont_params_.size());
         for (int i = 0; i < cont_params_.size(); ++i)
@@ -580,6 +615,21 @@ namespace stan {
       }
 
     protected:
+      /**
+       * Selects the data the log joint is evaluated on for the next
+       * ELBO or ELBO gradient estimate.  The full data is always used,
+       * so this does nothing; subclasses that subsample the data
+       * override it.
+       */
+      virtual void next_minibatch() const { }
+
+      /**
+       * Selects the full data, on which the draws from the
+       * approximation are written out.  Subclasses that subsample the
+       * data override it.
+       */
+      virtual void full_data() const { }
+
       Model& model_;
       Eigen::VectorXd& cont_params_;
       BaseRNG& rng_;
@@ -587,6 +637,7 @@ namespace stan {
       int n_monte_carlo_elbo_;
       int eval_elbo_;
       int n_posterior_samples_;
+      Optimizer optimizer_;
     };
   }  // variational
 }  // stan
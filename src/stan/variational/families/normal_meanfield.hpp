@@ -3,9 +3,10 @@
 
 #include <stan/callbacks/logger.hpp>
 #include <stan/math/prim/mat.hpp>
-#include <stan/model/gradient.hpp>
+#include <stan/model/log_prob_batch.hpp>
 #include <stan/variational/base_family.hpp>
 #include <algorithm>
+#include <exception>
 #include <ostream>
 #include <vector>
 
@@ -172,6 +173,28 @@ namespace stan {
                                 Eigen::VectorXd(omega_.array().sqrt()));
       }
 
+      /**
+       * Return a new mean field approximation resulting from taking
+       * the elementwise maximum of the entries in the mean and log
+       * standard deviation of this and the specified approximation.
+       * The new approximation does not hold any references to either
+       * approximation.
+       *
+       * @param[in] rhs Approximation to compare with.
+       * @throw std::invalid_argument If the dimensionality of the specified
+       * approximation does not match this approximation's dimensionality.
+       */
+      normal_meanfield max(const normal_meanfield& rhs) const {
+        static const char* function =
+          "stan::variational::normal_meanfield::max";
+        stan::math::check_size_match(function,
+                             "Dimension of lhs", dimension_,
+                             "Dimension of rhs", rhs.dimension());
+        return normal_meanfield(
+            Eigen::VectorXd(mu_.array().max(rhs.mu().array())),
+            Eigen::VectorXd(omega_.array().max(rhs.omega().array())));
+      }
+
       /**
        * Return this approximation after setting its mean vector and
        * Cholesky factor for covariance to the values given by the
@@ -380,36 +403,54 @@ namespace stan {
 
         Eigen::VectorXd mu_grad    = Eigen::VectorXd::Zero(dimension_);
         Eigen::VectorXd omega_grad = Eigen::VectorXd::Zero(dimension_);
-        double tmp_lp = 0.0;
         Eigen::VectorXd tmp_mu_grad = Eigen::VectorXd::Zero(dimension_);
-        Eigen::VectorXd eta  = Eigen::VectorXd::Zero(dimension_);
-        Eigen::VectorXd zeta = Eigen::VectorXd::Zero(dimension_);
-
-        // Naive Monte Carlo integration
+        Eigen::MatrixXd eta;
+        Eigen::MatrixXd zeta;
+        Eigen::VectorXd lp;
+        Eigen::MatrixXd lp_grad;
+        std::vector<std::exception_ptr> errors;
+
+        // Naive Monte Carlo integration.  The draws still missing are
+        // made in order and their gradients evaluated as a batch, which
+        // may run in parallel, so the result does not depend on the
+        // number of threads.
         static const int n_retries = 10;
         for (int i = 0, n_monte_carlo_drop = 0; i < n_monte_carlo_grad; ) {
           // Draw from standard normal and transform to real-coordinate space
-          for (int d = 0; d < dimension_; ++d)
-            eta(d) = stan::math::normal_rng(0, 1, rng);
-          zeta = transform(eta);
-          try {
-            std::stringstream ss;
-            stan::model::gradient(m, zeta, tmp_lp, tmp_mu_grad, &ss);
-            if (ss.str().length() > 0)
-              logger.info(ss);
-            stan::math::check_finite(function, "Gradient of mu", tmp_mu_grad);
-            mu_grad += tmp_mu_grad;
-            omega_grad.array() += tmp_mu_grad.array().cwiseProduct(eta.array());
-            ++i;
-          } catch (const std::exception& e) {
-            ++n_monte_carlo_drop;
-            if (n_monte_carlo_drop >= n_retries * n_monte_carlo_grad) {
-              const char* name = "The number of dropped evaluations";
-              const char* msg1 = "has reached its maximum amount (";
-              int y = n_retries * n_monte_carlo_grad;
-              const char* msg2 = "). Your model may be either severely "
-                "ill-conditioned or misspecified.";
-              stan::math::domain_error(function, name, y, msg1, msg2);
+          int n_draws = n_monte_carlo_grad - i;
+          eta.resize(dimension_, n_draws);
+          zeta.resize(dimension_, n_draws);
+          for (int n = 0; n < n_draws; ++n) {
+            for (int d = 0; d < dimension_; ++d)
+              eta(d, n) = stan::math::normal_rng(0, 1, rng);
+            zeta.col(n) = transform(eta.col(n));
+          }
+          std::stringstream ss;
+          stan::model::log_prob_grad_batch<true, true>(m, zeta, lp, lp_grad,
+                                                       errors, &ss);
+          if (ss.str().length() > 0)
+            logger.info(ss);
+          for (int n = 0; n < n_draws; ++n) {
+            try {
+              if (errors[n])
+                std::rethrow_exception(errors[n]);
+              tmp_mu_grad = lp_grad.col(n);
+              stan::math::check_finite(function, "Gradient of mu",
+                                       tmp_mu_grad);
+              mu_grad += tmp_mu_grad;
+              omega_grad.array()
+                += tmp_mu_grad.array().cwiseProduct(eta.col(n).array());
+              ++i;
+            } catch (const std::exception& e) {
+              ++n_monte_carlo_drop;
+              if (n_monte_carlo_drop >= n_retries * n_monte_carlo_grad) {
+                const char* name = "The number of dropped evaluations";
+                const char* msg1 = "has reached its maximum amount (";
+                int y = n_retries * n_monte_carlo_grad;
+                const char* msg2 = "). Your model may be either severely "
+                  "ill-conditioned or misspecified.";
+                stan::math::domain_error(function, name, y, msg1, msg2);
+              }
             }
           }
         }
@@ -0,0 +1,166 @@
+#ifndef STAN_VARIATIONAL_MINIBATCH_ADVI_HPP
+#define STAN_VARIATIONAL_MINIBATCH_ADVI_HPP
+
+#include <stan/math.hpp>
+#include <stan/variational/advi.hpp>
+#include <boost/random/uniform_int_distribution.hpp>
+#include <set>
+#include <vector>
+
+namespace stan {
+
+  namespace variational {
+
+    /**
+     * Stochastic variational inference: ADVI with the log joint of
+     * every ELBO and ELBO gradient estimate evaluated on a minibatch,
+     * a random subset of the data drawn anew for each estimate, so the
+     * cost of an iteration scales with the minibatch size rather than
+     * the size of the data.
+     *
+     * The model decides which of its data are subsampled and must
+     * provide, besides the usual model interface,
+     *
+     * <code>size_t data_size() const</code>, the number N of
+     * subsampled data items, and
+     *
+     * <code>void set_minibatch(const std::vector<size_t>&
+     * indices)</code>, which selects the items with the specified
+     * indices, between 0 and N - 1, for the following evaluations of
+     * the log joint.
+     *
+     * With B selected indices the model must multiply the sum of
+     * their likelihood terms by N / B, which keeps the log joint, and
+     * with it the ELBO and its gradient, unbiased.  All N indices
+     * select the full data, which is used to write out the draws from
+     * the approximation.
+     *
+     * @tparam Model class of model
+     * @tparam Q class of variational distribution
+     * @tparam BaseRNG class of random number generator
+     * @tparam Optimizer class of the stochastic gradient ascent step
+     */
+    template <class Model, class Q, class BaseRNG,
+              class Optimizer = stepsize_sequence<Q> >
+    class minibatch_advi : public advi<Model, Q, BaseRNG, Optimizer> {
+    public:
+      /**
+       * Constructor
+       *
+       * @param[in] m stan model
+       * @param[in] cont_params initialization of continuous parameters
+       * @param[in,out] rng random number generator
+       * @param[in] n_monte_carlo_grad number of samples for gradient
+       * computation
+       * @param[in] n_monte_carlo_elbo number of samples for ELBO computation
+       * @param[in] eval_elbo evaluate ELBO at every "eval_elbo" iters
+       * @param[in] n_posterior_samples number of samples to draw from
+       * posterior
+       * @param[in] minibatch_size number of data items in a minibatch
+       * @param[in] optimizer optimizer, restarted for every run of
+       * stochastic gradient ascent
+       * @throw std::domain_error if n_monte_carlo_grad is not positive
+       * @throw std::domain_error if n_monte_carlo_elbo is not positive
+       * @throw std::domain_error if eval_elbo is not positive
+       * @throw std::domain_error if n_posterior_samples is not positive
+       * @throw std::domain_error if minibatch_size is not positive or
+       * larger than the size of the data
+       */
+      minibatch_advi(Model& m,
+                     Eigen::VectorXd& cont_params,
+                     BaseRNG& rng,
+                     int n_monte_carlo_grad,
+                     int n_monte_carlo_elbo,
+                     int eval_elbo,
+                     int n_posterior_samples,
+                     int minibatch_size,
+                     const Optimizer& optimizer)
+        : advi<Model, Q, BaseRNG, Optimizer>(m, cont_params, rng,
+                                             n_monte_carlo_grad,
+                                             n_monte_carlo_elbo, eval_elbo,
+                                             n_posterior_samples, optimizer),
+          minibatch_size_(minibatch_size) {
+        static const char* function = "stan::variational::minibatch_advi";
+        math::check_positive(function, "Minibatch size", minibatch_size_);
+        math::check_less_or_equal(function, "Minibatch size",
+                                  static_cast<size_t>(minibatch_size_),
+                                  m.data_size());
+      }
+
+      /**
+       * Constructor with the default optimizer for the dimension of
+       * the model.
+       *
+       * @param[in] m stan model
+       * @param[in] cont_params initialization of continuous parameters
+       * @param[in,out] rng random number generator
+       * @param[in] n_monte_carlo_grad number of samples for gradient
+       * computation
+       * @param[in] n_monte_carlo_elbo number of samples for ELBO computation
+       * @param[in] eval_elbo evaluate ELBO at every "eval_elbo" iters
+       * @param[in] n_posterior_samples number of samples to draw from
+       * posterior
+       * @param[in] minibatch_size number of data items in a minibatch
+       * @throw std::domain_error if n_monte_carlo_grad is not positive
+       * @throw std::domain_error if n_monte_carlo_elbo is not positive
+       * @throw std::domain_error if eval_elbo is not positive
+       * @throw std::domain_error if n_posterior_samples is not positive
+       * @throw std::domain_error if minibatch_size is not positive or
+       * larger than the size of the data
+       */
+      minibatch_advi(Model& m,
+                     Eigen::VectorXd& cont_params,
+                     BaseRNG& rng,
+                     int n_monte_carlo_grad,
+                     int n_monte_carlo_elbo,
+                     int eval_elbo,
+                     int n_posterior_samples,
+                     int minibatch_size)
+        : minibatch_advi(m, cont_params, rng, n_monte_carlo_grad,
+                         n_monte_carlo_elbo, eval_elbo, n_posterior_samples,
+                         minibatch_size, Optimizer(m.num_params_r())) { }
+
+      /**
+       * Return the indices of the current minibatch in increasing
+       * order.
+       *
+       * @return indices of the current minibatch
+       */
+      const std::vector<size_t>& minibatch() const {
+        return minibatch_;
+      }
+
+    protected:
+      /**
+       * Draws minibatch_size_ distinct indices uniformly at random
+       * with Floyd's algorithm, which takes one draw from the random
+       * number generator per index, and selects them in the model.
+       */
+      void next_minibatch() const {
+        size_t N = this->model_.data_size();
+        std::set<size_t> indices;
+        for (size_t j = N - minibatch_size_; j < N; ++j) {
+          boost::random::uniform_int_distribution<size_t> uniform(0, j);
+          if (!indices.insert(uniform(this->rng_)).second)
+            indices.insert(j);
+        }
+        minibatch_.assign(indices.begin(), indices.end());
+        this->model_.set_minibatch(minibatch_);
+      }
+
+      /**
+       * Selects all indices in the model.
+       */
+      void full_data() const {
+        minibatch_.resize(this->model_.data_size());
+        for (size_t n = 0; n < minibatch_.size(); ++n)
+          minibatch_[n] = n;
+        this->model_.set_minibatch(minibatch_);
+      }
+
+      int minibatch_size_;
+      mutable std::vector<size_t> minibatch_;
+    };
+  }  // variational
+}  // stan
+#endif
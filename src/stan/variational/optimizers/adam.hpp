@@ -0,0 +1,93 @@
+#ifndef STAN_VARIATIONAL_OPTIMIZERS_ADAM_HPP
+#define STAN_VARIATIONAL_OPTIMIZERS_ADAM_HPP
+
+#include <cmath>
+#include <cstddef>
+
+namespace stan {
+
+  namespace variational {
+
+    /**
+     * The Adam optimizer of Kingma and Ba (2015), and optionally its
+     * AMSGrad variant of Reddi et al. (2018).
+     *
+     * Each parameter of the variational approximation moves by eta
+     * times the bias-corrected running average of its gradients over
+     * the root of the bias-corrected running average of its squared
+     * gradients, so the size of the steps does not depend on the scale
+     * of the gradients.  AMSGrad divides by the largest such root seen
+     * so far instead, so the step sizes never grow.
+     *
+     * @tparam Q class of variational distribution
+     */
+    template <class Q>
+    class adam {
+    public:
+      /**
+       * Construct the optimizer for an approximation of the specified
+       * dimension.
+       *
+       * @param[in] dimension dimension of the approximation
+       * @param[in] amsgrad true for AMSGrad
+       * @param[in] beta1 decay rate of the average of the gradients
+       * @param[in] beta2 decay rate of the average of the squared
+       * gradients
+       * @param[in] epsilon offset of the root of the average of the
+       * squared gradients
+       */
+      explicit adam(size_t dimension, bool amsgrad = false,
+                    double beta1 = 0.9, double beta2 = 0.999,
+                    double epsilon = 1e-8)
+        : grad_(dimension), grad_squared_(dimension),
+          max_grad_squared_(dimension), iteration_(0), amsgrad_(amsgrad),
+          beta1_(beta1), beta2_(beta2), epsilon_(epsilon) { }
+
+      /**
+       * Forget the gradients seen so far, so that the next update is
+       * the first.
+       */
+      void restart() {
+        grad_.set_to_zero();
+        grad_squared_.set_to_zero();
+        max_grad_squared_.set_to_zero();
+        iteration_ = 0;
+      }
+
+      /**
+       * Take a step along the specified gradient of the ELBO.
+       *
+       * @param[in,out] variational approximation to update
+       * @param[in] elbo_grad gradient of the ELBO
+       * @param[in] eta step size
+       */
+      void update(Q& variational, const Q& elbo_grad, double eta) {
+        ++iteration_;
+        grad_ = beta1_ * grad_ + (1 - beta1_) * elbo_grad;
+        grad_squared_ = beta2_ * grad_squared_
+          + (1 - beta2_) * elbo_grad.square();
+        Q grad_hat = (1 / (1 - std::pow(beta1_, iteration_))) * grad_;
+        Q grad_squared_hat
+          = (1 / (1 - std::pow(beta2_, iteration_))) * grad_squared_;
+        if (amsgrad_) {
+          max_grad_squared_ = max_grad_squared_.max(grad_squared_hat);
+          grad_squared_hat = max_grad_squared_;
+        }
+        variational += eta * grad_hat
+          / (epsilon_ + grad_squared_hat.sqrt());
+      }
+
+    private:
+      Q grad_;
+      Q grad_squared_;
+      Q max_grad_squared_;
+      int iteration_;
+      bool amsgrad_;
+      double beta1_;
+      double beta2_;
+      double epsilon_;
+    };
+
+  }
+}
+#endif
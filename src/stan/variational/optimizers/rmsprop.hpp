@@ -0,0 +1,73 @@
+#ifndef STAN_VARIATIONAL_OPTIMIZERS_RMSPROP_HPP
+#define STAN_VARIATIONAL_OPTIMIZERS_RMSPROP_HPP
+
+#include <cstddef>
+
+namespace stan {
+
+  namespace variational {
+
+    /**
+     * RMSProp with momentum.
+     *
+     * Each gradient is divided by the root of a running average of
+     * the squared gradients, scaled by eta and added to a velocity
+     * that decays by the momentum at every step; the approximation
+     * moves by the velocity.
+     *
+     * @tparam Q class of variational distribution
+     */
+    template <class Q>
+    class rmsprop {
+    public:
+      /**
+       * Construct the optimizer for an approximation of the specified
+       * dimension.
+       *
+       * @param[in] dimension dimension of the approximation
+       * @param[in] rho decay rate of the average of the squared
+       * gradients
+       * @param[in] momentum decay rate of the velocity
+       * @param[in] epsilon offset of the root of the average of the
+       * squared gradients
+       */
+      explicit rmsprop(size_t dimension, double rho = 0.9,
+                       double momentum = 0.9, double epsilon = 1e-8)
+        : grad_squared_(dimension), velocity_(dimension), rho_(rho),
+          momentum_(momentum), epsilon_(epsilon) { }
+
+      /**
+       * Forget the gradients seen so far, so that the next update is
+       * the first.
+       */
+      void restart() {
+        grad_squared_.set_to_zero();
+        velocity_.set_to_zero();
+      }
+
+      /**
+       * Take a step along the specified gradient of the ELBO.
+       *
+       * @param[in,out] variational approximation to update
+       * @param[in] elbo_grad gradient of the ELBO
+       * @param[in] eta step size
+       */
+      void update(Q& variational, const Q& elbo_grad, double eta) {
+        grad_squared_ = rho_ * grad_squared_
+          + (1 - rho_) * elbo_grad.square();
+        velocity_ = momentum_ * velocity_
+          + eta * elbo_grad / (epsilon_ + grad_squared_.sqrt());
+        variational += velocity_;
+      }
+
+    private:
+      Q grad_squared_;
+      Q velocity_;
+      double rho_;
+      double momentum_;
+      double epsilon_;
+    };
+
+  }
+}
+#endif
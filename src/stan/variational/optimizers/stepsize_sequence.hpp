@@ -0,0 +1,79 @@
+#ifndef STAN_VARIATIONAL_OPTIMIZERS_STEPSIZE_SEQUENCE_HPP
+#define STAN_VARIATIONAL_OPTIMIZERS_STEPSIZE_SEQUENCE_HPP
+
+#include <cmath>
+#include <cstddef>
+
+namespace stan {
+
+  namespace variational {
+
+    /**
+     * The adaptive step-size sequence of Kucukelbir et al. (2017),
+     * the original optimizer of ADVI.
+     *
+     * The step size of each parameter of the variational
+     * approximation is eta / sqrt(t) divided by one plus the root of a
+     * weighted running average of its squared gradients, which puts
+     * most weight on the recent gradients.
+     *
+     * @tparam Q class of variational distribution
+     */
+    template <class Q>
+    class stepsize_sequence {
+    public:
+      /**
+       * Construct the sequence for an approximation of the specified
+       * dimension.
+       *
+       * @param[in] dimension dimension of the approximation
+       * @param[in] tau offset of the root of the running average
+       * @param[in] pre_factor weight of the previous running average
+       * @param[in] post_factor weight of the new squared gradient
+       */
+      explicit stepsize_sequence(size_t dimension, double tau = 1.0,
+                                 double pre_factor = 0.9,
+                                 double post_factor = 0.1)
+        : history_grad_squared_(dimension), iteration_(0), tau_(tau),
+          pre_factor_(pre_factor), post_factor_(post_factor) { }
+
+      /**
+       * Forget the gradients seen so far, so that the next update is
+       * the first.
+       */
+      void restart() {
+        history_grad_squared_.set_to_zero();
+        iteration_ = 0;
+      }
+
+      /**
+       * Take a step along the specified gradient of the ELBO.
+       *
+       * @param[in,out] variational approximation to update
+       * @param[in] elbo_grad gradient of the ELBO
+       * @param[in] eta step-size scaling parameter
+       */
+      void update(Q& variational, const Q& elbo_grad, double eta) {
+        ++iteration_;
+        if (iteration_ == 1) {
+          history_grad_squared_ += elbo_grad.square();
+        } else {
+          history_grad_squared_ = pre_factor_ * history_grad_squared_
+            + post_factor_ * elbo_grad.square();
+        }
+        double eta_scaled = eta / std::sqrt(static_cast<double>(iteration_));
+        variational += eta_scaled * elbo_grad
+          / (tau_ + history_grad_squared_.sqrt());
+      }
+
+    private:
+      Q history_grad_squared_;
+      int iteration_;
+      double tau_;
+      double pre_factor_;
+      double post_factor_;
+    };
+
+  }
+}
+#endif
@@ -0,0 +1,86 @@
+/**
+ * Performance test: gradient evaluation overhead.
+ *
+ * This test times gradients of the log density of a model with
+ * independent standard normal parameters, for which the model itself
+ * costs next to nothing, through stan::model::gradient and through a
+ * stan::model::gradient_evaluator. The difference is the per gradient
+ * overhead that the evaluator saves on every leapfrog step.
+ *
+ * The time per gradient for each model size is printed to stdout.
+ */
+
+#include <stan/model/gradient.hpp>
+#include <stan/model/gradient_evaluator.hpp>
+#include <stan/model/prob_grad.hpp>
+#include <stan/callbacks/stream_logger.hpp>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+class std_normal_model : public stan::model::prob_grad {
+public:
+  explicit std_normal_model(size_t num_params_r)
+    : stan::model::prob_grad(num_params_r) { }
+
+  template <bool propto, bool jacobian_adjust_transforms, typename T>
+  T log_prob(std::vector<T>& params_r, std::vector<int>& params_i,
+             std::ostream* output_stream = 0) const {
+    T lp(0);
+    for (size_t i = 0; i < params_r.size(); ++i)
+      lp -= 0.5 * params_r[i] * params_r[i];
+    return lp;
+  }
+
+  template <bool propto, bool jacobian_adjust_transforms, typename T>
+  T log_prob(Eigen::Matrix<T, Eigen::Dynamic, 1>& params_r,
+             std::ostream* output_stream = 0) const {
+    std::vector<T> vec_params_r(params_r.data(),
+                                params_r.data() + params_r.size());
+    std::vector<int> vec_params_i;
+    return log_prob<propto, jacobian_adjust_transforms>(vec_params_r,
+                                                        vec_params_i,
+                                                        output_stream);
+  }
+};
+
+TEST(performance, gradient_evaluator) {
+  std::stringstream debug, info, warn, error, fatal;
+  stan::callbacks::stream_logger logger(debug, info, warn, error, fatal);
+
+  const int num_gradients = 100000;
+  for (int model_size = 1; model_size <= 100; model_size *= 10) {
+    std_normal_model model(model_size);
+    Eigen::VectorXd x = Eigen::VectorXd::Ones(model_size);
+    Eigen::VectorXd g;
+    double f;
+
+    std::chrono::steady_clock::time_point start
+      = std::chrono::steady_clock::now();
+    for (int n = 0; n < num_gradients; ++n)
+      stan::model::gradient(model, x, f, g, logger);
+    std::chrono::steady_clock::time_point end
+      = std::chrono::steady_clock::now();
+    double ns_gradient
+      = std::chrono::duration<double, std::nano>(end - start).count()
+        / num_gradients;
+
+    stan::model::gradient_evaluator<std_normal_model> evaluator(model);
+    start = std::chrono::steady_clock::now();
+    for (int n = 0; n < num_gradients; ++n)
+      f = evaluator.eval(x, g, logger);
+    end = std::chrono::steady_clock::now();
+    double ns_evaluator
+      = std::chrono::duration<double, std::nano>(end - start).count()
+        / num_gradients;
+
+    EXPECT_FLOAT_EQ(-0.5 * model_size, f);
+    EXPECT_FLOAT_EQ(-1, g(model_size - 1));
+    std::cout << "model size: " << model_size
+              << ", nanoseconds per gradient: " << ns_gradient
+              << " with gradient, " << ns_evaluator
+              << " with gradient_evaluator" << std::endl;
+  }
+}
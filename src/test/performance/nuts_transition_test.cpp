@@ -0,0 +1,76 @@
+/**
+ * Performance test: NUTS transition overhead.
+ *
+ * This test times NUTS transitions for a mock model whose gradient
+ * and integrator cost next to nothing and whose trajectories always
+ * expand to the maximum tree depth. The run time therefore measures
+ * the overhead of building trajectories in base_nuts, which dominates
+ * for low dimensional models with cheap gradients.
+ *
+ * The time per transition for each tree depth is printed to stdout.
+ */
+
+#include <test/unit/mcmc/hmc/mock_hmc.hpp>
+#include <stan/callbacks/stream_logger.hpp>
+#include <stan/mcmc/hmc/nuts/base_nuts.hpp>
+#include <boost/random/additive_combine.hpp>
+#include <gtest/gtest.h>
+#include <chrono>
+#include <iostream>
+#include <sstream>
+
+typedef boost::ecuyer1988 rng_t;
+
+namespace stan {
+  namespace mcmc {
+
+    class mock_nuts: public base_nuts<mock_model,
+                                      mock_hamiltonian,
+                                      mock_integrator,
+                                      rng_t> {
+    public:
+      mock_nuts(const mock_model &m, rng_t& rng)
+        : base_nuts<mock_model, mock_hamiltonian, mock_integrator, rng_t>(m,
+                                                                          rng)
+      { }
+    };
+
+  }
+}
+
+TEST(performance, nuts_transition) {
+  std::stringstream debug, info, warn, error, fatal;
+  stan::callbacks::stream_logger logger(debug, info, warn, error, fatal);
+
+  const int num_transitions = 200;
+  for (int model_size = 1; model_size <= 100; model_size *= 10) {
+    for (int max_depth = 4; max_depth <= 10; max_depth += 3) {
+      rng_t base_rng(0);
+      stan::mcmc::mock_model model(model_size);
+      stan::mcmc::mock_nuts sampler(model, base_rng);
+      sampler.set_nominal_stepsize(1);
+      sampler.set_max_depth(max_depth);
+      // the mock Hamiltonian never resamples the momentum
+      sampler.z().p.setOnes();
+
+      Eigen::VectorXd q = Eigen::VectorXd::Zero(model_size);
+      stan::mcmc::sample s(q, 0, 0);
+
+      std::chrono::steady_clock::time_point start
+        = std::chrono::steady_clock::now();
+      for (int n = 0; n < num_transitions; ++n)
+        s = sampler.transition(s, logger);
+      std::chrono::steady_clock::time_point end
+        = std::chrono::steady_clock::now();
+
+      double us_per_transition
+        = std::chrono::duration<double, std::micro>(end - start).count()
+          / num_transitions;
+      EXPECT_EQ(max_depth, sampler.depth_);
+      std::cout << "model size: " << model_size
+                << ", max depth: " << max_depth
+                << ", microseconds per transition: " << us_per_transition
+                << std::endl;
+    }
+  }
+}
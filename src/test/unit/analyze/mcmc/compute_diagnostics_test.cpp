@@ -0,0 +1,124 @@
+#include <stan/analyze/mcmc/compute_diagnostics.hpp>
+#include <stan/io/stan_csv_reader.hpp>
+#include <gtest/gtest.h>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+class ComputeDiagnostics : public testing::Test {
+public:
+  void SetUp() {
+    std::ifstream blocker1_stream(
+        "src/test/unit/mcmc/test_csv_files/blocker.1.csv");
+    std::ifstream blocker2_stream(
+        "src/test/unit/mcmc/test_csv_files/blocker.2.csv");
+    std::stringstream out;
+    draws.push_back(
+        stan::io::stan_csv_reader::parse(blocker1_stream, &out).samples);
+    draws.push_back(
+        stan::io::stan_csv_reader::parse(blocker2_stream, &out).samples);
+    EXPECT_EQ("", out.str());
+
+    n_eff.resize(48);
+    n_eff << 466.099,136.953,1170.390,541.256,
+      518.051,589.244,764.813,688.294,
+      323.777,502.892,353.823,588.142,
+      654.336,480.914,176.978,182.649,
+      642.389,470.949,561.947,581.187,
+      446.389,397.641,338.511,678.772,
+      1442.250,837.956,869.865,951.124,
+      619.336,875.805,233.260,786.568,
+      910.144,231.582,907.666,747.347,
+      720.660,195.195,944.547,767.271,
+      723.665,1077.030,470.903,954.924,
+      497.338,583.539,697.204,98.421;
+
+    rhat.resize(48);
+    rhat <<
+      1.00718,1.00473,0.999203,1.00061,1.00378,
+      1.01031,1.00173,1.0045,1.00111,1.00337,
+      1.00546,1.00105,1.00558,1.00463,1.00534,
+      1.01244,1.00174,1.00718,1.00186,1.00554,
+      1.00436,1.00147,1.01017,1.00162,1.00143,
+      1.00058,0.999221,1.00012,1.01028,1.001,
+      1.00305,1.00435,1.00055,1.00246,1.00447,
+      1.0048,1.00209,1.01159,1.00202,1.00077,
+      1.0021,1.00262,1.00308,1.00197,1.00246,
+      1.00085,1.00047,1.00735;
+  }
+
+  std::vector<Eigen::MatrixXd> draws;
+  Eigen::VectorXd n_eff;
+  Eigen::VectorXd rhat;
+};
+
+TEST_F(ComputeDiagnostics, blocker) {
+  Eigen::VectorXd ess;
+  Eigen::VectorXd split_rhat;
+  stan::analyze::compute_diagnostics(draws, ess, split_rhat, 1);
+  ASSERT_EQ(draws[0].cols(), ess.size());
+  ASSERT_EQ(draws[0].cols(), split_rhat.size());
+  for (int index = 4; index < ess.size(); ++index) {
+    EXPECT_NEAR(n_eff(index - 4), ess(index), 0.01)
+      << "n_effective for index: " << index;
+    EXPECT_NEAR(rhat(index - 4), split_rhat(index), 1e-4)
+      << "rhat for index: " << index;
+  }
+}
+
+TEST_F(ComputeDiagnostics, threads) {
+  Eigen::VectorXd ess;
+  Eigen::VectorXd split_rhat;
+  stan::analyze::compute_diagnostics(draws, ess, split_rhat, 1);
+
+  Eigen::VectorXd threaded_ess;
+  Eigen::VectorXd threaded_split_rhat;
+  stan::analyze::compute_diagnostics(draws, threaded_ess,
+                                     threaded_split_rhat, 5);
+  EXPECT_TRUE(ess == threaded_ess);
+  EXPECT_TRUE(split_rhat == threaded_split_rhat);
+}
+
+TEST_F(ComputeDiagnostics, blocks) {
+  // trailing draws of each chain, as kept draws follow the warmup
+  std::vector<Eigen::Block<const Eigen::MatrixXd> > kept;
+  for (size_t chain = 0; chain < draws.size(); ++chain) {
+    const Eigen::MatrixXd& chain_draws = draws[chain];
+    kept.push_back(chain_draws.bottomRows(701));
+  }
+
+  Eigen::VectorXd ess;
+  Eigen::VectorXd split_rhat;
+  stan::analyze::compute_diagnostics(kept, ess, split_rhat, 2);
+
+  std::vector<Eigen::MatrixXd> copies(kept.begin(), kept.end());
+  stan::analyze::diagnostics_workspace workspace;
+  for (int index = 0; index < ess.size(); ++index) {
+    double param_ess;
+    double param_split_rhat;
+    stan::analyze::compute_diagnostics(copies, index, workspace, param_ess,
+                                       param_split_rhat);
+    EXPECT_FLOAT_EQ(param_ess, ess(index));
+    EXPECT_FLOAT_EQ(param_split_rhat, split_rhat(index));
+  }
+}
+
+TEST_F(ComputeDiagnostics, invalid) {
+  Eigen::VectorXd ess;
+  Eigen::VectorXd split_rhat;
+  std::vector<Eigen::MatrixXd> none;
+  EXPECT_THROW(stan::analyze::compute_diagnostics(none, ess, split_rhat, 1),
+               std::invalid_argument);
+
+  std::vector<Eigen::MatrixXd> mismatched(draws);
+  mismatched[1].conservativeResize(Eigen::NoChange, 3);
+  EXPECT_THROW(stan::analyze::compute_diagnostics(mismatched, ess,
+                                                  split_rhat, 1),
+               std::invalid_argument);
+
+  std::vector<Eigen::MatrixXd> short_chains(1, draws[0].topRows(3));
+  EXPECT_THROW(stan::analyze::compute_diagnostics(short_chains, ess,
+                                                  split_rhat, 1),
+               std::invalid_argument);
+}
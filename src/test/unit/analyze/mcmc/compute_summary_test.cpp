@@ -0,0 +1,142 @@
+#include <stan/analyze/mcmc/compute_summary.hpp>
+#include <stan/io/stan_csv_reader.hpp>
+#include <gtest/gtest.h>
+#include <boost/accumulators/accumulators.hpp>
+#include <boost/accumulators/statistics/stats.hpp>
+#include <boost/accumulators/statistics/tail_quantile.hpp>
+#include <boost/random/additive_combine.hpp>
+#include <boost/random/normal_distribution.hpp>
+#include <boost/random/variate_generator.hpp>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+namespace {
+  // quantile from the boost tail accumulators, as chains used to compute
+  double tail_quantile(const std::vector<double>& x, double prob) {
+    using boost::accumulators::accumulator_set;
+    using boost::accumulators::left;
+    using boost::accumulators::quantile_probability;
+    using boost::accumulators::right;
+    using boost::accumulators::stats;
+    using boost::accumulators::tag::tail;
+    using boost::accumulators::tag::tail_quantile;
+    if (prob < 0.5) {
+      accumulator_set<double, stats<tail_quantile<left> > >
+        acc(tail<left>::cache_size = x.size());
+      for (size_t i = 0; i < x.size(); ++i)
+        acc(x[i]);
+      return boost::accumulators::quantile(acc,
+                                           quantile_probability = prob);
+    }
+    accumulator_set<double, stats<tail_quantile<right> > >
+      acc(tail<right>::cache_size = x.size());
+    for (size_t i = 0; i < x.size(); ++i)
+      acc(x[i]);
+    return boost::accumulators::quantile(acc, quantile_probability = prob);
+  }
+}
+
+TEST(ComputeSummary, quantiles_match_tail_quantiles) {
+  boost::ecuyer1988 rng(1234);
+  boost::variate_generator<boost::ecuyer1988&, boost::normal_distribution<> >
+    normal(rng, boost::normal_distribution<>());
+  Eigen::VectorXd probs(9);
+  probs << 0.025, 0.05, 0.1, 0.25, 0.5, 0.75, 0.9, 0.95, 0.975;
+  int sizes[] = {7, 10, 99, 100, 1000, 1001};
+  for (int s = 0; s < 6; ++s) {
+    std::vector<double> x(sizes[s]);
+    for (size_t i = 0; i < x.size(); ++i)
+      x[i] = normal();
+    std::vector<double> y(x);
+    Eigen::VectorXd q;
+    stan::analyze::compute_quantiles(y, probs, q);
+    ASSERT_EQ(probs.size(), q.size());
+    for (int i = 0; i < probs.size(); ++i)
+      EXPECT_EQ(tail_quantile(x, probs(i)), q(i))
+        << "size " << x.size() << ", prob " << probs(i);
+  }
+}
+
+TEST(ComputeSummary, quantiles_in_any_order) {
+  std::vector<double> x;
+  for (int i = 10; i > 0; --i)
+    x.push_back(i);
+  Eigen::VectorXd probs(5);
+  probs << 0.8, 0.1, 0.5, 0.1, 0.99;
+  Eigen::VectorXd q;
+  stan::analyze::compute_quantiles(x, probs, q);
+  // upper quantiles count down from the largest draw
+  EXPECT_EQ(9, q(0));
+  EXPECT_EQ(1, q(1));
+  EXPECT_EQ(6, q(2));
+  EXPECT_EQ(1, q(3));
+  EXPECT_EQ(10, q(4));
+
+  std::vector<double> one(1, 3.0);
+  stan::analyze::compute_quantiles(one, probs, q);
+  EXPECT_TRUE(std::isnan(q(0)));
+}
+
+class ComputeSummaryBlocker : public testing::Test {
+public:
+  void SetUp() {
+    std::ifstream blocker1_stream(
+        "src/test/unit/mcmc/test_csv_files/blocker.1.csv");
+    std::ifstream blocker2_stream(
+        "src/test/unit/mcmc/test_csv_files/blocker.2.csv");
+    std::stringstream out;
+    draws.push_back(
+        stan::io::stan_csv_reader::parse(blocker1_stream, &out).samples);
+    draws.push_back(
+        stan::io::stan_csv_reader::parse(blocker2_stream, &out).samples);
+    EXPECT_EQ("", out.str());
+    probs.resize(3);
+    probs << 0.05, 0.5, 0.95;
+  }
+
+  std::vector<Eigen::MatrixXd> draws;
+  Eigen::VectorXd probs;
+};
+
+TEST_F(ComputeSummaryBlocker, summary) {
+  std::vector<stan::analyze::parameter_summary> summaries;
+  stan::analyze::compute_summary(draws, probs, summaries, 3);
+  ASSERT_EQ(static_cast<size_t>(draws[0].cols()), summaries.size());
+
+  Eigen::VectorXd ess, split_rhat;
+  stan::analyze::compute_diagnostics(draws, ess, split_rhat, 1);
+  for (int index = 0; index < draws[0].cols(); ++index) {
+    Eigen::VectorXd x(2000);
+    x << draws[0].col(index), draws[1].col(index);
+    std::vector<double> sample(x.data(), x.data() + x.size());
+    Eigen::VectorXd q;
+    stan::analyze::compute_quantiles(sample, probs, q);
+
+    const stan::analyze::parameter_summary& summary = summaries[index];
+    EXPECT_FLOAT_EQ(x.mean(), summary.mean);
+    EXPECT_FLOAT_EQ(std::sqrt((x.array() - x.mean()).square().sum() / 1999),
+                    summary.sd);
+    EXPECT_TRUE(q == summary.quantiles);
+    if (index >= 4) {
+      EXPECT_EQ(ess(index), summary.ess);
+      EXPECT_EQ(split_rhat(index), summary.split_rhat);
+      EXPECT_FLOAT_EQ(summary.sd / std::sqrt(ess(index)), summary.mcse);
+    }
+  }
+}
+
+TEST_F(ComputeSummaryBlocker, short_chains) {
+  std::vector<Eigen::MatrixXd> short_draws(1, draws[0].topRows(3));
+  std::vector<stan::analyze::parameter_summary> summaries;
+  stan::analyze::compute_summary(short_draws, probs, summaries, 1);
+  EXPECT_FLOAT_EQ(draws[0].col(5).head(3).mean(), summaries[5].mean);
+  EXPECT_TRUE(std::isnan(summaries[5].ess));
+  EXPECT_TRUE(std::isnan(summaries[5].split_rhat));
+
+  std::vector<Eigen::MatrixXd> none;
+  EXPECT_THROW(stan::analyze::compute_summary(none, probs, summaries, 1),
+               std::invalid_argument);
+}
@@ -0,0 +1,140 @@
+#include <stan/analyze/mcmc/online_diagnostics.hpp>
+#include <gtest/gtest.h>
+#include <boost/random/additive_combine.hpp>
+#include <boost/random/normal_distribution.hpp>
+#include <boost/random/variate_generator.hpp>
+#include <cmath>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+  typedef boost::variate_generator<boost::ecuyer1988&,
+                                   boost::normal_distribution<> > normal_rng;
+
+  // autoregressive draws of each parameter with correlation rho
+  void add_ar1(stan::analyze::online_diagnostics& diagnostics, size_t chain,
+               int num_draws, double rho, unsigned int seed) {
+    boost::ecuyer1988 rng(seed);
+    normal_rng normal(rng, boost::normal_distribution<>());
+    Eigen::VectorXd draw = Eigen::VectorXd::Zero(diagnostics.num_params());
+    for (int n = 0; n < num_draws; ++n) {
+      for (int i = 0; i < draw.size(); ++i)
+        draw(i) = rho * draw(i) + std::sqrt(1 - rho * rho) * normal();
+      diagnostics.add_sample(chain, draw);
+    }
+  }
+}
+
+TEST(OnlineDiagnostics, exact) {
+  stan::analyze::online_diagnostics diagnostics(1, 1, 2);
+  Eigen::VectorXd draw(1);
+  for (int n = 1; n <= 8; ++n) {
+    draw(0) = n;
+    diagnostics.add_sample(0, draw);
+  }
+  EXPECT_EQ(8U, diagnostics.num_draws(0));
+
+  // batches {1, 2, 3, 4} and {5, 6, 7, 8}
+  EXPECT_FLOAT_EQ(8 * 6.0 / (4 * 8.0),
+                  diagnostics.effective_sample_size()(0));
+  double var_between = 4 * 8.0;
+  double var_within = 5.0 / 3.0;
+  EXPECT_FLOAT_EQ(std::sqrt((var_between / var_within + 3) / 4),
+                  diagnostics.split_potential_scale_reduction()(0));
+}
+
+TEST(OnlineDiagnostics, not_enough_draws) {
+  stan::analyze::online_diagnostics diagnostics(2, 3, 4);
+  add_ar1(diagnostics, 0, 100, 0, 1);
+  add_ar1(diagnostics, 1, 1, 0, 2);
+  EXPECT_TRUE(std::isnan(diagnostics.effective_sample_size()(0)));
+  EXPECT_TRUE(std::isnan(diagnostics.split_potential_scale_reduction()(0)));
+  EXPECT_FALSE(diagnostics.converged(0, 100));
+
+  add_ar1(diagnostics, 1, 3, 0, 2);
+  EXPECT_FALSE(std::isnan(diagnostics.effective_sample_size()(0)));
+  EXPECT_FALSE(std::isnan(diagnostics.split_potential_scale_reduction()(0)));
+  // estimates are only trusted after num_batches squared draws
+  EXPECT_FALSE(diagnostics.converged(0, 100));
+  add_ar1(diagnostics, 1, 12, 0, 2);
+  EXPECT_TRUE(diagnostics.converged(0, 100));
+
+  diagnostics.restart();
+  EXPECT_EQ(0U, diagnostics.num_draws(0));
+  EXPECT_FALSE(diagnostics.converged(0, 100));
+}
+
+TEST(OnlineDiagnostics, independent) {
+  stan::analyze::online_diagnostics diagnostics(4, 3);
+  for (size_t chain = 0; chain < 4; ++chain)
+    add_ar1(diagnostics, chain, 4000, 0, chain + 1);
+
+  Eigen::VectorXd ess = diagnostics.effective_sample_size();
+  Eigen::VectorXd rhat = diagnostics.split_potential_scale_reduction();
+  for (int i = 0; i < 3; ++i) {
+    EXPECT_NEAR(16000, ess(i), 0.3 * 16000);
+    EXPECT_NEAR(1, rhat(i), 0.01);
+  }
+  EXPECT_TRUE(diagnostics.converged(5000, 1.01));
+  EXPECT_FALSE(diagnostics.converged(1e6, 1.01));
+  EXPECT_FALSE(diagnostics.converged(5000, 0.9));
+}
+
+TEST(OnlineDiagnostics, autocorrelated) {
+  stan::analyze::online_diagnostics diagnostics(4, 2);
+  for (size_t chain = 0; chain < 4; ++chain)
+    add_ar1(diagnostics, chain, 20000, 0.9, chain + 1);
+
+  double expected = 80000 * (1 - 0.9) / (1 + 0.9);
+  Eigen::VectorXd ess = diagnostics.effective_sample_size();
+  for (int i = 0; i < 2; ++i)
+    EXPECT_NEAR(expected, ess(i), 0.3 * expected);
+}
+
+TEST(OnlineDiagnostics, not_mixed) {
+  stan::analyze::online_diagnostics diagnostics(2, 1);
+  Eigen::VectorXd draw(1);
+  add_ar1(diagnostics, 0, 1000, 0, 1);
+  boost::ecuyer1988 rng(2);
+  normal_rng normal(rng, boost::normal_distribution<>());
+  for (int n = 0; n < 1000; ++n) {
+    draw(0) = 5 + normal();
+    diagnostics.add_sample(1, draw);
+  }
+  EXPECT_GT(diagnostics.split_potential_scale_reduction()(0), 2);
+  EXPECT_FALSE(diagnostics.converged(0, 1.1));
+}
+
+TEST(OnlineDiagnostics, threads) {
+  stan::analyze::online_diagnostics serial(4, 5);
+  for (size_t chain = 0; chain < 4; ++chain)
+    add_ar1(serial, chain, 3000, 0.5, chain + 1);
+
+  stan::analyze::online_diagnostics threaded(4, 5);
+  std::vector<std::thread> threads;
+  for (size_t chain = 0; chain < 4; ++chain)
+    threads.emplace_back([&threaded, chain]() {
+        add_ar1(threaded, chain, 3000, 0.5, chain + 1);
+      });
+  // read while the chains are being updated
+  while (!threaded.converged(0, 100))
+    threaded.split_potential_scale_reduction();
+  for (size_t chain = 0; chain < 4; ++chain)
+    threads[chain].join();
+
+  EXPECT_TRUE(serial.effective_sample_size()
+              == threaded.effective_sample_size());
+  EXPECT_TRUE(serial.split_potential_scale_reduction()
+              == threaded.split_potential_scale_reduction());
+}
+
+TEST(OnlineDiagnostics, invalid) {
+  EXPECT_THROW(stan::analyze::online_diagnostics(0, 1),
+               std::invalid_argument);
+  EXPECT_THROW(stan::analyze::online_diagnostics(1, 1, 1),
+               std::invalid_argument);
+  stan::analyze::online_diagnostics diagnostics(1, 2);
+  EXPECT_THROW(diagnostics.add_sample(0, Eigen::VectorXd::Zero(3)),
+               std::invalid_argument);
+}
@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+#include <stan/callbacks/async_writer.hpp>
+#include <stan/callbacks/stream_writer.hpp>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+  class slow_writer : public stan::callbacks::stream_writer {
+  public:
+    explicit slow_writer(std::ostream& output)
+      : stream_writer(output), throw_on_message(false) {}
+
+    void operator()(const std::vector<double>& state) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      stream_writer::operator()(state);
+    }
+
+    void operator()(const std::string& message) {
+      if (throw_on_message)
+        throw std::runtime_error("write failed");
+      stream_writer::operator()(message);
+    }
+
+    using stream_writer::operator();
+    bool throw_on_message;
+  };
+
+  class blocking_writer : public stan::callbacks::stream_writer {
+  public:
+    explicit blocking_writer(std::ostream& output)
+      : stream_writer(output), released_(false) {}
+
+    void operator()(const std::vector<double>& state) {
+      std::unique_lock<std::mutex> lock(mutex_);
+      released_cv_.wait(lock, [this] { return released_; });
+      stream_writer::operator()(state);
+    }
+
+    void release() {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        released_ = true;
+      }
+      released_cv_.notify_all();
+    }
+
+    using stream_writer::operator();
+
+  private:
+    std::mutex mutex_;
+    std::condition_variable released_cv_;
+    bool released_;
+  };
+}
+
+TEST(StanInterfaceCallbacksAsyncWriter, passes_calls_in_order) {
+  std::stringstream ss;
+  slow_writer output(ss);
+  {
+    stan::callbacks::async_writer writer(output, 2);
+    std::vector<std::string> names;
+    names.push_back("a");
+    names.push_back("b");
+    writer(names);
+    for (int n = 0; n < 10; ++n)
+      writer(std::vector<double>(2, n));
+    writer("done");
+    writer();
+  }
+  EXPECT_EQ("a,b\n0,0\n1,1\n2,2\n3,3\n4,4\n5,5\n6,6\n7,7\n8,8\n9,9\n"
+            "done\n\n", ss.str());
+}
+
+TEST(StanInterfaceCallbacksAsyncWriter, flush) {
+  std::stringstream ss;
+  slow_writer output(ss);
+  stan::callbacks::async_writer writer(output);
+  for (int n = 0; n < 5; ++n)
+    writer(std::vector<double>(1, n));
+  writer.flush();
+  EXPECT_EQ("0\n1\n2\n3\n4\n", ss.str());
+}
+
+TEST(StanInterfaceCallbacksAsyncWriter, does_not_wait_for_output) {
+  std::stringstream ss;
+  blocking_writer output(ss);
+  stan::callbacks::async_writer writer(output, 100);
+  // The output blocks until released, so the calls only return if
+  // they do not wait for it
+  for (int n = 0; n < 50; ++n)
+    writer(std::vector<double>(1, n));
+  EXPECT_EQ("", ss.str());
+  output.release();
+  writer.flush();
+  std::string out = ss.str();
+  EXPECT_EQ(50, std::count(out.begin(), out.end(), '\n'));
+}
+
+TEST(StanInterfaceCallbacksAsyncWriter, rethrows) {
+  std::stringstream ss;
+  slow_writer output(ss);
+  output.throw_on_message = true;
+  stan::callbacks::async_writer writer(output);
+  writer("fails");
+  EXPECT_THROW(writer.flush(), std::runtime_error);
+  EXPECT_NO_THROW(writer(std::vector<double>(1, 0)));
+  EXPECT_NO_THROW(writer.flush());
+  EXPECT_EQ("", ss.str());
+}
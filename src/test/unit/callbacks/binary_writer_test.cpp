@@ -0,0 +1,139 @@
+#include <gtest/gtest.h>
+#include <stan/callbacks/binary_writer.hpp>
+#include <stan/io/stan_binary_format.hpp>
+#include <boost/cstdint.hpp>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+  char read_tag(std::istream& in) {
+    char tag = 0;
+    in.get(tag);
+    return tag;
+  }
+
+  boost::uint64_t read_size(std::istream& in) {
+    boost::uint64_t x = 0;
+    stan::io::stan_binary::read_size(in, x);
+    return x;
+  }
+}
+
+class StanInterfaceCallbacksBinaryWriter: public ::testing::Test {
+public:
+  void SetUp() {
+    ss.str(std::string());
+    ss.clear();
+  }
+
+  void read_magic() {
+    std::string magic(stan::io::stan_binary::magic_size, ' ');
+    ss.read(&magic[0], magic.size());
+    EXPECT_EQ("STANDRW1", magic);
+  }
+
+  std::stringstream ss;
+};
+
+TEST_F(StanInterfaceCallbacksBinaryWriter, names_and_comments) {
+  {
+    stan::callbacks::binary_writer writer(ss);
+    std::vector<std::string> names;
+    names.push_back("lp__");
+    names.push_back("theta.1");
+    writer(names);
+    writer("Adaptation terminated");
+    writer();
+  }
+  read_magic();
+
+  EXPECT_EQ('N', read_tag(ss));
+  EXPECT_EQ(2U, read_size(ss));
+  std::string name;
+  ASSERT_TRUE(stan::io::stan_binary::read_string(ss, name));
+  EXPECT_EQ("lp__", name);
+  ASSERT_TRUE(stan::io::stan_binary::read_string(ss, name));
+  EXPECT_EQ("theta.1", name);
+
+  std::string comment;
+  EXPECT_EQ('C', read_tag(ss));
+  ASSERT_TRUE(stan::io::stan_binary::read_string(ss, comment));
+  EXPECT_EQ("Adaptation terminated", comment);
+  EXPECT_EQ('C', read_tag(ss));
+  ASSERT_TRUE(stan::io::stan_binary::read_string(ss, comment));
+  EXPECT_EQ("", comment);
+
+  EXPECT_EQ(EOF, ss.peek());
+}
+
+TEST_F(StanInterfaceCallbacksBinaryWriter, blocks) {
+  {
+    stan::callbacks::binary_writer writer(ss, 2);
+    for (int n = 0; n < 3; ++n) {
+      std::vector<double> x;
+      x.push_back(n);
+      x.push_back(0.1 * n);
+      writer(x);
+    }
+    writer(std::vector<double>());
+  }
+  read_magic();
+
+  // A full block of two rows, stored by column
+  EXPECT_EQ('D', read_tag(ss));
+  EXPECT_EQ(2U, read_size(ss));
+  EXPECT_EQ(2U, read_size(ss));
+  std::vector<double> values(4);
+  ASSERT_TRUE(stan::io::stan_binary::read_doubles(ss, values.data(), 4));
+  EXPECT_EQ(0, values[0]);
+  EXPECT_EQ(1, values[1]);
+  EXPECT_EQ(0, values[2]);
+  EXPECT_EQ(0.1, values[3]);
+
+  // The remaining row is written on destruction
+  EXPECT_EQ('D', read_tag(ss));
+  EXPECT_EQ(1U, read_size(ss));
+  EXPECT_EQ(2U, read_size(ss));
+  ASSERT_TRUE(stan::io::stan_binary::read_doubles(ss, values.data(), 2));
+  EXPECT_EQ(2, values[0]);
+  EXPECT_EQ(0.1 * 2, values[1]);
+
+  EXPECT_EQ(EOF, ss.peek());
+}
+
+TEST_F(StanInterfaceCallbacksBinaryWriter, comment_flushes_block) {
+  stan::callbacks::binary_writer writer(ss);
+  std::vector<double> x(3, 1.5);
+  writer(x);
+  EXPECT_EQ(stan::io::stan_binary::magic_size, ss.str().size());
+
+  writer("Elapsed Time");
+  read_magic();
+  EXPECT_EQ('D', read_tag(ss));
+  EXPECT_EQ(1U, read_size(ss));
+  EXPECT_EQ(3U, read_size(ss));
+  std::vector<double> values(3);
+  ASSERT_TRUE(stan::io::stan_binary::read_doubles(ss, values.data(), 3));
+  EXPECT_EQ(1.5, values[2]);
+  EXPECT_EQ('C', read_tag(ss));
+}
+
+TEST_F(StanInterfaceCallbacksBinaryWriter, change_of_width) {
+  {
+    stan::callbacks::binary_writer writer(ss);
+    writer(std::vector<double>(2, 1.0));
+    writer(std::vector<double>(3, 2.0));
+  }
+  read_magic();
+  EXPECT_EQ('D', read_tag(ss));
+  EXPECT_EQ(1U, read_size(ss));
+  EXPECT_EQ(2U, read_size(ss));
+  std::vector<double> values(3);
+  ASSERT_TRUE(stan::io::stan_binary::read_doubles(ss, values.data(), 2));
+  EXPECT_EQ('D', read_tag(ss));
+  EXPECT_EQ(1U, read_size(ss));
+  EXPECT_EQ(3U, read_size(ss));
+  ASSERT_TRUE(stan::io::stan_binary::read_doubles(ss, values.data(), 3));
+  EXPECT_EQ(2.0, values[0]);
+}
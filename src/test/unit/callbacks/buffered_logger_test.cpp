@@ -0,0 +1,55 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include <stan/callbacks/buffered_logger.hpp>
+#include <stan/callbacks/stream_logger.hpp>
+
+class StanInterfaceCallbacksBufferedLogger: public ::testing::Test {
+public:
+  StanInterfaceCallbacksBufferedLogger() :
+    logger(debug, info, warn, error, fatal) {}
+
+  void SetUp() {
+    debug.str("");
+    info.str("");
+    warn.str("");
+    error.str("");
+    fatal.str("");
+  }
+
+  void TearDown() { }
+
+  std::stringstream debug, info, warn, error, fatal;
+  stan::callbacks::stream_logger logger;
+  stan::callbacks::buffered_logger buffer;
+};
+
+TEST_F(StanInterfaceCallbacksBufferedLogger, flush) {
+  std::stringstream message;
+  message << "message 2";
+  buffer.info("message 1");
+  buffer.debug(message);
+  buffer.info(message);
+  buffer.warn("message 3");
+  buffer.error("message 4");
+  buffer.fatal(message);
+
+  EXPECT_EQ("", info.str());
+
+  buffer.flush(logger);
+  EXPECT_EQ("message 2\n", debug.str());
+  EXPECT_EQ("message 1\nmessage 2\n", info.str());
+  EXPECT_EQ("message 3\n", warn.str());
+  EXPECT_EQ("message 4\n", error.str());
+  EXPECT_EQ("message 2\n", fatal.str());
+}
+
+TEST_F(StanInterfaceCallbacksBufferedLogger, flush_empties_buffer) {
+  buffer.info("message 1");
+  buffer.flush(logger);
+  buffer.flush(logger);
+  EXPECT_EQ("message 1\n", info.str());
+
+  buffer.info("message 2");
+  buffer.flush(logger);
+  EXPECT_EQ("message 1\nmessage 2\n", info.str());
+}
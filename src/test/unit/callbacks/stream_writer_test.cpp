@@ -1,6 +1,8 @@
 #include <gtest/gtest.h>
 #include <boost/lexical_cast.hpp>
 #include <stan/callbacks/stream_writer.hpp>
+#include <limits>
+#include <sstream>
 
 class StanInterfaceCallbacksStreamWriter: public ::testing::Test {
 public:
@@ -46,3 +48,54 @@ TEST_F(StanInterfaceCallbacksStreamWriter, string) {
   EXPECT_NO_THROW(writer("message"));
   EXPECT_EQ("message\n", ss.str());
 }
+
+TEST_F(StanInterfaceCallbacksStreamWriter, double_vector_stream_precision) {
+  std::vector<double> x;
+  x.push_back(1.0 / 3.0);
+  x.push_back(-2.5e-7);
+  x.push_back(123456789.0);
+  x.push_back(std::numeric_limits<double>::infinity());
+
+  std::stringstream expected;
+  expected << x[0] << "," << x[1] << "," << x[2] << "," << x[3] << "\n";
+  EXPECT_NO_THROW(writer(x));
+  EXPECT_EQ(expected.str(), ss.str());
+
+  ss.str(std::string());
+  ss.precision(10);
+  expected.str(std::string());
+  expected.precision(10);
+  expected << x[0] << "," << x[1] << "," << x[2] << "," << x[3] << "\n";
+  EXPECT_NO_THROW(writer(x));
+  EXPECT_EQ(expected.str(), ss.str());
+
+  ss.str(std::string());
+  ss << std::scientific;
+  expected.str(std::string());
+  expected << std::scientific;
+  expected << x[0] << "," << x[1] << "," << x[2] << "," << x[3] << "\n";
+  EXPECT_NO_THROW(writer(x));
+  EXPECT_EQ(expected.str(), ss.str());
+}
+
+TEST_F(StanInterfaceCallbacksStreamWriter, double_vector_precision) {
+  stan::callbacks::stream_writer writer_3(ss, "", 3);
+  std::vector<double> x;
+  x.push_back(1.0 / 3.0);
+  x.push_back(12345);
+  EXPECT_NO_THROW(writer_3(x));
+  EXPECT_EQ("0.333,1.23e+04\n", ss.str());
+}
+
+TEST_F(StanInterfaceCallbacksStreamWriter, double_vector_shortest) {
+  stan::callbacks::stream_writer
+    writer_shortest(ss, "",
+                    stan::callbacks::stream_writer::shortest_precision);
+  std::vector<double> x;
+  x.push_back(0.1);
+  x.push_back(1.0 / 3.0);
+  x.push_back(-1e-300);
+  x.push_back(2);
+  EXPECT_NO_THROW(writer_shortest(x));
+  EXPECT_EQ("0.1,0.3333333333333333,-1e-300,2\n", ss.str());
+}
@@ -0,0 +1,168 @@
+#include <stan/io/binary_var_context.hpp>
+#include <stan/io/dump.hpp>
+#include <stan/io/json/json_data.hpp>
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+class StanIoBinaryVarContext : public testing::Test {
+public:
+  void SetUp() {
+    std::stringstream in("N <- 3\n"
+                         "y <- c(1.5, -2, 3.25)\n"
+                         "z <- structure(c(1, 2, 3, 4, 5, 6), .Dim = c(2, 3))\n"
+                         "mu <- 0.5\n");
+    stan::io::dump dump(in);
+    std::stringstream out;
+    stan::io::binary_var_context::write(dump, out);
+    bytes = out.str();
+  }
+
+  void expect_matches(const stan::io::var_context& context) {
+    std::vector<std::string> names;
+    context.names_i(names);
+    ASSERT_EQ(2U, names.size());
+    EXPECT_EQ("N", names[0]);
+    EXPECT_EQ("z", names[1]);
+    context.names_r(names);
+    ASSERT_EQ(2U, names.size());
+    EXPECT_EQ("mu", names[0]);
+    EXPECT_EQ("y", names[1]);
+
+    EXPECT_TRUE(context.contains_i("N"));
+    EXPECT_TRUE(context.contains_r("N"));
+    EXPECT_FALSE(context.contains_i("y"));
+    EXPECT_FALSE(context.contains_r("x"));
+    EXPECT_EQ(3, context.vals_i("N")[0]);
+    EXPECT_EQ(0U, context.dims_i("N").size());
+    EXPECT_FLOAT_EQ(0.5, context.vals_r("mu")[0]);
+
+    std::vector<double> y = context.vals_r("y");
+    ASSERT_EQ(3U, y.size());
+    EXPECT_FLOAT_EQ(1.5, y[0]);
+    EXPECT_FLOAT_EQ(-2, y[1]);
+    EXPECT_FLOAT_EQ(3.25, y[2]);
+    ASSERT_EQ(1U, context.dims_r("y").size());
+    EXPECT_EQ(3U, context.dims_r("y")[0]);
+
+    std::vector<int> z = context.vals_i("z");
+    ASSERT_EQ(6U, z.size());
+    for (int i = 0; i < 6; ++i)
+      EXPECT_EQ(i + 1, z[i]);
+    std::vector<double> z_r = context.vals_r("z");
+    EXPECT_FLOAT_EQ(6, z_r[5]);
+    std::vector<size_t> dims = context.dims_i("z");
+    ASSERT_EQ(2U, dims.size());
+    EXPECT_EQ(2U, dims[0]);
+    EXPECT_EQ(3U, dims[1]);
+
+    std::vector<double> vals_r;
+    std::vector<int> vals_i;
+    ASSERT_TRUE(context.lookup_r("z", vals_r, dims));
+    EXPECT_EQ(z_r, vals_r);
+    ASSERT_TRUE(context.lookup_i("z", vals_i, dims));
+    EXPECT_EQ(z, vals_i);
+    EXPECT_EQ(2U, dims.size());
+    EXPECT_FALSE(context.lookup_i("y", vals_i, dims));
+    EXPECT_FALSE(context.lookup_r("x", vals_r, dims));
+  }
+
+  std::string bytes;
+};
+
+TEST_F(StanIoBinaryVarContext, round_trip_dump) {
+  stan::io::binary_var_context context(bytes.data(), bytes.size());
+  expect_matches(context);
+}
+
+TEST_F(StanIoBinaryVarContext, round_trip_json) {
+  std::stringstream in("{ \"N\": 3, \"y\": [1.5, -2, 3.25],"
+                       " \"z\": [[1, 3, 5], [2, 4, 6]], \"mu\": 0.5 }");
+  stan::json::json_data json(in);
+  std::stringstream out;
+  stan::io::binary_var_context::write(json, out);
+  EXPECT_EQ(bytes, out.str());
+}
+
+TEST_F(StanIoBinaryVarContext, mapped_file) {
+  std::string file_name = "binary_var_context_test.bin";
+  {
+    std::ofstream out(file_name.c_str(), std::ios::binary);
+    out.write(bytes.data(), bytes.size());
+  }
+  {
+    stan::io::binary_var_context context(file_name);
+    expect_matches(context);
+
+    size_t size;
+    const double* y = context.vals_r_ptr("y", size);
+    ASSERT_TRUE(y != 0);
+    EXPECT_EQ(3U, size);
+    EXPECT_FLOAT_EQ(3.25, y[2]);
+    const int* z = context.vals_i_ptr("z", size);
+    ASSERT_TRUE(z != 0);
+    EXPECT_EQ(6U, size);
+    EXPECT_EQ(4, z[3]);
+    EXPECT_TRUE(context.vals_r_ptr("z", size) == 0);
+    EXPECT_EQ(0U, size);
+    EXPECT_TRUE(context.vals_i_ptr("x", size) == 0);
+  }
+  std::remove(file_name.c_str());
+}
+
+TEST_F(StanIoBinaryVarContext, bad_input) {
+  EXPECT_THROW(stan::io::binary_var_context("no_such_file.bin"),
+               std::invalid_argument);
+  std::string text = "N <- 3\n";
+  EXPECT_THROW(stan::io::binary_var_context(text.data(), text.size()),
+               std::invalid_argument);
+  EXPECT_THROW(stan::io::binary_var_context(bytes.data(), bytes.size() - 8),
+               std::invalid_argument);
+  EXPECT_THROW(stan::io::binary_var_context(bytes.data(), 40),
+               std::invalid_argument);
+}
+
+TEST_F(StanIoBinaryVarContext, corrupt_index) {
+  using stan::io::binary_var_context;
+  using stan::io::stan_binary::write_size;
+  std::stringstream header;
+  header.write(binary_var_context::magic(), 8);
+  write_size(header, 1);
+  write_size(header, 1);
+  header.write("x\0\0\0\0\0\0\0", 8);
+  write_size(header, binary_var_context::real_type);
+
+  // more dimensions than the remaining bytes could hold
+  std::stringstream many_dims;
+  many_dims << header.str();
+  write_size(many_dims, 1ULL << 60);
+  write_size(many_dims, 2);
+  std::string bad = many_dims.str();
+  EXPECT_THROW(binary_var_context(bad.data(), bad.size()),
+               std::invalid_argument);
+
+  // a product of dimensions which overflows
+  std::stringstream huge_size;
+  huge_size << header.str();
+  write_size(huge_size, 2);
+  write_size(huge_size, 1ULL << 40);
+  write_size(huge_size, 1ULL << 40);
+  write_size(huge_size, 0);
+  bad = huge_size.str();
+  EXPECT_THROW(binary_var_context(bad.data(), bad.size()),
+               std::invalid_argument);
+
+  // a name size which overflows when padded
+  std::stringstream huge_name;
+  huge_name.write(binary_var_context::magic(), 8);
+  write_size(huge_name, 1);
+  write_size(huge_name, ~0ULL);
+  write_size(huge_name, 0);
+  bad = huge_name.str();
+  EXPECT_THROW(binary_var_context(bad.data(), bad.size()),
+               std::invalid_argument);
+}
@@ -51,3 +51,25 @@ TEST(chained_var_context, ctor) {
   std::vector<double> alpha(1, 0);
   EXPECT_EQ(alpha, vcc.vals_r("alpha"));
 }
+
+TEST(chained_var_context, lookup) {
+  std::vector<std::vector<size_t> > dims(1);
+  std::vector<std::string> names(1, "alpha");
+  stan::io::array_var_context avc(names, std::vector<double>(1, 1.5), dims);
+  names[0] = "beta";
+  stan::io::array_var_context avc2(names, std::vector<int>(1, 3), dims);
+  stan::io::chained_var_context vcc(avc, avc2);
+
+  std::vector<double> vals_r;
+  std::vector<int> vals_i;
+  std::vector<size_t> dims_r;
+  ASSERT_TRUE(vcc.lookup_r("alpha", vals_r, dims_r));
+  EXPECT_EQ(std::vector<double>(1, 1.5), vals_r);
+  EXPECT_EQ(0U, dims_r.size());
+  ASSERT_TRUE(vcc.lookup_r("beta", vals_r, dims_r));
+  EXPECT_EQ(std::vector<double>(1, 3), vals_r);
+  ASSERT_TRUE(vcc.lookup_i("beta", vals_i, dims_r));
+  EXPECT_EQ(std::vector<int>(1, 3), vals_i);
+  EXPECT_FALSE(vcc.lookup_i("alpha", vals_i, dims_r));
+  EXPECT_FALSE(vcc.lookup_r("gamma", vals_r, dims_r));
+}
@@ -299,6 +299,29 @@ TEST(io_dump, reader_nan_inf) {
   test_list2(reader,"a",expected_vals,expected_dims);
 }
 
+TEST(io_dump, reader_long_vec_double) {
+  std::stringstream txt;
+  std::vector<double> expected_vals;
+  txt << "a <- c(";
+  for (int i = 0; i < 10000; ++i) {
+    double x = (i - 5000) * 0.0123456789 * (i % 7 == 0 ? 1e-30 : 1);
+    expected_vals.push_back(x);
+    txt.precision(17);
+    txt << (i > 0 ? (i % 10 == 0 ? " ,\n  " : ", ") : "") << x;
+  }
+  txt << ")";
+
+  std::stringstream in(txt.str());
+  stan::io::dump_reader reader(in);
+  ASSERT_TRUE(reader.next());
+  EXPECT_FALSE(reader.is_int());
+  std::vector<double> vals = reader.double_values();
+  ASSERT_EQ(expected_vals.size(), vals.size());
+  for (size_t i = 0; i < vals.size(); ++i)
+    EXPECT_EQ(expected_vals[i], vals[i]);
+  EXPECT_FALSE(reader.next());
+}
+
 TEST(io_dump, reader_vec_double) {
   std::vector<double> expected_vals;
   expected_vals.push_back(1.0);
@@ -451,6 +474,28 @@ TEST(io_dump,dump_contains_i) {
   EXPECT_FALSE(dump.contains_r("foo"));
 }
 
+TEST(io_dump,dump_lookup) {
+  std::string txt = "foo <- c(1, 2)\nbar <- structure(c(1.5, 2.5),"
+    " .Dim = c(2, 1))\n";
+  std::stringstream in(txt);
+  stan::io::dump dump(in);
+
+  std::vector<double> vals_r;
+  std::vector<int> vals_i;
+  std::vector<size_t> dims;
+  ASSERT_TRUE(dump.lookup_r("bar", vals_r, dims));
+  EXPECT_EQ(dump.vals_r("bar"), vals_r);
+  EXPECT_EQ(dump.dims_r("bar"), dims);
+  EXPECT_FALSE(dump.lookup_i("bar", vals_i, dims));
+
+  ASSERT_TRUE(dump.lookup_r("foo", vals_r, dims));
+  EXPECT_EQ(dump.vals_r("foo"), vals_r);
+  ASSERT_TRUE(dump.lookup_i("foo", vals_i, dims));
+  EXPECT_EQ(dump.vals_i("foo"), vals_i);
+
+  EXPECT_FALSE(dump.lookup_r("baz", vals_r, dims));
+}
+
 TEST(io_dump, dump_safety) {
   std::string txt = "foo <- c(1,2)\nbar<-1.0";
   //std::string txt = "bar<-1.0\nfoo <- c(1,2)\n";
@@ -699,3 +744,35 @@ TEST(io_dump, too_large_zero_array) {
   test_exception("a <- structure(integer(999918446744073709551616L), .Dim = c(2,3))");
   test_exception("a <- structure(double(999918446744073709551616L), .Dim = c(2,3))");
 }
+
+TEST(io_dump, vals_ptr_zero_size) {
+  std::stringstream in("a <- integer(0)\n"
+                       "b <- double(0)\n"
+                       "c <- structure(double(0), .Dim = c(2, 0))\n"
+                       "d <- c(1.5, 2)\n");
+  stan::io::dump dump(in);
+  stan::io::var_context& context = dump;
+
+  // empty variables are held as integers, whatever their type
+  size_t size = 1;
+  EXPECT_TRUE(context.vals_i_ptr("a", size) != 0);
+  EXPECT_EQ(0U, size);
+  size = 1;
+  EXPECT_TRUE(context.vals_i_ptr("b", size) != 0);
+  EXPECT_EQ(0U, size);
+  size = 1;
+  EXPECT_TRUE(context.vals_i_ptr("c", size) != 0);
+  EXPECT_EQ(0U, size);
+  EXPECT_EQ(2U, context.dims_i("c").size());
+
+  const double* d = context.vals_r_ptr("d", size);
+  ASSERT_TRUE(d != 0);
+  EXPECT_EQ(2U, size);
+  EXPECT_FLOAT_EQ(1.5, d[0]);
+
+  // missing and integer valued variables are not held as doubles
+  EXPECT_TRUE(context.vals_r_ptr("a", size) == 0);
+  EXPECT_EQ(0U, size);
+  EXPECT_TRUE(context.vals_i_ptr("e", size) == 0);
+  EXPECT_EQ(0U, size);
+}
@@ -0,0 +1,112 @@
+#include <stan/io/format_double.hpp>
+#include <stan/io/stan_csv_reader.hpp>
+#include <stan/callbacks/stream_writer.hpp>
+#include <gtest/gtest.h>
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/normal_distribution.hpp>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+  std::string format(double x) {
+    char buffer[stan::io::format_double_buffer_size];
+    int length = stan::io::format_double(x, buffer);
+    return std::string(buffer, length);
+  }
+
+  std::string format(double x, int precision) {
+    char buffer[stan::io::format_double_buffer_size];
+    int length = stan::io::format_double(x, precision, buffer);
+    return std::string(buffer, length);
+  }
+}
+
+TEST(ioFormatDouble, cached_powers) {
+  const std::vector<stan::io::grisu::diy_fp>& powers
+    = stan::io::grisu::cached_powers();
+  ASSERT_EQ(87U, powers.size());
+  EXPECT_EQ(0xfa8fd5a0081c0288ULL, powers[0].f);
+  EXPECT_EQ(-1220, powers[0].e);
+  EXPECT_EQ(0x9c40000000000000ULL, powers[44].f);
+  EXPECT_EQ(-50, powers[44].e);
+  EXPECT_EQ(0xaf87023b9bf0ee6bULL, powers[86].f);
+  EXPECT_EQ(1066, powers[86].e);
+}
+
+TEST(ioFormatDouble, shortest) {
+  EXPECT_EQ("0", format(0.0));
+  EXPECT_EQ("-0", format(-0.0));
+  EXPECT_EQ("1", format(1.0));
+  EXPECT_EQ("-31", format(-31.0));
+  EXPECT_EQ("0.1", format(0.1));
+  EXPECT_EQ("0.3333333333333333", format(1.0 / 3.0));
+  EXPECT_EQ("0.0001", format(1e-4));
+  EXPECT_EQ("0.000012345", format(1.2345e-5));
+  EXPECT_EQ("1.5e-07", format(1.5e-7));
+  EXPECT_EQ("10000000000000000", format(1e16));
+  EXPECT_EQ("1e+20", format(1e20));
+  EXPECT_EQ("1.2345678901234568e+17", format(123456789012345678.0));
+  EXPECT_EQ("5e-324", format(std::numeric_limits<double>::denorm_min()));
+  EXPECT_EQ("1.7976931348623157e+308",
+            format(std::numeric_limits<double>::max()));
+  EXPECT_EQ("inf", format(std::numeric_limits<double>::infinity()));
+  EXPECT_EQ("-inf", format(-std::numeric_limits<double>::infinity()));
+  EXPECT_EQ("nan", format(std::numeric_limits<double>::quiet_NaN()));
+}
+
+TEST(ioFormatDouble, precision) {
+  EXPECT_EQ("0.333333", format(1.0 / 3.0, 6));
+  EXPECT_EQ("1.23e+04", format(12345.0, 3));
+  EXPECT_EQ("0.33333333333333331", format(1.0 / 3.0, 17));
+  EXPECT_EQ("0.3", format(1.0 / 3.0, 0));
+}
+
+TEST(ioFormatDouble, round_trip) {
+  boost::random::mt19937 rng(1234);
+  boost::random::normal_distribution<double> normal;
+  for (int n = 0; n < 100000; ++n) {
+    double x;
+    if (n % 2) {
+      boost::uint64_t bits = (static_cast<boost::uint64_t>(rng()) << 32)
+                             | rng();
+      std::memcpy(&x, &bits, sizeof(x));
+      if (!(x - x == 0))
+        continue;
+    } else {
+      x = normal(rng);
+    }
+    std::string s = format(x);
+    ASSERT_EQ(x, std::strtod(s.c_str(), 0)) << s;
+  }
+}
+
+TEST(ioFormatDouble, round_trip_csv) {
+  boost::random::mt19937 rng(1234);
+  boost::random::normal_distribution<double> normal;
+  std::stringstream csv;
+  stan::callbacks::stream_writer
+    writer(csv, "# ", stan::callbacks::stream_writer::shortest_precision);
+  std::vector<std::vector<double> > rows;
+  for (int n = 0; n < 100; ++n) {
+    std::vector<double> row;
+    for (int i = 0; i < 10; ++i)
+      row.push_back(normal(rng) * std::pow(10.0, i - 5));
+    rows.push_back(row);
+    writer(row);
+  }
+
+  Eigen::MatrixXd samples;
+  stan::io::stan_csv_timing timing;
+  ASSERT_TRUE(stan::io::stan_csv_reader::read_samples(csv, samples, timing,
+                                                      0));
+  ASSERT_EQ(100, samples.rows());
+  ASSERT_EQ(10, samples.cols());
+  for (int n = 0; n < 100; ++n)
+    for (int i = 0; i < 10; ++i)
+      EXPECT_EQ(rows[n][i], samples(n, i));
+}
@@ -401,3 +401,92 @@ TEST(ioJson,jsonData_parse_mult_objects) {
   EXPECT_EQ("foo",var_names[0]);
 }
 
+
+TEST(ioJson,jsonData_vals_ptr) {
+  std::string txt = "{ \"foo\": [[1, 2, 3], [4, 5, 6]],"
+    " \"bar\": [[1, 2.5], [3, 4], [5, 6]] }";
+  std::stringstream in(txt);
+  stan::json::json_data jdata(in);
+  stan::io::var_context& context = jdata;
+
+  size_t size;
+  const int* foo = context.vals_i_ptr("foo", size);
+  ASSERT_TRUE(foo != 0);
+  EXPECT_EQ(6U, size);
+  std::vector<int> foo_vals = jdata.vals_i("foo");
+  for (size_t i = 0; i < size; ++i)
+    EXPECT_EQ(foo_vals[i], foo[i]);
+  EXPECT_EQ(4, foo[1]);
+  EXPECT_TRUE(context.vals_r_ptr("foo", size) == 0);
+  EXPECT_EQ(0U, size);
+
+  const double* bar = context.vals_r_ptr("bar", size);
+  ASSERT_TRUE(bar != 0);
+  EXPECT_EQ(6U, size);
+  double bar_vals[] = { 1, 3, 5, 2.5, 4, 6 };
+  for (size_t i = 0; i < size; ++i)
+    EXPECT_FLOAT_EQ(bar_vals[i], bar[i]);
+  EXPECT_EQ(bar, context.vals_r_ptr("bar", size));
+  EXPECT_TRUE(context.vals_i_ptr("bar", size) == 0);
+
+  EXPECT_TRUE(context.vals_r_ptr("qux", size) == 0);
+  EXPECT_EQ(0U, size);
+
+  // variables with zero size are rejected, so a variable which is
+  // present never has an empty sequence of values
+  std::stringstream empty_in("{ \"foo\": [] }");
+  EXPECT_THROW(stan::json::json_data empty(empty_in), std::exception);
+}
+
+TEST(ioJson,jsonData_column_major_3d) {
+  std::string txt = "{ \"foo\": [[[1, 2], [3, 4], [5, 6]],"
+    " [[7, 8], [9, 10], [11, 12]]] }";
+  std::stringstream in(txt);
+  stan::json::json_data jdata(in);
+  int expected[] = { 1, 7, 3, 9, 5, 11, 2, 8, 4, 10, 6, 12 };
+  std::vector<int> expected_vals(expected, expected + 12);
+  std::vector<size_t> expected_dims;
+  expected_dims.push_back(2);
+  expected_dims.push_back(3);
+  expected_dims.push_back(2);
+  test_int_var(jdata,txt,"foo",expected_vals,expected_dims);
+}
+
+TEST(ioJson,jsonData_lookup) {
+  std::string txt = "{ \"foo\": [1, 2], \"bar\": [[1.5], [2.5]] }";
+  std::stringstream in(txt);
+  stan::json::json_data jdata(in);
+
+  std::vector<double> vals_r;
+  std::vector<int> vals_i;
+  std::vector<size_t> dims;
+  ASSERT_TRUE(jdata.lookup_r("bar", vals_r, dims));
+  EXPECT_EQ(jdata.vals_r("bar"), vals_r);
+  EXPECT_EQ(jdata.dims_r("bar"), dims);
+  EXPECT_FALSE(jdata.lookup_i("bar", vals_i, dims));
+
+  ASSERT_TRUE(jdata.lookup_r("foo", vals_r, dims));
+  EXPECT_EQ(jdata.vals_r("foo"), vals_r);
+  ASSERT_TRUE(jdata.lookup_i("foo", vals_i, dims));
+  EXPECT_EQ(jdata.vals_i("foo"), vals_i);
+  EXPECT_EQ(1U, dims.size());
+
+  EXPECT_FALSE(jdata.lookup_r("baz", vals_r, dims));
+}
+
+TEST(ioJson,jsonData_names_sorted) {
+  std::string txt = "{ \"c\": 1, \"a\": 2, \"b\": 3, \"z\": 1.5,"
+    " \"y\": 2.5 }";
+  std::stringstream in(txt);
+  stan::json::json_data jdata(in);
+  std::vector<std::string> names;
+  jdata.names_i(names);
+  ASSERT_EQ(3U, names.size());
+  EXPECT_EQ("a", names[0]);
+  EXPECT_EQ("b", names[1]);
+  EXPECT_EQ("c", names[2]);
+  jdata.names_r(names);
+  ASSERT_EQ(2U, names.size());
+  EXPECT_EQ("y", names[0]);
+  EXPECT_EQ("z", names[1]);
+}
@@ -582,6 +582,16 @@ TEST(ioJson,jsonParserErr19b) {
 }
 
 
+TEST(ioJson,jsonParserIntRange) {
+  test_parser("[ 18446744073709551615, -9223372036854775808, -0 ]",
+              "S:text" "S:arr" "UL(INT):18446744073709551615"
+              "L(INT):-9223372036854775808" "L(INT):0" "E:arr" "E:text");
+  test_exception("[ 18446744073709551616 ]",
+                 "number exceeds integer range\n");
+  test_exception("[ -9223372036854775809 ]",
+                 "number exceeds integer range\n");
+}
+
 TEST(ioJson,jsonParserErr19c) {
   test_exception("[ 9.9999999e-1000000000000 ]",
                  "number exceeds double range\n");
@@ -0,0 +1,149 @@
+#include <stan/io/mapped_stan_csv_reader.hpp>
+#include <stan/io/stan_csv_reader.hpp>
+#include <gtest/gtest.h>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+class StanIoMappedStanCsvReader : public testing::Test {
+public:
+  StanIoMappedStanCsvReader()
+    : file_name("src/test/unit/io/test_csv_files/blocker.0.csv") {}
+
+  void SetUp() {
+    std::ifstream csv(file_name.c_str());
+    csv_data = stan::io::stan_csv_reader::parse(csv, 0);
+  }
+
+  std::string file_name;
+  stan::io::stan_csv csv_data;
+};
+
+namespace {
+  struct row_counter {
+    row_counter(int& rows, double& sum) : rows_(rows), sum_(sum) {}
+    void operator()(const std::vector<double>& row) const {
+      ++rows_;
+      sum_ += row[0];
+    }
+    int& rows_;
+    double& sum_;
+  };
+}
+
+TEST_F(StanIoMappedStanCsvReader, matches_stan_csv_reader) {
+  std::stringstream out;
+  stan::io::mapped_stan_csv_reader reader(file_name, &out);
+  EXPECT_EQ("", out.str());
+
+  EXPECT_EQ(csv_data.metadata.model, reader.metadata().model);
+  EXPECT_EQ(csv_data.metadata.seed, reader.metadata().seed);
+  EXPECT_EQ(csv_data.metadata.thin, reader.metadata().thin);
+
+  ASSERT_EQ(csv_data.header.size(), reader.header().size());
+  for (int n = 0; n < reader.header().size(); ++n)
+    EXPECT_EQ(csv_data.header(n), reader.header()(n));
+
+  EXPECT_EQ(csv_data.adaptation.step_size, reader.adaptation().step_size);
+  EXPECT_TRUE(csv_data.adaptation.metric == reader.adaptation().metric);
+
+  Eigen::MatrixXd samples;
+  stan::io::stan_csv_timing timing;
+  EXPECT_TRUE(reader.read_samples(reader.column_indexes(), samples, timing,
+                                  &out));
+  EXPECT_EQ("", out.str());
+  ASSERT_EQ(csv_data.samples.rows(), samples.rows());
+  ASSERT_EQ(csv_data.samples.cols(), samples.cols());
+  EXPECT_TRUE(csv_data.samples == samples);
+  EXPECT_FLOAT_EQ(csv_data.timing.warmup, timing.warmup);
+  EXPECT_FLOAT_EQ(csv_data.timing.sampling, timing.sampling);
+}
+
+TEST_F(StanIoMappedStanCsvReader, projection) {
+  stan::io::mapped_stan_csv_reader reader(file_name);
+  std::vector<std::string> names;
+  names.push_back("mu[2]");
+  names.push_back("lp__");
+  std::vector<size_t> columns = reader.column_indexes(names);
+  ASSERT_EQ(2U, columns.size());
+  EXPECT_EQ(10U, columns[0]);
+  EXPECT_EQ(0U, columns[1]);
+
+  Eigen::MatrixXd samples;
+  stan::io::stan_csv_timing timing;
+  EXPECT_TRUE(reader.read_samples(columns, samples, timing, 0));
+  ASSERT_EQ(1000, samples.rows());
+  ASSERT_EQ(2, samples.cols());
+  EXPECT_TRUE(csv_data.samples.col(10) == samples.col(0));
+  EXPECT_TRUE(csv_data.samples.col(0) == samples.col(1));
+
+  names.push_back("not_a_column");
+  EXPECT_THROW(reader.column_indexes(names), std::invalid_argument);
+}
+
+TEST_F(StanIoMappedStanCsvReader, callback) {
+  stan::io::mapped_stan_csv_reader reader(file_name);
+  int rows = 0;
+  double sum = 0;
+  stan::io::stan_csv_timing timing;
+  EXPECT_TRUE(reader.read_samples(std::vector<size_t>(1, 0),
+                                  row_counter(rows, sum), timing, 0));
+  EXPECT_EQ(1000, rows);
+  EXPECT_FLOAT_EQ(csv_data.samples.col(0).sum(), sum);
+}
+
+TEST_F(StanIoMappedStanCsvReader, in_memory) {
+  std::string csv = "# model = m\n"
+                    "lp__,theta.1,theta.2\n"
+                    "-1.5,0.25,3\r\n"
+                    "\n"
+                    "-2,1e-3,4\n"
+                    "#  Elapsed Time: 0.5 seconds (Warm-up)\n"
+                    "#                1.5 seconds (Sampling)\n";
+  stan::io::mapped_stan_csv_reader reader(csv.data(), csv.size());
+  EXPECT_EQ("m", reader.metadata().model);
+  ASSERT_EQ(3, reader.header().size());
+  EXPECT_EQ("theta[2]", reader.header()(2));
+
+  Eigen::MatrixXd samples;
+  stan::io::stan_csv_timing timing;
+  EXPECT_TRUE(reader.read_samples(reader.column_indexes(), samples, timing,
+                                  0));
+  ASSERT_EQ(2, samples.rows());
+  EXPECT_EQ(-1.5, samples(0, 0));
+  EXPECT_EQ(3, samples(0, 2));
+  EXPECT_EQ(1e-3, samples(1, 1));
+  EXPECT_EQ(0.5, timing.warmup);
+  EXPECT_EQ(1.5, timing.sampling);
+}
+
+TEST_F(StanIoMappedStanCsvReader, malformed) {
+  std::string csv = "lp__,theta\n"
+                    "1,2\n"
+                    "3\n";
+  stan::io::mapped_stan_csv_reader reader(csv.data(), csv.size());
+  std::stringstream out;
+  Eigen::MatrixXd samples;
+  stan::io::stan_csv_timing timing;
+  EXPECT_FALSE(reader.read_samples(reader.column_indexes(), samples, timing,
+                                   &out));
+  EXPECT_EQ(1, samples.rows());
+  EXPECT_EQ("Error: expected 2 columns, but found 1 instead for row 2\n",
+            out.str());
+
+  csv = "lp__,theta\n"
+        "1,x\n";
+  stan::io::mapped_stan_csv_reader bad_value(csv.data(), csv.size());
+  EXPECT_FALSE(bad_value.read_samples(bad_value.column_indexes(), samples,
+                                      timing, 0));
+}
+
+TEST_F(StanIoMappedStanCsvReader, missing_file) {
+  EXPECT_THROW(stan::io::mapped_stan_csv_reader("no_such_file.csv"),
+               std::invalid_argument);
+  std::string csv = "# comment only\n";
+  EXPECT_THROW(stan::io::mapped_stan_csv_reader(csv.data(), csv.size()),
+               std::invalid_argument);
+}
@@ -0,0 +1,68 @@
+#include <stan/io/parse_double.hpp>
+#include <gtest/gtest.h>
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/normal_distribution.hpp>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+
+namespace {
+  double parse(const std::string& s) {
+    double x = -999;
+    EXPECT_TRUE(stan::io::parse_double(s.data(), s.data() + s.size(), x))
+      << s;
+    return x;
+  }
+
+  bool parses(const std::string& s) {
+    double x;
+    return stan::io::parse_double(s.data(), s.data() + s.size(), x);
+  }
+}
+
+TEST(ioParseDouble, numbers) {
+  EXPECT_EQ(0.0, parse("0"));
+  EXPECT_TRUE(std::signbit(parse("-0")));
+  EXPECT_EQ(1.5, parse("1.5"));
+  EXPECT_EQ(-5919.76, parse("-5919.76"));
+  EXPECT_EQ(0.118745, parse(" 0.118745 "));
+  EXPECT_EQ(31, parse("31"));
+  EXPECT_EQ(2.5e-7, parse("2.5e-07"));
+  EXPECT_EQ(1e20, parse("1E+20"));
+  EXPECT_EQ(0.5, parse(".5"));
+  EXPECT_EQ(5, parse("5."));
+  EXPECT_EQ(0.1, parse("+0.1\r"));
+  EXPECT_EQ(1.0 / 3.0, parse("0.3333333333333333"));
+  EXPECT_EQ(0.33333333333333331, parse("0.33333333333333331"));
+  EXPECT_EQ(123456789012345678901234.0, parse("123456789012345678901234"));
+  EXPECT_EQ(std::numeric_limits<double>::denorm_min(), parse("5e-324"));
+  EXPECT_EQ(std::numeric_limits<double>::infinity(), parse("inf"));
+  EXPECT_EQ(-std::numeric_limits<double>::infinity(), parse("-inf"));
+  EXPECT_TRUE(std::isnan(parse("nan")));
+}
+
+TEST(ioParseDouble, not_numbers) {
+  EXPECT_FALSE(parses(""));
+  EXPECT_FALSE(parses("  "));
+  EXPECT_FALSE(parses("-"));
+  EXPECT_FALSE(parses("1.5x"));
+  EXPECT_FALSE(parses("1,5"));
+  EXPECT_FALSE(parses("lp__"));
+}
+
+TEST(ioParseDouble, matches_strtod) {
+  boost::random::mt19937 rng(1234);
+  boost::random::normal_distribution<double> normal;
+  char buffer[64];
+  for (int n = 0; n < 100000; ++n) {
+    double x = normal(rng) * std::pow(10.0, n % 40 - 20);
+    int length = std::snprintf(buffer, sizeof(buffer), "%.*g",
+                               1 + n % 17, x);
+    double y;
+    ASSERT_TRUE(stan::io::parse_double(buffer, buffer + length, y));
+    ASSERT_EQ(std::strtod(buffer, 0), y) << buffer;
+  }
+}
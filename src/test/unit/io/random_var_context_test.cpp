@@ -139,6 +139,19 @@ TEST_F(random_var_context, dims_r) {
   EXPECT_EQ(2, dims_r[0]);
 }
 
+TEST_F(random_var_context, lookup_r) {
+  stan::io::random_var_context context(model, rng, 2, false);
+  std::vector<double> vals_r;
+  std::vector<size_t> dims_r;
+  EXPECT_FALSE(context.lookup_r("", vals_r, dims_r));
+  EXPECT_EQ(0, vals_r.size());
+
+  ASSERT_TRUE(context.lookup_r("y", vals_r, dims_r));
+  EXPECT_EQ(context.vals_r("y"), vals_r);
+  ASSERT_EQ(1, dims_r.size());
+  EXPECT_EQ(2, dims_r[0]);
+}
+
 TEST_F(random_var_context, contains_i) {
   stan::io::random_var_context context(model, rng, 2, false);
   EXPECT_FALSE(context.contains_i(""));
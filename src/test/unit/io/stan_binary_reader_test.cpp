@@ -0,0 +1,191 @@
+#include <stan/io/stan_binary_reader.hpp>
+#include <stan/io/stan_csv_reader.hpp>
+#include <stan/callbacks/binary_writer.hpp>
+#include <boost/algorithm/string.hpp>
+#include <boost/lexical_cast.hpp>
+#include <gtest/gtest.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+  // Write a Stan csv file through the binary writer, as the services
+  // would have written it
+  void csv_to_binary(std::istream& csv, stan::callbacks::writer& writer) {
+    std::string line;
+    bool header = false;
+    while (std::getline(csv, line)) {
+      if (line.empty())
+        continue;
+      if (line[0] == '#') {
+        if (line.size() > 2)
+          writer(line.substr(2));
+        else
+          writer();
+        continue;
+      }
+      std::vector<std::string> tokens;
+      boost::split(tokens, line, boost::is_any_of(","));
+      if (!header) {
+        writer(tokens);
+        header = true;
+        continue;
+      }
+      std::vector<double> values;
+      for (size_t n = 0; n < tokens.size(); ++n)
+        values.push_back(boost::lexical_cast<double>(tokens[n]));
+      writer(values);
+    }
+  }
+}
+
+class StanIoStanBinaryReader : public testing::Test {
+public:
+  void SetUp() {
+    std::ifstream csv("src/test/unit/io/test_csv_files/blocker.0.csv");
+    csv_data = stan::io::stan_csv_reader::parse(csv, 0);
+
+    csv.clear();
+    csv.seekg(0);
+    stan::callbacks::binary_writer writer(binary, 7);
+    csv_to_binary(csv, writer);
+  }
+
+  stan::io::stan_csv csv_data;
+  std::stringstream binary;
+};
+
+TEST_F(StanIoStanBinaryReader, matches_csv) {
+  std::stringstream out;
+  stan::io::stan_csv data = stan::io::stan_binary_reader::parse(binary, &out);
+  EXPECT_EQ("", out.str());
+
+  EXPECT_EQ(csv_data.metadata.model, data.metadata.model);
+  EXPECT_EQ(csv_data.metadata.seed, data.metadata.seed);
+  EXPECT_EQ(csv_data.metadata.num_samples, data.metadata.num_samples);
+  EXPECT_EQ(csv_data.metadata.thin, data.metadata.thin);
+  EXPECT_EQ(csv_data.metadata.data, data.metadata.data);
+  EXPECT_EQ(csv_data.metadata.engine, data.metadata.engine);
+
+  ASSERT_EQ(55, data.header.size());
+  for (int n = 0; n < data.header.size(); ++n)
+    EXPECT_EQ(csv_data.header(n), data.header(n));
+  EXPECT_EQ("mu[1]", data.header(9));
+
+  EXPECT_FLOAT_EQ(0.118745, data.adaptation.step_size);
+  ASSERT_EQ(csv_data.adaptation.metric.rows(),
+            data.adaptation.metric.rows());
+  ASSERT_EQ(csv_data.adaptation.metric.cols(),
+            data.adaptation.metric.cols());
+  EXPECT_TRUE(csv_data.adaptation.metric == data.adaptation.metric);
+
+  ASSERT_EQ(1000, data.samples.rows());
+  ASSERT_EQ(55, data.samples.cols());
+  EXPECT_TRUE(csv_data.samples == data.samples);
+
+  EXPECT_FLOAT_EQ(csv_data.timing.warmup, data.timing.warmup);
+  EXPECT_FLOAT_EQ(csv_data.timing.sampling, data.timing.sampling);
+  EXPECT_LT(0, data.timing.sampling);
+}
+
+TEST_F(StanIoStanBinaryReader, round_trip_exact) {
+  std::stringstream ss;
+  std::vector<double> x;
+  x.push_back(0.1);
+  x.push_back(1.0 / 3.0);
+  x.push_back(-1e-300);
+  {
+    stan::callbacks::binary_writer writer(ss);
+    std::vector<std::string> names;
+    names.push_back("a");
+    names.push_back("b.1");
+    names.push_back("b.2");
+    writer(names);
+    writer(x);
+  }
+  stan::io::stan_csv data = stan::io::stan_binary_reader::parse(ss, 0);
+  ASSERT_EQ(1, data.samples.rows());
+  EXPECT_EQ(x[0], data.samples(0, 0));
+  EXPECT_EQ(x[1], data.samples(0, 1));
+  EXPECT_EQ(x[2], data.samples(0, 2));
+  EXPECT_EQ("b[2]", data.header(2));
+}
+
+TEST_F(StanIoStanBinaryReader, not_binary) {
+  std::ifstream csv("src/test/unit/io/test_csv_files/blocker.0.csv");
+  EXPECT_THROW(stan::io::stan_binary_reader::parse(csv, 0),
+               std::invalid_argument);
+}
+
+TEST_F(StanIoStanBinaryReader, truncated) {
+  std::string bytes = binary.str();
+  std::stringstream truncated(bytes.substr(0, bytes.size() / 2));
+  std::stringstream out;
+  stan::io::stan_csv data
+    = stan::io::stan_binary_reader::parse(truncated, &out);
+  EXPECT_EQ(55, data.header.size());
+  EXPECT_LT(0, data.samples.rows());
+  EXPECT_GT(1000, data.samples.rows());
+  EXPECT_EQ(0, data.samples.rows() % 7);
+  EXPECT_NE(std::string::npos, out.str().find("error reading samples"));
+}
+
+TEST_F(StanIoStanBinaryReader, corrupt_sizes) {
+  namespace stan_binary = stan::io::stan_binary;
+  std::stringstream header;
+  header.write(stan_binary::magic, stan_binary::magic_size);
+  header.put(stan_binary::names_record);
+  stan_binary::write_size(header, 2);
+  stan_binary::write_string(header, "a");
+  stan_binary::write_string(header, "b");
+  header.put(stan_binary::draws_record);
+  stan_binary::write_size(header, 1);
+  stan_binary::write_size(header, 2);
+  const double draw[2] = { 1, 2 };
+  stan_binary::write_doubles(header, draw, 2);
+
+  // a block of draws which overflows
+  std::stringstream huge_block(header.str());
+  huge_block.seekp(0, std::ios::end);
+  huge_block.put(stan_binary::draws_record);
+  stan_binary::write_size(huge_block, 1ULL << 63);
+  stan_binary::write_size(huge_block, 2);
+  std::stringstream out;
+  stan::io::stan_csv data = stan::io::stan_binary_reader::parse(huge_block,
+                                                                &out);
+  EXPECT_EQ(1, data.samples.rows());
+  EXPECT_NE(std::string::npos, out.str().find("error reading samples"));
+
+  // a block of draws longer than the rest of the stream
+  std::stringstream long_block(header.str());
+  long_block.seekp(0, std::ios::end);
+  long_block.put(stan_binary::draws_record);
+  stan_binary::write_size(long_block, 1ULL << 40);
+  stan_binary::write_size(long_block, 2);
+  stan_binary::write_doubles(long_block, draw, 2);
+  out.str("");
+  data = stan::io::stan_binary_reader::parse(long_block, &out);
+  EXPECT_EQ(1, data.samples.rows());
+  EXPECT_NE(std::string::npos, out.str().find("error reading samples"));
+
+  // a comment longer than the rest of the stream
+  std::stringstream long_comment(header.str());
+  long_comment.seekp(0, std::ios::end);
+  long_comment.put(stan_binary::comment_record);
+  stan_binary::write_size(long_comment, 1ULL << 50);
+  long_comment << "Elapsed Time";
+  out.str("");
+  data = stan::io::stan_binary_reader::parse(long_comment, &out);
+  EXPECT_EQ(1, data.samples.rows());
+  EXPECT_NE(std::string::npos, out.str().find("error reading samples"));
+
+  // more names than the rest of the stream could hold
+  std::stringstream many_names;
+  many_names.write(stan_binary::magic, stan_binary::magic_size);
+  many_names.put(stan_binary::names_record);
+  stan_binary::write_size(many_names, 1ULL << 60);
+  stan_binary::write_string(many_names, "a");
+  EXPECT_THROW(stan::io::stan_binary_reader::parse(many_names, 0),
+               std::invalid_argument);
+}
@@ -138,6 +138,47 @@ TEST_F(McmcChains, add) {
     << "validate state is identical to before";
 }
 
+TEST_F(McmcChains, add_one_draw_at_a_time) {
+  std::stringstream out;
+  stan::io::stan_csv blocker1 = stan::io::stan_csv_reader::parse(blocker1_stream, &out);
+  EXPECT_EQ("", out.str());
+
+  stan::mcmc::chains<> chains(blocker1.header);
+  for (int n = 0; n < blocker1.samples.rows(); ++n) {
+    chains.add(0, blocker1.samples.row(n));
+    chains.add(2, blocker1.samples.row(n));
+  }
+  EXPECT_EQ(3, chains.num_chains());
+  EXPECT_EQ(0, chains.num_samples(1));
+  EXPECT_EQ(1000, chains.num_samples(0));
+  EXPECT_EQ(1000, chains.num_samples(2));
+  for (int index = 0; index < chains.num_params(); ++index) {
+    EXPECT_TRUE(blocker1.samples.col(index) == chains.samples(0, index));
+    EXPECT_TRUE(blocker1.samples.col(index) == chains.samples(2, index));
+  }
+
+  chains.set_warmup(0, 100);
+  EXPECT_EQ(900, chains.samples(0, 5).size());
+  EXPECT_TRUE(blocker1.samples.col(5).bottomRows(900)
+              == chains.samples(0, 5));
+  EXPECT_FLOAT_EQ(blocker1.samples.col(5).bottomRows(900).mean(),
+                  chains.mean(0, 5));
+}
+
+TEST_F(McmcChains, samples_are_views) {
+  std::stringstream out;
+  stan::io::stan_csv blocker1 = stan::io::stan_csv_reader::parse(blocker1_stream, &out);
+  EXPECT_EQ("", out.str());
+
+  stan::mcmc::chains<> chains(blocker1);
+  EXPECT_EQ(chains.samples(0, 3).data(), chains.samples(0, 3).data());
+  EXPECT_EQ(chains.samples(0, 3).data(),
+            chains.samples(0, chains.param_name(3)).data());
+  chains.set_warmup(0, 10);
+  EXPECT_EQ(990, chains.samples(0, 3).size());
+  EXPECT_EQ(blocker1.samples(10, 3), chains.samples(0, 3)(0));
+}
+
 TEST_F(McmcChains, add_adapter) {
   std::stringstream out;
   stan::io::stan_csv blocker1 = stan::io::stan_csv_reader::parse(blocker1_stream, &out);
@@ -862,3 +903,29 @@ TEST_F(McmcChains,blocker_split_potential_scale_reduction) {
   }
 
 }
+
+TEST_F(McmcChains, blocker_summary) {
+  std::stringstream out;
+  stan::io::stan_csv blocker1 = stan::io::stan_csv_reader::parse(blocker1_stream, &out);
+  stan::io::stan_csv blocker2 = stan::io::stan_csv_reader::parse(blocker2_stream, &out);
+  EXPECT_EQ("", out.str());
+
+  stan::mcmc::chains<> chains(blocker1);
+  chains.add(blocker2);
+  chains.set_warmup(100);
+
+  Eigen::VectorXd probs(3);
+  probs << 0.1, 0.5, 0.9;
+  std::vector<stan::analyze::parameter_summary> summaries;
+  chains.summary(probs, summaries, 2);
+  ASSERT_EQ(static_cast<size_t>(chains.num_params()), summaries.size());
+  for (int index = 4; index < chains.num_params(); ++index) {
+    EXPECT_FLOAT_EQ(chains.mean(index), summaries[index].mean);
+    EXPECT_FLOAT_EQ(chains.sd(index), summaries[index].sd);
+    EXPECT_TRUE(chains.quantiles(index, probs) == summaries[index].quantiles);
+    EXPECT_FLOAT_EQ(chains.effective_sample_size(index),
+                    summaries[index].ess);
+    EXPECT_FLOAT_EQ(chains.split_potential_scale_reduction(index),
+                    summaries[index].split_rhat);
+  }
+}
@@ -0,0 +1,156 @@
+#include <stan/mcmc/cross_chain_adaptation.hpp>
+#include <stan/mcmc/var_adaptation.hpp>
+#include <stan/mcmc/stepsize_adaptation.hpp>
+#include <test/unit/services/instrumented_callbacks.hpp>
+#include <gtest/gtest.h>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+TEST(McmcCrossChainAdaptation, pool_variance) {
+  const int num_chains = 3;
+  const int n = 4;
+  stan::mcmc::cross_chain_adaptation cross_chain(num_chains);
+
+  std::vector<Eigen::VectorXd> draws;
+  stan::math::welford_var_estimator all(n);
+  std::vector<stan::math::welford_var_estimator> estimators(
+      num_chains, stan::math::welford_var_estimator(n));
+  for (int c = 0; c < num_chains; ++c) {
+    for (int i = 0; i < 10 + c; ++i) {
+      Eigen::VectorXd q(n);
+      for (int k = 0; k < n; ++k)
+        q(k) = std::sin(1.0 + c * 31 + i * 7 + k) * (c + 1);
+      estimators[c].add_sample(q);
+      all.add_sample(q);
+    }
+  }
+  Eigen::VectorXd expected_var(n);
+  all.sample_variance(expected_var);
+
+  std::vector<Eigen::VectorXd> var(num_chains, Eigen::VectorXd::Zero(n));
+  std::vector<double> total(num_chains);
+  std::vector<std::thread> threads;
+  for (int c = 0; c < num_chains; ++c)
+    threads.emplace_back([&, c]() {
+        total[c] = cross_chain.pool_variance(c, estimators[c], var[c]);
+      });
+  for (int c = 0; c < num_chains; ++c)
+    threads[c].join();
+
+  for (int c = 0; c < num_chains; ++c) {
+    EXPECT_EQ(33, total[c]);
+    for (int k = 0; k < n; ++k) {
+      EXPECT_FLOAT_EQ(expected_var(k), var[c](k));
+      EXPECT_EQ(var[0](k), var[c](k));
+    }
+  }
+}
+
+TEST(McmcCrossChainAdaptation, pool_covariance) {
+  const int num_chains = 2;
+  const int n = 3;
+  stan::mcmc::cross_chain_adaptation cross_chain(num_chains);
+
+  stan::math::welford_covar_estimator all(n);
+  std::vector<stan::math::welford_covar_estimator> estimators(
+      num_chains, stan::math::welford_covar_estimator(n));
+  for (int c = 0; c < num_chains; ++c) {
+    for (int i = 0; i < 20; ++i) {
+      Eigen::VectorXd q(n);
+      for (int k = 0; k < n; ++k)
+        q(k) = std::cos(2.0 + c * 13 + i * 3 + k * k) + c;
+      estimators[c].add_sample(q);
+      all.add_sample(q);
+    }
+  }
+  Eigen::MatrixXd expected_covar(n, n);
+  all.sample_covariance(expected_covar);
+
+  std::vector<Eigen::MatrixXd> covar(num_chains, Eigen::MatrixXd::Zero(n, n));
+  std::vector<std::thread> threads;
+  for (int c = 0; c < num_chains; ++c)
+    threads.emplace_back([&, c]() {
+        cross_chain.pool_covariance(c, estimators[c], covar[c]);
+      });
+  for (int c = 0; c < num_chains; ++c)
+    threads[c].join();
+
+  for (int c = 0; c < num_chains; ++c)
+    for (int i = 0; i < n; ++i)
+      for (int j = 0; j < n; ++j)
+        EXPECT_FLOAT_EQ(expected_covar(i, j), covar[c](i, j));
+}
+
+TEST(McmcCrossChainAdaptation, pool_stepsize) {
+  const int num_chains = 4;
+  stan::mcmc::cross_chain_adaptation cross_chain(num_chains);
+
+  std::vector<double> epsilon(num_chains);
+  for (int c = 0; c < num_chains; ++c)
+    epsilon[c] = std::pow(2.0, c);
+
+  std::vector<std::thread> threads;
+  for (int c = 0; c < num_chains; ++c)
+    threads.emplace_back([&, c]() {
+        // repeated exchanges reuse the pool
+        for (int i = 0; i < 5; ++i)
+          cross_chain.pool_stepsize(c, epsilon[c]);
+      });
+  for (int c = 0; c < num_chains; ++c)
+    threads[c].join();
+
+  for (int c = 0; c < num_chains; ++c)
+    EXPECT_FLOAT_EQ(std::pow(2.0, 1.5), epsilon[c]);
+}
+
+TEST(McmcCrossChainAdaptation, leave_releases_waiting_chains) {
+  stan::mcmc::cross_chain_adaptation cross_chain(3);
+
+  double epsilon0 = 1;
+  double epsilon1 = 4;
+  std::thread t0([&]() { cross_chain.pool_stepsize(0, epsilon0); });
+  std::thread t1([&]() { cross_chain.pool_stepsize(1, epsilon1); });
+  cross_chain.leave(2);
+  t0.join();
+  t1.join();
+
+  EXPECT_FLOAT_EQ(2, epsilon0);
+  EXPECT_FLOAT_EQ(2, epsilon1);
+
+  // a single remaining chain is not blocked
+  cross_chain.leave(1);
+  cross_chain.pool_stepsize(0, epsilon0);
+  EXPECT_FLOAT_EQ(2, epsilon0);
+}
+
+TEST(McmcCrossChainAdaptation, single_chain_matches_unpooled) {
+  stan::test::unit::instrumented_logger logger;
+  const int n = 5;
+  const int n_learn = 30;
+
+  stan::mcmc::cross_chain_adaptation cross_chain(1);
+  stan::mcmc::var_adaptation pooled(n);
+  stan::mcmc::var_adaptation unpooled(n);
+  pooled.set_window_params(100, 0, 0, n_learn, logger);
+  unpooled.set_window_params(100, 0, 0, n_learn, logger);
+  pooled.set_cross_chain_adaptation(&cross_chain, 0);
+
+  Eigen::VectorXd pooled_var(Eigen::VectorXd::Zero(n));
+  Eigen::VectorXd unpooled_var(Eigen::VectorXd::Zero(n));
+  for (int i = 0; i < n_learn; ++i) {
+    Eigen::VectorXd q(n);
+    for (int k = 0; k < n; ++k)
+      q(k) = std::sin(i * 1.3 + k);
+    EXPECT_EQ(unpooled.learn_variance(unpooled_var, q),
+              pooled.learn_variance(pooled_var, q));
+  }
+  for (int k = 0; k < n; ++k)
+    EXPECT_FLOAT_EQ(unpooled_var(k), pooled_var(k));
+
+  stan::mcmc::stepsize_adaptation stepsize;
+  stepsize.set_cross_chain_adaptation(&cross_chain, 0);
+  double epsilon = 0.25;
+  stepsize.pool_stepsize(epsilon);
+  EXPECT_FLOAT_EQ(0.25, epsilon);
+}
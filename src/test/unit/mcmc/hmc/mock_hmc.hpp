@@ -20,6 +20,12 @@ namespace stan {
         return 0;
       }
 
+      template <bool propto, bool jacobian_adjust_transforms, typename T>
+      T log_prob(std::vector<T>& params_r, std::vector<int>& params_i,
+                 std::ostream* output_stream = 0) const {
+        return 0;
+      }
+
       // template <bool propto, bool jacobian_adjust_transforms>
       // double grad_log_prob(std::vector<double>& params_r,
       //                      std::vector<int>& params_i,
@@ -2,6 +2,8 @@
 #include <stan/callbacks/stream_logger.hpp>
 #include <stan/mcmc/hmc/nuts/base_nuts.hpp>
 #include <stan/mcmc/hmc/integrators/expl_leapfrog.hpp>
+#include <cmath>
+#include <string>
 #include <vector>
 #include <boost/random/additive_combine.hpp>
 #include <gtest/gtest.h>
@@ -353,3 +355,87 @@ TEST(McmcNutsBaseNuts, transition) {
   EXPECT_EQ("", error.str());
   EXPECT_EQ("", fatal.str());
 }
+
+TEST(McmcNutsBaseNuts, speculative_transition) {
+  rng_t base_rng(0);
+
+  int model_size = 1;
+  double init_momentum = 1.5;
+
+  stan::mcmc::ps_point z_init(model_size);
+  z_init.q(0) = 0;
+  z_init.p(0) = init_momentum;
+
+  stan::mcmc::mock_model model(model_size);
+  stan::mcmc::mock_nuts sampler(model, base_rng);
+
+  sampler.set_nominal_stepsize(1);
+  sampler.set_stepsize_jitter(0);
+  sampler.sample_stepsize();
+  sampler.set_speculative(true);
+  EXPECT_TRUE(sampler.get_speculative());
+  sampler.z() = z_init;
+
+  std::stringstream debug, info, warn, error, fatal;
+  stan::callbacks::stream_logger logger(debug, info, warn, error, fatal);
+
+  stan::mcmc::sample init_sample(z_init.q, 0, 0);
+
+  // Transition will expand trajectory until max_depth is hit
+  stan::mcmc::sample s = sampler.transition(init_sample, logger);
+
+  EXPECT_EQ(sampler.get_max_depth(), sampler.depth_);
+  EXPECT_EQ((2 << (sampler.get_max_depth() - 1)) - 1, sampler.n_leapfrog_);
+  EXPECT_FALSE(sampler.divergent_);
+
+  // the draw is a whole number of steps from the initial point
+  double steps = s.cont_params()(0) / init_momentum;
+  EXPECT_EQ(std::floor(steps), steps);
+  EXPECT_LE(std::fabs(steps), sampler.n_leapfrog_);
+  EXPECT_EQ(0, s.log_prob());
+  EXPECT_EQ(1, s.accept_stat());
+
+  std::vector<std::string> names;
+  std::vector<double> values;
+  sampler.get_sampler_param_names(names);
+  sampler.get_sampler_params(values);
+  ASSERT_EQ(6U, names.size());
+  ASSERT_EQ(6U, values.size());
+  EXPECT_EQ("wall_time__", names[5]);
+  EXPECT_LE(0, values[5]);
+
+  EXPECT_EQ("", debug.str());
+  EXPECT_EQ("", info.str());
+  EXPECT_EQ("", warn.str());
+  EXPECT_EQ("", error.str());
+  EXPECT_EQ("", fatal.str());
+}
+
+TEST(McmcNutsBaseNuts, speculative_transition_reproducible) {
+  int model_size = 1;
+  stan::mcmc::ps_point z_init(model_size);
+  z_init.q(0) = 0;
+  z_init.p(0) = 1;
+
+  stan::mcmc::mock_model model(model_size);
+  std::stringstream debug, info, warn, error, fatal;
+  stan::callbacks::stream_logger logger(debug, info, warn, error, fatal);
+
+  std::vector<std::vector<double> > draws(2);
+  for (int run = 0; run < 2; ++run) {
+    rng_t base_rng(1234);
+    stan::mcmc::mock_nuts sampler(model, base_rng);
+    sampler.set_nominal_stepsize(1);
+    sampler.set_speculative(true);
+    sampler.z() = z_init;
+
+    stan::mcmc::sample s(z_init.q, 0, 0);
+    for (int n = 0; n < 20; ++n) {
+      sampler.z().p = z_init.p;
+      s = sampler.transition(s, logger);
+      draws[run].push_back(s.cont_params()(0));
+    }
+  }
+  for (size_t n = 0; n < draws[0].size(); ++n)
+    EXPECT_EQ(draws[0][n], draws[1][n]);
+}
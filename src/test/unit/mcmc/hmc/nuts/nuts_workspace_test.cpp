@@ -0,0 +1,94 @@
+#include <stan/mcmc/hmc/nuts/nuts_workspace.hpp>
+#include <gtest/gtest.h>
+#include <limits>
+
+TEST(McmcNutsWorkspace, construction) {
+  stan::mcmc::nuts_workspace workspace(3, 5);
+
+  EXPECT_EQ(3, workspace.z_plus.q.size());
+  EXPECT_EQ(3, workspace.z_minus.p.size());
+  EXPECT_EQ(3, workspace.z_sample.g.size());
+  EXPECT_EQ(3, workspace.z_propose.q.size());
+  EXPECT_EQ(3, workspace.p_sharp_plus.size());
+  EXPECT_EQ(3, workspace.p_sharp_minus.size());
+  EXPECT_EQ(3, workspace.p_sharp_dummy.size());
+  EXPECT_EQ(3, workspace.rho.size());
+  EXPECT_EQ(3, workspace.rho_subtree.size());
+
+  for (int depth = 1; depth <= 5; ++depth) {
+    stan::mcmc::nuts_subtree_workspace& subtree = workspace.subtree(depth);
+    EXPECT_EQ(3, subtree.z_propose_right.q.size());
+    EXPECT_EQ(3, subtree.p_sharp_dummy.size());
+    EXPECT_EQ(3, subtree.rho_left.size());
+    EXPECT_EQ(3, subtree.rho_right.size());
+  }
+}
+
+TEST(McmcNutsWorkspace, levels_are_distinct) {
+  stan::mcmc::nuts_workspace workspace(2, 4);
+  for (int depth = 1; depth < 4; ++depth)
+    EXPECT_NE(workspace.subtree(depth).rho_left.data(),
+              workspace.subtree(depth + 1).rho_left.data());
+}
+
+TEST(McmcNutsWorkspace, storage_is_reused) {
+  stan::mcmc::nuts_workspace workspace(2, 4);
+  const double* rho_left = workspace.subtree(4).rho_left.data();
+  const double* q_right = workspace.subtree(2).z_propose_right.q.data();
+  const double* z_plus = workspace.z_plus.q.data();
+
+  workspace.reserve_depth(3);
+  stan::mcmc::ps_point z(2);
+  z.q << 1, 2;
+  workspace.z_plus = z;
+  workspace.subtree(2).z_propose_right = z;
+
+  EXPECT_EQ(rho_left, workspace.subtree(4).rho_left.data());
+  EXPECT_EQ(q_right, workspace.subtree(2).z_propose_right.q.data());
+  EXPECT_EQ(z_plus, workspace.z_plus.q.data());
+  EXPECT_EQ(2, workspace.z_plus.q(1));
+}
+
+TEST(McmcNutsWorkspace, grows_with_depth) {
+  stan::mcmc::nuts_workspace workspace(2, 1);
+  workspace.reserve_depth(8);
+  EXPECT_EQ(2, workspace.subtree(8).rho_right.size());
+  // asking for a deeper level than reserved grows the workspace
+  EXPECT_EQ(2, workspace.subtree(10).rho_right.size());
+}
+
+TEST(McmcNutsWorkspace, begin_links_halves_to_parent) {
+  stan::mcmc::nuts_workspace workspace(2, 3);
+  stan::mcmc::nuts_subtree_workspace& parent = workspace.subtree(2);
+  stan::mcmc::nuts_subtree_workspace& child = workspace.subtree(1);
+
+  double log_sum_weight = 0;
+  parent.begin(workspace.z_propose, workspace.p_sharp_dummy,
+               workspace.p_sharp_plus, workspace.rho_subtree,
+               log_sum_weight);
+  EXPECT_FALSE(parent.building_right);
+  EXPECT_EQ(-std::numeric_limits<double>::infinity(),
+            parent.log_sum_weight_left);
+  EXPECT_EQ(0, parent.rho_left.squaredNorm());
+  EXPECT_EQ(&log_sum_weight, parent.log_sum_weight);
+
+  // the left half shares the left boundary and proposal of its parent
+  child.begin(parent);
+  EXPECT_EQ(&workspace.z_propose, child.z_propose);
+  EXPECT_EQ(&workspace.p_sharp_dummy, child.p_sharp_left);
+  EXPECT_EQ(&parent.p_sharp_dummy, child.p_sharp_right);
+  EXPECT_EQ(&parent.rho_left, child.rho);
+  EXPECT_EQ(&parent.log_sum_weight_left, child.log_sum_weight);
+
+  // the right half shares the right boundary of its parent
+  parent.begin_right();
+  EXPECT_TRUE(parent.building_right);
+  EXPECT_EQ(-std::numeric_limits<double>::infinity(),
+            parent.log_sum_weight_right);
+  child.begin(parent);
+  EXPECT_EQ(&parent.z_propose_right, child.z_propose);
+  EXPECT_EQ(&parent.p_sharp_dummy, child.p_sharp_left);
+  EXPECT_EQ(&workspace.p_sharp_plus, child.p_sharp_right);
+  EXPECT_EQ(&parent.rho_right, child.rho);
+  EXPECT_EQ(&parent.log_sum_weight_right, child.log_sum_weight);
+}
@@ -0,0 +1,63 @@
+#include <stan/mcmc/hmc/nuts/speculative_subtree.hpp>
+#include <gtest/gtest.h>
+#include <atomic>
+#include <stdexcept>
+
+TEST(McmcNutsSpeculativeSubtree, join_waits_for_result) {
+  stan::mcmc::speculative_subtree speculation;
+  EXPECT_FALSE(speculation.running());
+
+  int result = 0;
+  speculation.launch([&result](const std::atomic<bool>& cancel) {
+      result = 42;
+    });
+  EXPECT_TRUE(speculation.running());
+  speculation.join();
+  EXPECT_FALSE(speculation.running());
+  EXPECT_EQ(42, result);
+
+  // joining again is a no-op
+  speculation.join();
+}
+
+TEST(McmcNutsSpeculativeSubtree, cancel_stops_build) {
+  stan::mcmc::speculative_subtree speculation;
+  std::atomic<bool> started(false);
+  bool cancelled = false;
+  speculation.launch([&](const std::atomic<bool>& cancel) {
+      started = true;
+      while (!cancel) {}
+      cancelled = true;
+    });
+  while (!started) {}
+  speculation.cancel();
+  EXPECT_FALSE(speculation.running());
+  EXPECT_TRUE(cancelled);
+}
+
+TEST(McmcNutsSpeculativeSubtree, join_rethrows) {
+  stan::mcmc::speculative_subtree speculation;
+  speculation.launch([](const std::atomic<bool>& cancel) {
+      throw std::domain_error("speculative failure");
+    });
+  EXPECT_THROW(speculation.join(), std::domain_error);
+  EXPECT_FALSE(speculation.running());
+
+  // a cancelled failure is discarded
+  speculation.launch([](const std::atomic<bool>& cancel) {
+      throw std::domain_error("speculative failure");
+    });
+  EXPECT_NO_THROW(speculation.cancel());
+}
+
+TEST(McmcNutsSpeculativeSubtree, destructor_cancels) {
+  bool cancelled = false;
+  {
+    stan::mcmc::speculative_subtree speculation;
+    speculation.launch([&](const std::atomic<bool>& cancel) {
+        while (!cancel) {}
+        cancelled = true;
+      });
+  }
+  EXPECT_TRUE(cancelled);
+}
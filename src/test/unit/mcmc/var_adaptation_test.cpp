@@ -1,6 +1,7 @@
 #include <stan/mcmc/var_adaptation.hpp>
 #include <test/unit/services/instrumented_callbacks.hpp>
 #include <gtest/gtest.h>
+#include <vector>
 
 TEST(McmcVarAdaptation, learn_variance) {
   stan::test::unit::instrumented_logger logger;
@@ -25,3 +26,29 @@ TEST(McmcVarAdaptation, learn_variance) {
 
   EXPECT_EQ(0, logger.call_count());
 }
+
+TEST(McmcVarAdaptation, stage_lengths_match_updates) {
+  stan::test::unit::instrumented_logger logger;
+
+  const int n = 2;
+  Eigen::VectorXd q = Eigen::VectorXd::Zero(n);
+  Eigen::VectorXd var(Eigen::VectorXd::Zero(n));
+
+  stan::mcmc::var_adaptation adapter(n);
+  adapter.set_window_params(200, 15, 20, 10, logger);
+  std::vector<unsigned int> lengths = adapter.stage_lengths();
+
+  // the metric is updated at the end of every stage but the last
+  std::vector<unsigned int> updates;
+  for (unsigned int i = 0; i < 200; ++i)
+    if (adapter.learn_variance(var, q))
+      updates.push_back(i);
+
+  ASSERT_EQ(updates.size() + 2, lengths.size());
+  unsigned int end = lengths[0];
+  for (size_t k = 0; k < updates.size(); ++k) {
+    end += lengths[k + 1];
+    EXPECT_EQ(end - 1, updates[k]);
+  }
+  EXPECT_EQ(200U, end + lengths.back());
+}
@@ -1,6 +1,7 @@
 #include <stan/mcmc/windowed_adaptation.hpp>
 #include <test/unit/services/instrumented_callbacks.hpp>
 #include <gtest/gtest.h>
+#include <vector>
 
 TEST(McmcWindowedAdaptation, set_window_params1) {
   stan::test::unit::instrumented_logger logger;
@@ -40,3 +41,25 @@ TEST(McmcWindowedAdaptation, set_window_params3) {
   ASSERT_EQ(0, logger.call_count());
   ASSERT_EQ(0, logger.call_count_info());
 }
+
+TEST(McmcWindowedAdaptation, stage_lengths) {
+  stan::test::unit::instrumented_logger logger;
+
+  stan::mcmc::windowed_adaptation adapter("test");
+  EXPECT_EQ(0U, adapter.stage_lengths().size());
+
+  adapter.set_window_params(1000, 75, 50, 25, logger);
+  std::vector<unsigned int> lengths = adapter.stage_lengths();
+  ASSERT_EQ(7U, lengths.size());
+  EXPECT_EQ(75U, lengths[0]);
+  EXPECT_EQ(25U, lengths[1]);
+  EXPECT_EQ(50U, lengths[2]);
+  EXPECT_EQ(100U, lengths[3]);
+  EXPECT_EQ(200U, lengths[4]);
+  EXPECT_EQ(500U, lengths[5]);
+  EXPECT_EQ(50U, lengths[6]);
+
+  stan::mcmc::windowed_adaptation short_adapter("test");
+  short_adapter.set_window_params(10, 1, 1, 1, logger);
+  EXPECT_EQ(0U, short_adapter.stage_lengths().size());
+}
@@ -0,0 +1,53 @@
+#include <stan/model/gradient_evaluator.hpp>
+#include <test/unit/services/instrumented_callbacks.hpp>
+#include <test/test-models/good/mcmc/hmc/hamiltonians/funnel.hpp>
+#include <gtest/gtest.h>
+
+class ModelGradientEvaluator : public testing::Test {
+public:
+  ModelGradientEvaluator()
+    : data_stream(std::string("").c_str(), std::fstream::in),
+      data_var_context(data_stream),
+      model(data_var_context, &output) { }
+
+  std::fstream data_stream;
+  stan::io::dump data_var_context;
+  std::stringstream output;
+  funnel_model_namespace::funnel_model model;
+  stan::test::unit::instrumented_logger logger;
+};
+
+TEST_F(ModelGradientEvaluator, matches_gradient) {
+  stan::model::gradient_evaluator<funnel_model_namespace::funnel_model>
+    evaluator(model);
+
+  Eigen::VectorXd x(11);
+  for (int n = 0; n < 5; ++n) {
+    for (int i = 0; i < x.size(); ++i)
+      x(i) = 0.1 * (n + 1) * (i - 5);
+
+    double f;
+    Eigen::VectorXd g;
+    stan::model::gradient(model, x, f, g);
+
+    Eigen::VectorXd grad_f;
+    EXPECT_FLOAT_EQ(f, evaluator.eval(x, grad_f, logger));
+    ASSERT_EQ(g.size(), grad_f.size());
+    for (int i = 0; i < g.size(); ++i)
+      EXPECT_FLOAT_EQ(g(i), grad_f(i));
+  }
+  EXPECT_EQ("", output.str());
+  EXPECT_EQ(0, logger.call_count());
+}
+
+TEST_F(ModelGradientEvaluator, funnel_values) {
+  stan::model::gradient_evaluator<funnel_model_namespace::funnel_model>
+    evaluator(model);
+
+  Eigen::VectorXd x = Eigen::VectorXd::Ones(11);
+  Eigen::VectorXd grad_f;
+  EXPECT_FLOAT_EQ(-10.73223197, evaluator.eval(x, grad_f, logger));
+  EXPECT_FLOAT_EQ(-8.757758279, grad_f(0));
+  for (int i = 1; i < x.size(); ++i)
+    EXPECT_FLOAT_EQ(-0.1353352832, grad_f(i));
+}
@@ -0,0 +1,115 @@
+#include <stan/model/log_prob_batch.hpp>
+#include <stan/model/prob_grad.hpp>
+#include <test/test-models/good/mcmc/hmc/hamiltonians/funnel.hpp>
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+class throwing_model : public stan::model::prob_grad {
+public:
+  throwing_model() : stan::model::prob_grad(1) { }
+
+  template <bool propto, bool jacobian_adjust_transforms, typename T>
+  T log_prob(Eigen::Matrix<T, Eigen::Dynamic, 1>& params_r,
+             std::ostream* output_stream = 0) const {
+    if (output_stream)
+      *output_stream << "x = " << params_r(0) << ";";
+    if (params_r(0) < 0)
+      throw std::domain_error("negative x");
+    return -params_r(0);
+  }
+};
+
+class ModelLogProbBatch : public testing::Test {
+public:
+  ModelLogProbBatch()
+    : data_stream(std::string("").c_str(), std::fstream::in),
+      data_var_context(data_stream),
+      model(data_var_context, &output),
+      points(11, 4) {
+    for (int k = 0; k < points.cols(); ++k)
+      for (int i = 0; i < points.rows(); ++i)
+        points(i, k) = 0.1 * (k + 1) * (i - 5);
+  }
+
+  std::fstream data_stream;
+  stan::io::dump data_var_context;
+  std::stringstream output;
+  funnel_model_namespace::funnel_model model;
+  Eigen::MatrixXd points;
+};
+
+TEST_F(ModelLogProbBatch, log_prob_batch) {
+  Eigen::VectorXd log_prob;
+  std::vector<std::exception_ptr> errors;
+  stan::model::log_prob_batch<false, true>(model, points, log_prob, errors);
+  ASSERT_EQ(points.cols(), log_prob.size());
+  ASSERT_EQ(points.cols(), errors.size());
+  for (int k = 0; k < points.cols(); ++k) {
+    std::vector<double> x(points.col(k).data(),
+                          points.col(k).data() + points.rows());
+    std::vector<int> params_i;
+    EXPECT_FLOAT_EQ(model.log_prob<false, true>(x, params_i), log_prob(k));
+    EXPECT_FALSE(errors[k]);
+  }
+
+  stan::model::log_prob_batch<true, true>(model, points, log_prob, errors);
+  for (int k = 0; k < points.cols(); ++k) {
+    std::vector<double> x(points.col(k).data(),
+                          points.col(k).data() + points.rows());
+    std::vector<int> params_i;
+    EXPECT_FLOAT_EQ(stan::model::log_prob_propto<true>(model, x, params_i),
+                    log_prob(k));
+  }
+  EXPECT_EQ("", output.str());
+}
+
+TEST_F(ModelLogProbBatch, log_prob_grad_batch) {
+  Eigen::VectorXd log_prob;
+  Eigen::MatrixXd gradient;
+  std::vector<std::exception_ptr> errors;
+  stan::model::log_prob_grad_batch<true, true>(model, points, log_prob,
+                                               gradient, errors);
+  ASSERT_EQ(points.cols(), log_prob.size());
+  ASSERT_EQ(points.rows(), gradient.rows());
+  ASSERT_EQ(points.cols(), gradient.cols());
+  for (int k = 0; k < points.cols(); ++k) {
+    std::vector<double> x(points.col(k).data(),
+                          points.col(k).data() + points.rows());
+    std::vector<int> params_i;
+    std::vector<double> grad;
+    EXPECT_FLOAT_EQ(stan::model::log_prob_grad<true, true>(model, x,
+                                                           params_i, grad),
+                    log_prob(k));
+    for (int i = 0; i < points.rows(); ++i)
+      EXPECT_FLOAT_EQ(grad[i], gradient(i, k));
+    EXPECT_FALSE(errors[k]);
+  }
+}
+
+TEST(ModelLogProbBatchErrors, errors_and_messages) {
+  throwing_model model;
+  Eigen::MatrixXd points(1, 3);
+  points << 1, -1, 2;
+
+  Eigen::VectorXd log_prob;
+  Eigen::MatrixXd gradient;
+  std::vector<std::exception_ptr> errors;
+  std::stringstream msgs;
+  stan::model::log_prob_grad_batch<true, true>(model, points, log_prob,
+                                               gradient, errors, &msgs);
+  EXPECT_EQ("x = 1;x = -1;x = 2;", msgs.str());
+  EXPECT_FLOAT_EQ(-1, log_prob(0));
+  EXPECT_FLOAT_EQ(-1, gradient(0, 0));
+  EXPECT_FLOAT_EQ(-2, log_prob(2));
+  EXPECT_FALSE(errors[0]);
+  EXPECT_FALSE(errors[2]);
+  ASSERT_TRUE(errors[1] != 0);
+  EXPECT_THROW(std::rethrow_exception(errors[1]), std::domain_error);
+
+  msgs.str("");
+  stan::model::log_prob_batch<false, true>(model, points, log_prob, errors,
+                                           &msgs);
+  EXPECT_EQ("x = 1;x = -1;x = 2;", msgs.str());
+  EXPECT_FLOAT_EQ(-1, log_prob(0));
+  EXPECT_TRUE(errors[1] != 0);
+}
@@ -122,3 +122,41 @@ TEST(OptimizationLbfgsUpdate, search_direction) {
     }
   }
 }
+
+TEST(OptimizationLbfgsUpdate, inv_hessian_diagonal) {
+  typedef stan::optimization::LBFGSUpdate<> QNUpdateT;
+  typedef QNUpdateT::VectorT VectorT;
+
+  const unsigned int nDim = 6;
+  VectorT yk(nDim), sk(nDim), ek(nDim), sdir(nDim), diag(nDim);
+
+  QNUpdateT bfgsUp(3);
+  bfgsUp.inv_hessian_diagonal(diag, nDim);
+  for (unsigned int i = 0; i < nDim; i++)
+    EXPECT_FLOAT_EQ(1.0, diag[i]);
+
+  // Updates from a quadratic with a dense Hessian, compared against
+  // the diagonal of the matrix applied by search_direction.
+  Eigen::MatrixXd A = Eigen::MatrixXd::Identity(nDim, nDim);
+  for (unsigned int i = 0; i < nDim; i++) {
+    A(i, i) += i;
+    if (i > 0) {
+      A(i, i - 1) = 0.5;
+      A(i - 1, i) = 0.5;
+    }
+  }
+  for (unsigned int k = 0; k < 5; k++) {
+    for (unsigned int i = 0; i < nDim; i++)
+      sk[i] = std::cos(1.0 + k * nDim + i);
+    yk = A * sk;
+    bfgsUp.update(yk, sk, k == 0);
+
+    bfgsUp.inv_hessian_diagonal(diag, nDim);
+    for (unsigned int i = 0; i < nDim; i++) {
+      ek.setZero(nDim);
+      ek[i] = 1;
+      bfgsUp.search_direction(sdir, ek);
+      EXPECT_NEAR(-sdir[i], diag[i], 1e-10);
+    }
+  }
+}
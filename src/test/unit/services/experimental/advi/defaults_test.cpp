@@ -61,6 +61,21 @@ TEST(experimental_advi_defaults, eta) {
   EXPECT_FLOAT_EQ(1.0, eta::default_value());
 }
 
+TEST(experimental_advi_defaults, optimizer) {
+  using stan::services::experimental::advi::optimizer;
+  EXPECT_EQ("Optimizer for stochastic gradient ascent:"
+            " sequence, adam, amsgrad or rmsprop.",
+            optimizer::description());
+
+  EXPECT_NO_THROW(optimizer::validate(optimizer::default_value()));
+  EXPECT_NO_THROW(optimizer::validate("adam"));
+  EXPECT_NO_THROW(optimizer::validate("amsgrad"));
+  EXPECT_NO_THROW(optimizer::validate("rmsprop"));
+  EXPECT_THROW(optimizer::validate("sgd"), std::invalid_argument);
+
+  EXPECT_EQ("sequence", optimizer::default_value());
+}
+
 TEST(experimental_advi_defaults, adapt_engaged) {
   using stan::services::experimental::advi::adapt_engaged;
   EXPECT_EQ("Boolean flag for eta adaptation.",
@@ -4,8 +4,10 @@
 #include <stan/callbacks/stream_writer.hpp>
 #include <stan/callbacks/writer.hpp>
 #include <stan/callbacks/interrupt.hpp>
+#include <stan/callbacks/logger.hpp>
 #include <Eigen/Dense>
 #include <map>
+#include <mutex>
 #include <string>
 #include <iostream>
 #include <exception>
@@ -280,6 +282,91 @@ namespace stan {
         std::vector<std::string> fatal_;
       };
 
+      /**
+       * synchronized_interrupt forwards each call to an interrupt
+       * under a mutex, so that chains running on several threads can
+       * share an instrumented_interrupt.
+       */
+      class synchronized_interrupt: public stan::callbacks::interrupt {
+      public:
+        explicit synchronized_interrupt(stan::callbacks::interrupt& interrupt)
+          : interrupt_(interrupt) {}
+
+        void operator()() {
+          std::lock_guard<std::mutex> lock(mutex_);
+          interrupt_();
+        }
+
+      private:
+        stan::callbacks::interrupt& interrupt_;
+        std::mutex mutex_;
+      };
+
+      /**
+       * synchronized_logger forwards each message to a logger under a
+       * mutex, so that chains running on several threads can share an
+       * instrumented_logger.
+       */
+      class synchronized_logger : public stan::callbacks::logger {
+      public:
+        explicit synchronized_logger(stan::callbacks::logger& logger)
+          : logger_(logger) {}
+
+        void debug(const std::string& message) {
+          std::lock_guard<std::mutex> lock(mutex_);
+          logger_.debug(message);
+        }
+
+        void debug(const std::stringstream& message) {
+          std::lock_guard<std::mutex> lock(mutex_);
+          logger_.debug(message);
+        }
+
+        void info(const std::string& message) {
+          std::lock_guard<std::mutex> lock(mutex_);
+          logger_.info(message);
+        }
+
+        void info(const std::stringstream& message) {
+          std::lock_guard<std::mutex> lock(mutex_);
+          logger_.info(message);
+        }
+
+        void warn(const std::string& message) {
+          std::lock_guard<std::mutex> lock(mutex_);
+          logger_.warn(message);
+        }
+
+        void warn(const std::stringstream& message) {
+          std::lock_guard<std::mutex> lock(mutex_);
+          logger_.warn(message);
+        }
+
+        void error(const std::string& message) {
+          std::lock_guard<std::mutex> lock(mutex_);
+          logger_.error(message);
+        }
+
+        void error(const std::stringstream& message) {
+          std::lock_guard<std::mutex> lock(mutex_);
+          logger_.error(message);
+        }
+
+        void fatal(const std::string& message) {
+          std::lock_guard<std::mutex> lock(mutex_);
+          logger_.fatal(message);
+        }
+
+        void fatal(const std::stringstream& message) {
+          std::lock_guard<std::mutex> lock(mutex_);
+          logger_.fatal(message);
+        }
+
+      private:
+        stan::callbacks::logger& logger_;
+        std::mutex mutex_;
+      };
+
 
     }
   }
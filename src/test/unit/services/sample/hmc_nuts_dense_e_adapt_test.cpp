@@ -194,3 +194,137 @@ TEST_F(ServicesSampleHmcNutsDenseEAdapt, output_regression) {
   EXPECT_EQ(1, logger.find_info("seconds (Total)"));
   EXPECT_EQ(0, logger.call_count_error());
 }
+
+TEST_F(ServicesSampleHmcNutsDenseEAdapt, multiple_chains_match_single_chains) {
+  unsigned int random_seed = 0;
+  unsigned int chain = 1;
+  double init_radius = 2;
+  int num_warmup = 200;
+  int num_samples = 400;
+  int num_thin = 5;
+  bool save_warmup = true;
+  int refresh = 0;
+  double stepsize = 0.1;
+  double stepsize_jitter = 0;
+  int max_depth = 8;
+  double delta = .1;
+  double gamma = .1;
+  double kappa = .1;
+  double t0 = .1;
+  unsigned int init_buffer = 50;
+  unsigned int term_buffer = 50;
+  unsigned int window = 100;
+  stan::test::unit::instrumented_interrupt interrupt;
+  const size_t num_chains = 3;
+
+  std::vector<stan::test::unit::instrumented_writer> single_parameter(
+      num_chains);
+  for (size_t n = 0; n < num_chains; ++n) {
+    stan::test::unit::instrumented_writer single_init, single_diagnostic;
+    int return_code = stan::services::sample::hmc_nuts_dense_e_adapt(
+        model, context, random_seed, chain + n, init_radius,
+        num_warmup, num_samples, num_thin, save_warmup, refresh,
+        stepsize, stepsize_jitter, max_depth, delta, gamma, kappa, t0,
+        init_buffer, term_buffer, window,
+        interrupt, logger, single_init,
+        single_parameter[n], single_diagnostic);
+    EXPECT_EQ(0, return_code);
+  }
+
+  std::vector<stan::test::unit::instrumented_writer> inits(num_chains),
+    parameters(num_chains), diagnostics(num_chains);
+  std::vector<stan::io::var_context*> init_contexts(num_chains, &context);
+  std::vector<stan::callbacks::writer*> init_writers, parameter_writers,
+    diagnostic_writers;
+  for (size_t n = 0; n < num_chains; ++n) {
+    init_writers.push_back(&inits[n]);
+    parameter_writers.push_back(&parameters[n]);
+    diagnostic_writers.push_back(&diagnostics[n]);
+  }
+
+  int return_code = stan::services::sample::hmc_nuts_dense_e_adapt(
+      model, num_chains, init_contexts, random_seed, chain, init_radius,
+      num_warmup, num_samples, num_thin, save_warmup, refresh,
+      stepsize, stepsize_jitter, max_depth, delta, gamma, kappa, t0,
+      init_buffer, term_buffer, window,
+      interrupt, logger, init_writers,
+      parameter_writers, diagnostic_writers);
+  EXPECT_EQ(0, return_code);
+
+  for (size_t n = 0; n < num_chains; ++n) {
+    std::vector<std::vector<double> > expected
+      = single_parameter[n].vector_double_values();
+    std::vector<std::vector<double> > found
+      = parameters[n].vector_double_values();
+    ASSERT_EQ(expected.size(), found.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+      ASSERT_EQ(expected[i].size(), found[i].size());
+      for (size_t j = 0; j < expected[i].size(); ++j)
+        EXPECT_EQ(expected[i][j], found[i][j]);
+    }
+  }
+  EXPECT_NE(parameters[0].vector_double_values().back(),
+            parameters[1].vector_double_values().back());
+}
+
+TEST_F(ServicesSampleHmcNutsDenseEAdapt, multiple_chains_size_mismatch) {
+  stan::test::unit::instrumented_interrupt interrupt;
+  std::vector<stan::io::var_context*> init_contexts(2, &context);
+  std::vector<stan::callbacks::writer*> writers(1, &parameter);
+
+  int return_code = stan::services::sample::hmc_nuts_dense_e_adapt(
+      model, 2, init_contexts, 0, 1, 0,
+      200, 400, 5, true, 0,
+      0.1, 0, 8, .1, .1, .1, .1,
+      50, 50, 100,
+      interrupt, logger, writers, writers, writers);
+  EXPECT_EQ(stan::services::error_codes::CONFIG, return_code);
+  EXPECT_EQ(0, parameter.call_count("vector_double"));
+  EXPECT_EQ(1, logger.call_count_error());
+}
+
+TEST_F(ServicesSampleHmcNutsDenseEAdapt, multiple_chains_stop_early) {
+  stan::test::unit::instrumented_interrupt interrupt;
+  const size_t num_chains = 2;
+  int num_samples = 20000;
+  std::vector<stan::test::unit::instrumented_writer> inits(num_chains),
+    parameters(num_chains), diagnostics(num_chains);
+  std::vector<stan::io::var_context*> init_contexts(num_chains, &context);
+  std::vector<stan::callbacks::writer*> init_writers, parameter_writers,
+    diagnostic_writers;
+  for (size_t n = 0; n < num_chains; ++n) {
+    init_writers.push_back(&inits[n]);
+    parameter_writers.push_back(&parameters[n]);
+    diagnostic_writers.push_back(&diagnostics[n]);
+  }
+
+  // only min_ess is set, so the default max_rhat applies
+  int return_code = stan::services::sample::hmc_nuts_dense_e_adapt(
+      model, num_chains, init_contexts, 0, 1, 2,
+      200, num_samples, 1, false, 50,
+      0.1, 0, 8, .8, .05, .75, 10,
+      50, 50, 25,
+      interrupt, logger, init_writers,
+      parameter_writers, diagnostic_writers, 20);
+  EXPECT_EQ(0, return_code);
+  EXPECT_LT(0, logger.find_info("Stopping sampling early"));
+  EXPECT_GT(num_samples,
+            parameters[num_chains - 1].call_count("vector_double"));
+  EXPECT_EQ(0, logger.call_count_error());
+}
+
+TEST_F(ServicesSampleHmcNutsDenseEAdapt, multiple_chains_max_rhat_below_one) {
+  stan::test::unit::instrumented_interrupt interrupt;
+  std::vector<stan::io::var_context*> init_contexts(2, &context);
+  std::vector<stan::callbacks::writer*> writers(2, &parameter);
+
+  int return_code = stan::services::sample::hmc_nuts_dense_e_adapt(
+      model, 2, init_contexts, 0, 1, 0,
+      200, 400, 5, true, 0,
+      0.1, 0, 8, .1, .1, .1, .1,
+      50, 50, 100,
+      interrupt, logger, writers, writers, writers, 100, 0);
+  EXPECT_EQ(stan::services::error_codes::CONFIG, return_code);
+  EXPECT_EQ(0, parameter.call_count("vector_double"));
+  EXPECT_EQ(1, logger.call_count_error());
+}
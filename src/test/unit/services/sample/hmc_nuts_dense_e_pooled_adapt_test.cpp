@@ -0,0 +1,119 @@
+#include <stan/services/sample/hmc_nuts_dense_e_pooled_adapt.hpp>
+#include <gtest/gtest.h>
+#include <stan/io/empty_var_context.hpp>
+#include <test/test-models/good/optimization/rosenbrock.hpp>
+#include <test/unit/services/instrumented_callbacks.hpp>
+#include <iostream>
+
+class ServicesSampleHmcNutsDenseEPooledAdapt : public testing::Test {
+public:
+  ServicesSampleHmcNutsDenseEPooledAdapt()
+    : model(context, &model_log),
+      inits(num_chains), parameters(num_chains), diagnostics(num_chains),
+      init_contexts(num_chains, &context) {
+    for (size_t n = 0; n < num_chains; ++n) {
+      init_writers.push_back(&inits[n]);
+      parameter_writers.push_back(&parameters[n]);
+      diagnostic_writers.push_back(&diagnostics[n]);
+    }
+  }
+
+  static const size_t num_chains = 3;
+  std::stringstream model_log;
+  stan::test::unit::instrumented_logger logger;
+  stan::io::empty_var_context context;
+  stan_model model;
+  std::vector<stan::test::unit::instrumented_writer> inits, parameters,
+    diagnostics;
+  std::vector<stan::io::var_context*> init_contexts;
+  std::vector<stan::callbacks::writer*> init_writers, parameter_writers,
+    diagnostic_writers;
+};
+
+TEST_F(ServicesSampleHmcNutsDenseEPooledAdapt, shared_adaptation) {
+  unsigned int random_seed = 0;
+  unsigned int chain = 1;
+  double init_radius = 2;
+  int num_warmup = 200;
+  int num_samples = 100;
+  int num_thin = 1;
+  bool save_warmup = false;
+  int refresh = 0;
+  double stepsize = 0.1;
+  double stepsize_jitter = 0;
+  int max_depth = 8;
+  double delta = .8;
+  double gamma = .05;
+  double kappa = .75;
+  double t0 = 10;
+  unsigned int init_buffer = 50;
+  unsigned int term_buffer = 50;
+  unsigned int window = 25;
+  stan::test::unit::instrumented_interrupt interrupt;
+  // the chains share the callbacks across threads
+  stan::test::unit::synchronized_interrupt shared_interrupt(interrupt);
+  stan::test::unit::synchronized_logger shared_logger(logger);
+
+  int return_code = stan::services::sample::hmc_nuts_dense_e_pooled_adapt(
+      model, num_chains, init_contexts, random_seed, chain, init_radius,
+      num_warmup, num_samples, num_thin, save_warmup, refresh,
+      stepsize, stepsize_jitter, max_depth, delta, gamma, kappa, t0,
+      init_buffer, term_buffer, window,
+      shared_interrupt, shared_logger, init_writers,
+      parameter_writers, diagnostic_writers);
+
+#ifdef STAN_THREADS
+  EXPECT_EQ(0, return_code);
+  EXPECT_EQ(num_chains * (num_warmup + num_samples), interrupt.call_count());
+  EXPECT_EQ(0, logger.call_count_error());
+  std::vector<std::string> adaptation_info = parameters[0].string_values();
+  ASSERT_LT(2, adaptation_info.size());
+  for (size_t n = 0; n < num_chains; ++n) {
+    // step size and inverse metric are identical across chains
+    EXPECT_EQ(adaptation_info, parameters[n].string_values());
+    EXPECT_EQ(num_samples, parameters[n].call_count("vector_double"));
+  }
+  EXPECT_NE(parameters[0].vector_double_values().back(),
+            parameters[1].vector_double_values().back());
+#else
+  EXPECT_EQ(stan::services::error_codes::CONFIG, return_code);
+  EXPECT_EQ(1, logger.call_count_error());
+#endif
+}
+
+TEST_F(ServicesSampleHmcNutsDenseEPooledAdapt, single_chain) {
+  stan::test::unit::instrumented_interrupt interrupt;
+  init_contexts.resize(1);
+  init_writers.resize(1);
+  parameter_writers.resize(1);
+  diagnostic_writers.resize(1);
+
+  int return_code = stan::services::sample::hmc_nuts_dense_e_pooled_adapt(
+      model, 1, init_contexts, 0, 1, 0,
+      200, 400, 5, true, 0,
+      0.1, 0, 8, .1, .1, .1, .1,
+      50, 50, 100,
+      interrupt, logger, init_writers, parameter_writers,
+      diagnostic_writers);
+
+  EXPECT_EQ(0, return_code);
+  EXPECT_EQ(600, interrupt.call_count());
+  EXPECT_EQ(1, parameters[0].call_count("vector_string"));
+  EXPECT_EQ(120, parameters[0].call_count("vector_double"));
+  EXPECT_EQ(0, parameters[1].call_count("vector_double"));
+}
+
+TEST_F(ServicesSampleHmcNutsDenseEPooledAdapt, size_mismatch) {
+  stan::test::unit::instrumented_interrupt interrupt;
+  init_writers.resize(1);
+
+  int return_code = stan::services::sample::hmc_nuts_dense_e_pooled_adapt(
+      model, num_chains, init_contexts, 0, 1, 0,
+      200, 400, 5, true, 0,
+      0.1, 0, 8, .1, .1, .1, .1,
+      50, 50, 100,
+      interrupt, logger, init_writers, parameter_writers,
+      diagnostic_writers);
+  EXPECT_EQ(stan::services::error_codes::CONFIG, return_code);
+  EXPECT_EQ(0, interrupt.call_count());
+}
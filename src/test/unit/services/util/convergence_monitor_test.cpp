@@ -0,0 +1,55 @@
+#include <stan/services/util/convergence_monitor.hpp>
+#include <gtest/gtest.h>
+#include <test/unit/services/instrumented_callbacks.hpp>
+#include <boost/random/additive_combine.hpp>
+#include <boost/random/normal_distribution.hpp>
+#include <boost/random/variate_generator.hpp>
+
+class ServicesUtilConvergenceMonitor : public testing::Test {
+public:
+  ServicesUtilConvergenceMonitor()
+    : rng(1234),
+      normal(rng, boost::normal_distribution<>()) {}
+
+  stan::mcmc::sample draw() {
+    Eigen::VectorXd q(2);
+    q << normal(), normal();
+    return stan::mcmc::sample(q, normal(), 0.5);
+  }
+
+  stan::test::unit::instrumented_logger logger;
+  boost::ecuyer1988 rng;
+  boost::variate_generator<boost::ecuyer1988&,
+                           boost::normal_distribution<> > normal;
+};
+
+TEST_F(ServicesUtilConvergenceMonitor, stops_at_target) {
+  stan::analyze::online_diagnostics diagnostics(1, 3, 4);
+  stan::services::util::convergence_monitor
+    monitor(diagnostics, 0, 100, 1.1, 10);
+
+  int num_draws = 0;
+  while (!monitor.update(draw(), logger)) {
+    ++num_draws;
+    ASSERT_LT(num_draws, 1000);
+  }
+  ++num_draws;
+  EXPECT_EQ(0, num_draws % 10);
+  EXPECT_EQ(static_cast<size_t>(num_draws), diagnostics.num_draws(0));
+  EXPECT_TRUE(diagnostics.converged(100, 1.1));
+  EXPECT_EQ(static_cast<unsigned int>(num_draws / 10 + 1),
+            logger.call_count_info());
+  EXPECT_EQ(static_cast<unsigned int>(num_draws / 10),
+            logger.find_info("Convergence: minimum ESS = "));
+  EXPECT_EQ(1U, logger.find_info("Stopping sampling early"));
+}
+
+TEST_F(ServicesUtilConvergenceMonitor, waits_for_other_chains) {
+  stan::analyze::online_diagnostics diagnostics(2, 3, 4);
+  stan::services::util::convergence_monitor
+    monitor(diagnostics, 0, 10, 1.1, 10);
+
+  for (int n = 0; n < 1000; ++n)
+    EXPECT_FALSE(monitor.update(draw(), logger));
+  EXPECT_EQ(0U, logger.find_info("Stopping sampling early"));
+}
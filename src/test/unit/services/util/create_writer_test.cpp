@@ -0,0 +1,34 @@
+#include <stan/services/util/create_writer.hpp>
+#include <gtest/gtest.h>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+TEST(ServicesUtilCreateWriter, csv) {
+  std::stringstream ss;
+  std::unique_ptr<stan::callbacks::writer> writer
+    = stan::services::util::create_writer(
+        stan::services::util::output_format::CSV, ss, "# ");
+  (*writer)("comment");
+  (*writer)(std::vector<double>(2, 1.0));
+  EXPECT_EQ("# comment\n1,1\n", ss.str());
+}
+
+TEST(ServicesUtilCreateWriter, binary) {
+  std::stringstream ss;
+  {
+    std::unique_ptr<stan::callbacks::writer> writer
+      = stan::services::util::create_writer(
+          stan::services::util::output_format::BINARY, ss);
+    (*writer)(std::vector<double>(2, 1.0));
+  }
+  EXPECT_EQ("STANDRW1D", ss.str().substr(0, 9));
+  EXPECT_EQ(9U + 2 * 8 + 2 * 8, ss.str().size());
+}
+
+TEST(ServicesUtilCreateWriter, unknown_format) {
+  std::stringstream ss;
+  EXPECT_THROW(stan::services::util::create_writer(2, ss),
+               std::invalid_argument);
+}
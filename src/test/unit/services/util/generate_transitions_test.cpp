@@ -141,3 +141,47 @@ TEST_F(ServicesSamplesGenerateTransitions, output_sizes) {
   EXPECT_EQ(diagnostic_names[0].size(), diagnostic_values[0].size());
 
 }
+
+TEST_F(ServicesSamplesGenerateTransitions, convergence_monitor) {
+  unsigned int seed = 0;
+  unsigned int chain = 1;
+  double init_radius = 0;
+  int refresh = 0;
+  int num_iterations = 10;
+  stan::test::unit::instrumented_interrupt interrupt;
+
+  boost::ecuyer1988 rng = stan::services::util::create_rng(seed, chain);
+
+  std::vector<double> cont_vector
+    = stan::services::util::initialize(model, context, rng, init_radius,
+                                       false,
+                                       logger, diagnostic);
+
+  stan::mcmc::fixed_param_sampler sampler;
+  stan::services::util::mcmc_writer
+    writer(parameter, diagnostic, logger);
+  Eigen::VectorXd cont_params(cont_vector.size());
+  for (size_t i = 0; i < cont_vector.size(); i++)
+    cont_params[i] = cont_vector[i];
+  stan::mcmc::sample s(cont_params, 0, 0);
+
+  stan::analyze::online_diagnostics
+    diagnostics(1, model.num_params_r() + 1);
+  stan::services::util::convergence_monitor
+    monitor(diagnostics, 0, 1, 2, 5);
+
+  // warmup draws are not monitored
+  stan::services::util::generate_transitions(
+    sampler, num_iterations, 0, 20, 1, refresh, true, true, writer,
+    s, model, rng, interrupt, logger, 0, &monitor);
+  EXPECT_EQ(0U, diagnostics.num_draws(0));
+
+  // saved draws are monitored, but constant draws never converge
+  stan::services::util::generate_transitions(
+    sampler, num_iterations, 10, 20, 2, refresh, true, false, writer,
+    s, model, rng, interrupt, logger, 0, &monitor);
+  EXPECT_EQ(5U, diagnostics.num_draws(0));
+  EXPECT_EQ(1U, logger.find_info("Convergence: minimum ESS = "));
+  EXPECT_EQ(0U, logger.find_info("Stopping sampling early"));
+  EXPECT_EQ(2 * num_iterations, interrupt.call_count());
+}
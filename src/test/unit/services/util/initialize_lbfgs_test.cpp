@@ -0,0 +1,74 @@
+#include <stan/services/util/initialize_lbfgs.hpp>
+#include <stan/services/util/create_init_context.hpp>
+#include <gtest/gtest.h>
+#include <test/unit/util.hpp>
+#include <sstream>
+#include <test/test-models/good/services/test_lp.hpp>
+#include <stan/io/empty_var_context.hpp>
+#include <stan/services/util/create_rng.hpp>
+#include <test/unit/services/instrumented_callbacks.hpp>
+
+class ServicesUtilInitializeLbfgs : public testing::Test {
+ public:
+  ServicesUtilInitializeLbfgs()
+      : model(empty_context, 12345, &model_ss),
+        rng(stan::services::util::create_rng(0, 1)) {}
+
+  stan_model model;
+  stan::io::empty_var_context empty_context;
+  std::stringstream model_ss;
+  stan::test::unit::instrumented_logger logger;
+  stan::test::unit::instrumented_writer init;
+  boost::ecuyer1988 rng;
+};
+
+TEST_F(ServicesUtilInitializeLbfgs, radius_two) {
+  Eigen::VectorXd inv_metric;
+  std::vector<double> params
+    = stan::services::util::initialize_lbfgs(model, empty_context, rng,
+                                             2, 20, 5, 10, inv_metric,
+                                             logger, init);
+  ASSERT_EQ(model.num_params_r(), params.size());
+  ASSERT_EQ(model.num_params_r(), inv_metric.size());
+  for (int n = 0; n < inv_metric.size(); ++n) {
+    EXPECT_TRUE(boost::math::isfinite(params[n]));
+    EXPECT_GT(inv_metric(n), 0);
+  }
+  EXPECT_EQ(1, logger.find_info("L-BFGS initialization chose iteration"));
+
+  ASSERT_EQ(1, init.vector_double_values().size());
+  EXPECT_EQ(params, init.vector_double_values()[0]);
+}
+
+TEST_F(ServicesUtilInitializeLbfgs, no_iterations) {
+  Eigen::VectorXd inv_metric;
+  std::vector<double> params
+    = stan::services::util::initialize_lbfgs(model, empty_context, rng,
+                                             0, 0, 5, 10, inv_metric,
+                                             logger, init);
+  ASSERT_EQ(model.num_params_r(), params.size());
+  EXPECT_FLOAT_EQ(0, params[0]);
+  EXPECT_FLOAT_EQ(0, params[1]);
+  EXPECT_FLOAT_EQ(1, inv_metric(0));
+  EXPECT_FLOAT_EQ(1, inv_metric(1));
+  EXPECT_EQ(1, logger.find_info("found no normal approximation"));
+}
+
+TEST_F(ServicesUtilInitializeLbfgs, create_init_context) {
+  std::vector<double> params(2);
+  params[0] = 0.5;
+  params[1] = -1.5;
+  stan::io::array_var_context context
+    = stan::services::util::create_init_context(model, params, rng);
+  std::vector<std::string> names;
+  context.names_r(names);
+  ASSERT_EQ(1, names.size());
+  EXPECT_EQ("y", names[0]);
+
+  std::vector<int> params_i;
+  std::vector<double> unconstrained;
+  model.transform_inits(context, params_i, unconstrained, &model_ss);
+  ASSERT_EQ(2, unconstrained.size());
+  EXPECT_FLOAT_EQ(params[0], unconstrained[0]);
+  EXPECT_FLOAT_EQ(params[1], unconstrained[1]);
+}
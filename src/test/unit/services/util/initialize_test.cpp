@@ -294,6 +294,20 @@ TEST_F(ServicesUtilInitialize, model_throws__radius_two) {
   EXPECT_EQ(100, logger.find_info("throwing within log_prob"));
 }
 
+TEST_F(ServicesUtilInitialize, model_throws__radius_two__num_threads) {
+  test::mock_throwing_model throwing_model;
+
+  double init_radius = 2;
+  bool print_timing = false;
+  EXPECT_THROW(stan::services::util::initialize(throwing_model, empty_context, rng,
+                                                init_radius, print_timing,
+                                                logger, init, 8),
+               std::domain_error);
+  EXPECT_EQ(303, logger.call_count());
+  EXPECT_EQ(303, logger.call_count_info());
+  EXPECT_EQ(100, logger.find_info("throwing within log_prob"));
+}
+
 TEST_F(ServicesUtilInitialize, model_throws__full_init) {
   std::vector<std::string> names_r;
   std::vector<double> values_r;
@@ -437,6 +451,21 @@ TEST_F(ServicesUtilInitialize, model_errors__radius_two) {
   EXPECT_EQ(1, logger.find_info("out_of_range error in log_prob"));
 }
 
+TEST_F(ServicesUtilInitialize, model_errors__radius_two__num_threads) {
+  test::mock_error_model error_model;
+
+  double init_radius = 2;
+  bool print_timing = false;
+  EXPECT_THROW_MSG(stan::services::util::initialize(error_model, empty_context, rng,
+                                                    init_radius, print_timing,
+                                                    logger, init, 4),
+                   std::out_of_range,
+                   "out_of_range error in log_prob");
+  EXPECT_EQ(2, logger.call_count());
+  EXPECT_EQ(2, logger.call_count_info());
+  EXPECT_EQ(1, logger.find_info("out_of_range error in log_prob"));
+}
+
 TEST_F(ServicesUtilInitialize, model_errors__full_init) {
   std::vector<std::string> names_r;
   std::vector<double> values_r;
@@ -31,6 +31,20 @@ TEST(inv_metric, create_diag_sz100) {
   ASSERT_NEAR(1.0, diag_vals[99], 0.0001);
 }
 
+TEST(inv_metric, create_diag_values) {
+  stan::callbacks::logger logger;
+  Eigen::VectorXd values(3);
+  values << 0.5, 2.0, 1e-3;
+  stan::io::array_var_context context =
+    stan::services::util::create_diag_inv_metric(values);
+  Eigen::VectorXd inv_metric =
+    stan::services::util::read_diag_inv_metric(context, 3, logger);
+  EXPECT_EQ(3, inv_metric.size());
+  EXPECT_EQ(0.5, inv_metric(0));
+  EXPECT_EQ(2.0, inv_metric(1));
+  EXPECT_EQ(1e-3, inv_metric(2));
+}
+
 TEST(inv_metric, create_dense_sz2) {
   stan::io::dump dmp = 
     stan::services::util::create_unit_e_dense_inv_metric(2);
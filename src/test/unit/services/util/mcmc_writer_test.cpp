@@ -200,6 +200,38 @@ TEST_F(ServicesUtil, write_timing) {
   EXPECT_EQ(5, logger.call_count_info());
 }
 
+TEST_F(ServicesUtil, write_phase_timing) {
+  std::vector<stan::services::util::sampler_phase> phases;
+  phases.push_back(stan::services::util::sampler_phase("init"));
+  phases.push_back(stan::services::util::sampler_phase("sampling"));
+  phases[1].wall_time = 0.5;
+  phases[1].num_transitions = 10;
+  phases[1].num_leapfrogs = 70;
+  phases[1].num_gradients = 71;
+
+  mcmc_writer.write_phase_timing(phases);
+  EXPECT_EQ(0, sample_writer.call_count());
+  EXPECT_EQ(3, diagnostic_writer.call_count());
+  EXPECT_EQ(2, diagnostic_writer.call_count("string"));
+  EXPECT_EQ(1, diagnostic_writer.call_count("empty"));
+  EXPECT_EQ(0, logger.call_count());
+
+  std::vector<std::string> lines = diagnostic_writer.string_values();
+  ASSERT_EQ(2, lines.size());
+  EXPECT_EQ(" Timing: phase=init wall_time=0 transitions=0 leapfrogs=0"
+            " gradients=0", lines[0]);
+  EXPECT_EQ(" Timing: phase=sampling wall_time=0.5 transitions=10"
+            " leapfrogs=70 gradients=71", lines[1]);
+}
+
+TEST_F(ServicesUtil, write_phase_timing_no_phases) {
+  std::vector<stan::services::util::sampler_phase> phases;
+  mcmc_writer.write_phase_timing(phases);
+  EXPECT_EQ(0, sample_writer.call_count());
+  EXPECT_EQ(0, diagnostic_writer.call_count());
+  EXPECT_EQ(0, logger.call_count());
+}
+
 
 TEST_F(ServicesUtil, throwing_model__write_sample_parameters) {
   boost::ecuyer1988 rng = stan::services::util::create_rng(0, 1);
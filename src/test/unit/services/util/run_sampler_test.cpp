@@ -108,12 +108,12 @@ TEST_F(ServicesUtil, all_zero) {
   EXPECT_EQ(2, sample_writer.call_count("empty"))
     << "blank lines";
 
-  EXPECT_EQ(6, diagnostic_writer.call_count());
+  EXPECT_EQ(9, diagnostic_writer.call_count());
   EXPECT_EQ(1, diagnostic_writer.call_count("vector_string"))
     << "header line";
-  EXPECT_EQ(3, diagnostic_writer.call_count("string"))
-    << "elapsed time";
-  EXPECT_EQ(2, diagnostic_writer.call_count("empty"))
+  EXPECT_EQ(5, diagnostic_writer.call_count("string"))
+    << "elapsed time and phase timing";
+  EXPECT_EQ(3, diagnostic_writer.call_count("empty"))
     << "blank lines";
 }
 
@@ -141,12 +141,12 @@ TEST_F(ServicesUtil, num_warmup_no_save) {
   EXPECT_EQ(2, sample_writer.call_count("empty"))
     << "blank lines";
 
-  EXPECT_EQ(6, diagnostic_writer.call_count());
+  EXPECT_EQ(9, diagnostic_writer.call_count());
   EXPECT_EQ(1, diagnostic_writer.call_count("vector_string"))
     << "header line";
-  EXPECT_EQ(3, diagnostic_writer.call_count("string"))
-    << "elapsed time";
-  EXPECT_EQ(2, diagnostic_writer.call_count("empty"))
+  EXPECT_EQ(5, diagnostic_writer.call_count("string"))
+    << "elapsed time and phase timing";
+  EXPECT_EQ(3, diagnostic_writer.call_count("empty"))
     << "blank lines";
 }
 
@@ -177,12 +177,12 @@ TEST_F(ServicesUtil, num_warmup_save) {
   EXPECT_EQ(num_warmup, sample_writer.call_count("vector_double"))
     << "warmup draws";
 
-  EXPECT_EQ(num_warmup + 6, diagnostic_writer.call_count());
+  EXPECT_EQ(num_warmup + 9, diagnostic_writer.call_count());
   EXPECT_EQ(1, diagnostic_writer.call_count("vector_string"))
     << "header line";
-  EXPECT_EQ(3, diagnostic_writer.call_count("string"))
-    << "elapsed time";
-  EXPECT_EQ(2, diagnostic_writer.call_count("empty"))
+  EXPECT_EQ(5, diagnostic_writer.call_count("string"))
+    << "elapsed time and phase timing";
+  EXPECT_EQ(3, diagnostic_writer.call_count("empty"))
     << "blank lines";
   EXPECT_EQ(num_warmup, diagnostic_writer.call_count("vector_double"))
     << "warmup draws";
@@ -215,12 +215,12 @@ TEST_F(ServicesUtil, num_samples) {
   EXPECT_EQ(num_samples, sample_writer.call_count("vector_double"))
     << "num_samples draws";
 
-  EXPECT_EQ(num_samples + 6, diagnostic_writer.call_count());
+  EXPECT_EQ(num_samples + 9, diagnostic_writer.call_count());
   EXPECT_EQ(1, diagnostic_writer.call_count("vector_string"))
     << "header line";
-  EXPECT_EQ(3, diagnostic_writer.call_count("string"))
-    << "elapsed time";
-  EXPECT_EQ(2, diagnostic_writer.call_count("empty"))
+  EXPECT_EQ(5, diagnostic_writer.call_count("string"))
+    << "elapsed time and phase timing";
+  EXPECT_EQ(3, diagnostic_writer.call_count("empty"))
     << "blank lines";
   EXPECT_EQ(num_samples, sample_writer.call_count("vector_double"))
     << "num_samples draws";
@@ -257,13 +257,13 @@ TEST_F(ServicesUtil, num_warmup_save_num_samples_num_thin) {
             sample_writer.call_count("vector_double"))
     << "thinned warmup and draws";
 
-  EXPECT_EQ((num_warmup + num_samples) / num_thin + 6,
+  EXPECT_EQ((num_warmup + num_samples) / num_thin + 9,
             diagnostic_writer.call_count());
   EXPECT_EQ(1, diagnostic_writer.call_count("vector_string"))
     << "header line";
-  EXPECT_EQ(3, diagnostic_writer.call_count("string"))
-    << "elapsed time";
-  EXPECT_EQ(2, diagnostic_writer.call_count("empty"))
+  EXPECT_EQ(5, diagnostic_writer.call_count("string"))
+    << "elapsed time and phase timing";
+  EXPECT_EQ(3, diagnostic_writer.call_count("empty"))
     << "blank lines";
   EXPECT_EQ((num_warmup + num_samples) / num_thin,
             diagnostic_writer.call_count("vector_double"))
@@ -304,13 +304,13 @@ TEST_F(ServicesUtil, num_warmup_num_samples_refresh) {
             sample_writer.call_count("vector_double"))
     << "draws";
 
-  EXPECT_EQ(num_samples + 6,
+  EXPECT_EQ(num_samples + 9,
             diagnostic_writer.call_count());
   EXPECT_EQ(1, diagnostic_writer.call_count("vector_string"))
     << "header line";
-  EXPECT_EQ(3, diagnostic_writer.call_count("string"))
-    << "elapsed time";
-  EXPECT_EQ(2, diagnostic_writer.call_count("empty"))
+  EXPECT_EQ(5, diagnostic_writer.call_count("string"))
+    << "elapsed time and phase timing";
+  EXPECT_EQ(3, diagnostic_writer.call_count("empty"))
     << "blank lines";
   EXPECT_EQ(num_samples,
             diagnostic_writer.call_count("vector_double"))
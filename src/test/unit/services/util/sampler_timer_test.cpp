@@ -0,0 +1,121 @@
+#include <stan/services/util/sampler_timer.hpp>
+#include <stan/callbacks/logger.hpp>
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+
+class mock_counting_sampler : public stan::mcmc::base_mcmc {
+public:
+  long n_leapfrogs;
+  long n_gradients;
+
+  mock_counting_sampler() : n_leapfrogs(0), n_gradients(0) {}
+
+  stan::mcmc::sample
+  transition(stan::mcmc::sample& init_sample,
+             stan::callbacks::logger& logger) {
+    n_leapfrogs += 3;
+    n_gradients += 3;
+    return init_sample;
+  }
+
+  long get_num_leapfrogs() {
+    return n_leapfrogs;
+  }
+
+  long get_num_gradients() {
+    return n_gradients;
+  }
+};
+
+TEST(ServicesUtilSamplerTimer, begin_end) {
+  mock_counting_sampler sampler;
+  stan::services::util::sampler_timer timer;
+  EXPECT_EQ(0, timer.phases().size());
+
+  timer.begin("init");
+  sampler.n_gradients = 5;
+  timer.begin("sampling", sampler);
+  sampler.n_leapfrogs = 10;
+  sampler.n_gradients = 12;
+  timer.record_transition(sampler);
+  timer.end(sampler);
+
+  ASSERT_EQ(2, timer.phases().size());
+  EXPECT_EQ("init", timer.phases()[0].name);
+  EXPECT_EQ(0, timer.phases()[0].num_transitions);
+  EXPECT_EQ(0, timer.phases()[0].num_leapfrogs);
+  EXPECT_EQ(5, timer.phases()[0].num_gradients);
+  EXPECT_LE(0, timer.phases()[0].wall_time);
+
+  EXPECT_EQ("sampling", timer.phases()[1].name);
+  EXPECT_EQ(1, timer.phases()[1].num_transitions);
+  EXPECT_EQ(10, timer.phases()[1].num_leapfrogs);
+  EXPECT_EQ(7, timer.phases()[1].num_gradients);
+  EXPECT_LE(0, timer.phases()[1].wall_time);
+
+  EXPECT_FLOAT_EQ(timer.phases()[0].wall_time + timer.phases()[1].wall_time,
+                  timer.wall_time(0, 2));
+}
+
+TEST(ServicesUtilSamplerTimer, scheduled_phases) {
+  mock_counting_sampler sampler;
+  stan::services::util::sampler_timer timer;
+
+  std::vector<std::string> names;
+  names.push_back("a");
+  names.push_back("empty");
+  names.push_back("b");
+  names.push_back("c");
+  std::vector<int> lengths;
+  lengths.push_back(2);
+  lengths.push_back(0);
+  lengths.push_back(3);
+  lengths.push_back(1);
+
+  stan::callbacks::logger logger;
+  stan::mcmc::sample s(Eigen::VectorXd::Zero(1), 0, 0);
+  timer.begin(names, lengths, sampler);
+  for (int n = 0; n < 8; ++n) {
+    sampler.transition(s, logger);
+    timer.record_transition(sampler);
+  }
+  timer.end(sampler);
+
+  // The last phase takes any transitions beyond the schedule
+  ASSERT_EQ(3, timer.phases().size());
+  EXPECT_EQ("a", timer.phases()[0].name);
+  EXPECT_EQ(2, timer.phases()[0].num_transitions);
+  EXPECT_EQ(6, timer.phases()[0].num_leapfrogs);
+  EXPECT_EQ("b", timer.phases()[1].name);
+  EXPECT_EQ(3, timer.phases()[1].num_transitions);
+  EXPECT_EQ(9, timer.phases()[1].num_gradients);
+  EXPECT_EQ("c", timer.phases()[2].name);
+  EXPECT_EQ(3, timer.phases()[2].num_transitions);
+  EXPECT_EQ(9, timer.phases()[2].num_leapfrogs);
+}
+
+TEST(ServicesUtilSamplerTimer, get_warmup_phases) {
+  std::vector<std::string> names;
+  std::vector<int> lengths;
+
+  stan::services::util::get_warmup_phases(0, 100, names, lengths);
+  ASSERT_EQ(1, names.size());
+  EXPECT_EQ("warmup", names[0]);
+  EXPECT_EQ(100, lengths[0]);
+
+  stan::callbacks::logger logger;
+  stan::mcmc::windowed_adaptation adaptation("test");
+  adaptation.set_window_params(1000, 75, 50, 25, logger);
+  stan::services::util::get_warmup_phases(&adaptation, 1000, names, lengths);
+  ASSERT_EQ(7, names.size());
+  ASSERT_EQ(7, lengths.size());
+  EXPECT_EQ("init_buffer", names[0]);
+  EXPECT_EQ(75, lengths[0]);
+  EXPECT_EQ("adapt_window_1", names[1]);
+  EXPECT_EQ(25, lengths[1]);
+  EXPECT_EQ("adapt_window_5", names[5]);
+  EXPECT_EQ(500, lengths[5]);
+  EXPECT_EQ("term_buffer", names[6]);
+  EXPECT_EQ(50, lengths[6]);
+}
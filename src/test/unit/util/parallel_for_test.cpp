@@ -0,0 +1,76 @@
+#include <stan/util/parallel_for.hpp>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <vector>
+
+TEST(parallel_for, serial) {
+  std::vector<int> x(10, 0);
+  stan::util::parallel_for(0, x.size(),
+                           [&](std::size_t i) { x[i] = i * i; }, 1);
+  for (size_t i = 0; i < x.size(); ++i)
+    EXPECT_EQ(i * i, x[i]);
+}
+
+TEST(parallel_for, threaded) {
+  std::vector<int> x(103, 0);
+  stan::util::parallel_for(3, x.size(),
+                           [&](std::size_t i) { x[i] += i; }, 4);
+  for (size_t i = 0; i < 3; ++i)
+    EXPECT_EQ(0, x[i]);
+  for (size_t i = 3; i < x.size(); ++i)
+    EXPECT_EQ(i, x[i]);
+}
+
+TEST(parallel_for, more_threads_than_jobs) {
+  std::vector<int> x(2, 0);
+  stan::util::parallel_for(0, x.size(),
+                           [&](std::size_t i) { x[i] = 1; }, 16);
+  EXPECT_EQ(1, x[0]);
+  EXPECT_EQ(1, x[1]);
+}
+
+TEST(parallel_for, empty_range) {
+  int calls = 0;
+  stan::util::parallel_for(5, 5, [&](std::size_t i) { ++calls; }, 4);
+  EXPECT_EQ(0, calls);
+}
+
+TEST(parallel_for, rethrows_first_exception) {
+  std::vector<int> x(20, 0);
+  try {
+    stan::util::parallel_for(0, x.size(),
+                             [&](std::size_t i) {
+                               x[i] = 1;
+                               if (i == 7)
+                                 throw std::domain_error("seven");
+                               if (i == 13)
+                                 throw std::domain_error("thirteen");
+                             }, 4);
+    FAIL() << "expected an exception";
+  } catch (const std::domain_error& e) {
+    EXPECT_EQ(std::string("seven"), e.what());
+  }
+  for (size_t i = 0; i < x.size(); ++i)
+    EXPECT_EQ(1, x[i]);
+}
+
+TEST(parallel_for, get_num_threads) {
+  unsetenv("STAN_NUM_THREADS");
+  EXPECT_EQ(1, stan::util::get_num_threads(4));
+
+  setenv("STAN_NUM_THREADS", "3", 1);
+  EXPECT_EQ(3, stan::util::get_num_threads(4));
+  EXPECT_EQ(2, stan::util::get_num_threads(2));
+
+  setenv("STAN_NUM_THREADS", "-1", 1);
+  EXPECT_LE(1, stan::util::get_num_threads(1000));
+  EXPECT_EQ(1, stan::util::get_num_threads(1));
+
+  setenv("STAN_NUM_THREADS", "0", 1);
+  EXPECT_THROW(stan::util::get_num_threads(4), std::invalid_argument);
+
+  setenv("STAN_NUM_THREADS", "abc", 1);
+  EXPECT_THROW(stan::util::get_num_threads(4), std::invalid_argument);
+
+  unsetenv("STAN_NUM_THREADS");
+}
@@ -151,3 +151,42 @@ TEST(normal_fullrank_test, transform) {
   EXPECT_THROW(my_normal_fullrank.transform(x_nan);,
                    std::domain_error);
 }
+
+TEST(normal_fullrank_test, max) {
+  Eigen::Vector3d mu;
+  mu << 5.7, -3.2, 0.1332;
+
+  Eigen::Matrix3d L;
+  L << 1.3, 0, 0,
+       2.3, 41, 0,
+       3.3, 42, 92;
+
+  Eigen::Vector3d mu_rhs;
+  mu_rhs << 1.2, -1.5, 0.1332;
+
+  Eigen::Matrix3d L_rhs;
+  L_rhs << 2.1, 0, 0,
+           -2.3, 40, 0,
+           4.3, 41, 93;
+
+  stan::variational::normal_fullrank my_normal_fullrank(mu, L);
+  stan::variational::normal_fullrank rhs(mu_rhs, L_rhs);
+
+  stan::variational::normal_fullrank my_max = my_normal_fullrank.max(rhs);
+
+  EXPECT_FLOAT_EQ(5.7, my_max.mu()(0));
+  EXPECT_FLOAT_EQ(-1.5, my_max.mu()(1));
+  EXPECT_FLOAT_EQ(0.1332, my_max.mu()(2));
+
+  Eigen::Matrix3d L_max;
+  L_max << 2.1, 0, 0,
+           2.3, 41, 0,
+           4.3, 42, 93;
+  for (int i = 0; i < 3; ++i)
+    for (int j = 0; j < 3; ++j)
+      EXPECT_FLOAT_EQ(L_max(i, j), my_max.L_chol()(i, j));
+
+  stan::variational::normal_fullrank wrong_dimension(2);
+  EXPECT_THROW(my_normal_fullrank.max(wrong_dimension),
+               std::invalid_argument);
+}
@@ -138,3 +138,33 @@ TEST(normal_meanfield_test, transform) {
   EXPECT_THROW(my_normal_meanfield.transform(x_nan);,
                    std::domain_error);
 }
+
+TEST(normal_meanfield_test, max) {
+  Eigen::Vector3d mu;
+  mu << 5.7, -3.2, 0.1332;
+
+  Eigen::Vector3d omega;
+  omega << -0.42, 0.8922, 13.4;
+
+  Eigen::Vector3d mu_rhs;
+  mu_rhs << 1.2, -1.5, 0.1332;
+
+  Eigen::Vector3d omega_rhs;
+  omega_rhs << 0.3, 0.5, 14.1;
+
+  stan::variational::normal_meanfield my_normal_meanfield(mu, omega);
+  stan::variational::normal_meanfield rhs(mu_rhs, omega_rhs);
+
+  stan::variational::normal_meanfield my_max = my_normal_meanfield.max(rhs);
+
+  EXPECT_FLOAT_EQ(5.7, my_max.mu()(0));
+  EXPECT_FLOAT_EQ(-1.5, my_max.mu()(1));
+  EXPECT_FLOAT_EQ(0.1332, my_max.mu()(2));
+  EXPECT_FLOAT_EQ(0.3, my_max.omega()(0));
+  EXPECT_FLOAT_EQ(0.8922, my_max.omega()(1));
+  EXPECT_FLOAT_EQ(14.1, my_max.omega()(2));
+
+  stan::variational::normal_meanfield wrong_dimension(2);
+  EXPECT_THROW(my_normal_meanfield.max(wrong_dimension),
+               std::invalid_argument);
+}
@@ -0,0 +1,175 @@
+#include <stan/variational/minibatch_advi.hpp>
+#include <stan/variational/optimizers/adam.hpp>
+#include <stan/callbacks/stream_logger.hpp>
+#include <stan/callbacks/writer.hpp>
+#include <stan/model/prob_grad.hpp>
+#include <gtest/gtest.h>
+#include <boost/random/additive_combine.hpp> // L'Ecuyer RNG
+#include <cmath>
+#include <sstream>
+#include <vector>
+
+typedef boost::ecuyer1988 rng_t;
+
+// Normal model with unit scale for N data items, with a subsampled
+// likelihood, and a normal(0, 10) prior on the location.
+class minibatch_model : public stan::model::prob_grad {
+public:
+  explicit minibatch_model(size_t N)
+    : stan::model::prob_grad(1), y_(N), write_array_batch_size_(0) {
+    for (size_t n = 0; n < N; ++n)
+      y_[n] = 2 + std::sin(static_cast<double>(n));
+    for (size_t n = 0; n < N; ++n)
+      minibatch_.push_back(n);
+  }
+
+  size_t data_size() const {
+    return y_.size();
+  }
+
+  void set_minibatch(const std::vector<size_t>& indices) {
+    minibatch_ = indices;
+  }
+
+  template <bool propto, bool jacobian_adjust_transforms, typename T>
+  T log_prob(Eigen::Matrix<T, Eigen::Dynamic, 1>& params_r,
+             std::ostream* output_stream = 0) const {
+    T mu = params_r(0);
+    T log_lik = 0;
+    for (size_t i = 0; i < minibatch_.size(); ++i)
+      log_lik -= 0.5 * (y_[minibatch_[i]] - mu) * (y_[minibatch_[i]] - mu);
+    return -0.005 * mu * mu
+      + static_cast<double>(y_.size()) / minibatch_.size() * log_lik;
+  }
+
+  void constrained_param_names(std::vector<std::string>& param_names__,
+                               bool include_tparams__ = true,
+                               bool include_gqs__ = true) const {
+    param_names__.push_back("mu");
+  }
+
+  template <typename RNG>
+  void write_array(RNG& base_rng__,
+                   std::vector<double>& params_r__,
+                   std::vector<int>& params_i__,
+                   std::vector<double>& vars__,
+                   bool include_tparams__ = true,
+                   bool include_gqs__ = true,
+                   std::ostream* pstream__ = 0) const {
+    write_array_batch_size_ = minibatch_.size();
+    vars__ = params_r__;
+  }
+
+  double posterior_mean() const {
+    double sum = 0;
+    for (size_t n = 0; n < y_.size(); ++n)
+      sum += y_[n];
+    return sum / (y_.size() + 0.01);
+  }
+
+  std::vector<double> y_;
+  std::vector<size_t> minibatch_;
+  mutable size_t write_array_batch_size_;
+};
+
+class values_writer : public stan::callbacks::writer {
+public:
+  void operator()(const std::vector<double>& state) {
+    values.push_back(state);
+  }
+
+  std::vector<std::vector<double> > values;
+};
+
+class minibatch_advi_test : public testing::Test {
+public:
+  minibatch_advi_test()
+    : model(1000),
+      cont_params(Eigen::VectorXd::Zero(1)),
+      rng(12345),
+      logger(log_stream_, log_stream_, log_stream_, log_stream_,
+             log_stream_) { }
+
+  minibatch_model model;
+  Eigen::VectorXd cont_params;
+  rng_t rng;
+  std::stringstream log_stream_;
+  stan::callbacks::stream_logger logger;
+};
+
+typedef stan::variational::minibatch_advi<minibatch_model,
+                                          stan::variational::normal_meanfield,
+                                          rng_t> minibatch_advi_t;
+
+TEST_F(minibatch_advi_test, constructor_throws) {
+  EXPECT_THROW(minibatch_advi_t(model, cont_params, rng, 1, 100, 100, 1, 0),
+               std::domain_error);
+  EXPECT_THROW(minibatch_advi_t(model, cont_params, rng, 1, 100, 100, 1,
+                                1001),
+               std::domain_error);
+  EXPECT_NO_THROW(minibatch_advi_t(model, cont_params, rng, 1, 100, 100, 1,
+                                   1000));
+}
+
+TEST_F(minibatch_advi_test, draws_minibatches) {
+  minibatch_advi_t advi(model, cont_params, rng, 1, 100, 100, 1, 50);
+  stan::variational::normal_meanfield variational(cont_params);
+  stan::variational::normal_meanfield elbo_grad(1);
+
+  std::vector<size_t> previous;
+  for (int n = 0; n < 10; ++n) {
+    advi.calc_ELBO_grad(variational, elbo_grad, logger);
+    ASSERT_EQ(50U, model.minibatch_.size());
+    EXPECT_TRUE(model.minibatch_ == advi.minibatch());
+    for (size_t i = 1; i < model.minibatch_.size(); ++i)
+      EXPECT_LT(model.minibatch_[i - 1], model.minibatch_[i]);
+    EXPECT_LT(model.minibatch_.back(), 1000U);
+    EXPECT_FALSE(model.minibatch_ == previous);
+    previous = model.minibatch_;
+  }
+
+  advi.calc_ELBO(variational, logger);
+  EXPECT_EQ(50U, model.minibatch_.size());
+  EXPECT_FALSE(model.minibatch_ == previous);
+}
+
+TEST_F(minibatch_advi_test, full_minibatch) {
+  minibatch_advi_t advi(model, cont_params, rng, 1, 100, 100, 1, 1000);
+  stan::variational::normal_meanfield variational(cont_params);
+
+  advi.calc_ELBO(variational, logger);
+  ASSERT_EQ(1000U, model.minibatch_.size());
+  for (size_t i = 0; i < model.minibatch_.size(); ++i)
+    EXPECT_EQ(i, model.minibatch_[i]);
+}
+
+TEST_F(minibatch_advi_test, run) {
+  minibatch_advi_t advi(model, cont_params, rng, 5, 100, 100, 100, 20);
+  stan::callbacks::writer diagnostic_writer;
+  values_writer parameter_writer;
+
+  advi.run(0.1, false, 50, 0.001, 5000, logger, parameter_writer,
+           diagnostic_writer);
+
+  EXPECT_EQ(1000U, model.write_array_batch_size_);
+  ASSERT_EQ(101U, parameter_writer.values.size());
+  EXPECT_NEAR(model.posterior_mean(), parameter_writer.values[0][1], 0.05);
+}
+
+TEST_F(minibatch_advi_test, run_with_optimizer) {
+  typedef stan::variational::adam<stan::variational::normal_meanfield>
+    adam_t;
+  stan::variational::minibatch_advi<minibatch_model,
+                                    stan::variational::normal_meanfield,
+                                    rng_t, adam_t>
+    advi(model, cont_params, rng, 5, 100, 100, 100, 20, adam_t(1, true));
+  stan::callbacks::writer diagnostic_writer;
+  values_writer parameter_writer;
+
+  advi.run(0.1, false, 50, 0.001, 5000, logger, parameter_writer,
+           diagnostic_writer);
+
+  EXPECT_EQ(1000U, model.write_array_batch_size_);
+  ASSERT_EQ(101U, parameter_writer.values.size());
+  EXPECT_NEAR(model.posterior_mean(), parameter_writer.values[0][1], 0.05);
+}
@@ -0,0 +1,91 @@
+#include <stan/variational/optimizers/adam.hpp>
+#include <stan/variational/families/normal_meanfield.hpp>
+#include <stan/variational/families/normal_fullrank.hpp>
+#include <gtest/gtest.h>
+#include <cmath>
+
+TEST(adam_test, first_update) {
+  Eigen::Vector2d mu;
+  mu << 1.5, -2.0;
+  stan::variational::normal_meanfield variational(mu);
+
+  Eigen::Vector2d mu_grad;
+  mu_grad << 200.0, -0.005;
+  Eigen::Vector2d omega_grad;
+  omega_grad << 0.0, 4.0;
+  stan::variational::normal_meanfield elbo_grad(mu_grad, omega_grad);
+
+  // after bias correction the first step is eta in the direction of
+  // the gradient, whatever its scale
+  stan::variational::adam<stan::variational::normal_meanfield> adam(2);
+  adam.update(variational, elbo_grad, 0.1);
+  EXPECT_FLOAT_EQ(1.6, variational.mu()(0));
+  EXPECT_FLOAT_EQ(-2.1, variational.mu()(1));
+  EXPECT_FLOAT_EQ(0.0, variational.omega()(0));
+  EXPECT_FLOAT_EQ(0.1, variational.omega()(1));
+}
+
+TEST(adam_test, amsgrad) {
+  Eigen::VectorXd zero = Eigen::VectorXd::Zero(1);
+  Eigen::VectorXd large = Eigen::VectorXd::Constant(1, 10.0);
+  Eigen::VectorXd small = Eigen::VectorXd::Constant(1, 0.1);
+  stan::variational::normal_meanfield large_grad(large, zero);
+  stan::variational::normal_meanfield small_grad(small, zero);
+
+  double beta1 = 0.9;
+  double beta2 = 0.999;
+  double eta = 0.1;
+  for (int amsgrad = 0; amsgrad < 2; ++amsgrad) {
+    stan::variational::normal_meanfield variational(zero);
+    stan::variational::adam<stan::variational::normal_meanfield>
+      adam(1, amsgrad);
+    adam.update(variational, large_grad, eta);
+    adam.update(variational, small_grad, eta);
+
+    double m = (1 - beta1) * beta1 * 10.0 + (1 - beta1) * 0.1;
+    double v = (1 - beta2) * beta2 * 100.0 + (1 - beta2) * 0.01;
+    double m_hat = m / (1 - beta1 * beta1);
+    double v_hat = v / (1 - beta2 * beta2);
+    if (amsgrad)
+      v_hat = std::max(v_hat, 100.0);
+    EXPECT_FLOAT_EQ(eta + eta * m_hat / (1e-8 + std::sqrt(v_hat)),
+                    variational.mu()(0));
+  }
+}
+
+TEST(adam_test, restart) {
+  Eigen::VectorXd zero = Eigen::VectorXd::Zero(1);
+  Eigen::VectorXd one = Eigen::VectorXd::Ones(1);
+  stan::variational::normal_meanfield elbo_grad(one, zero);
+  stan::variational::normal_meanfield variational(zero);
+
+  stan::variational::adam<stan::variational::normal_meanfield> adam(1);
+  adam.update(variational, elbo_grad, 0.1);
+  adam.update(variational, -1.0 * elbo_grad, 0.1);
+  adam.restart();
+  double mu = variational.mu()(0);
+  adam.update(variational, elbo_grad, 0.1);
+  EXPECT_FLOAT_EQ(mu + 0.1, variational.mu()(0));
+}
+
+TEST(adam_test, fullrank) {
+  Eigen::Vector2d mu;
+  mu << 1.5, -2.0;
+  stan::variational::normal_fullrank variational(mu);
+
+  Eigen::Vector2d mu_grad;
+  mu_grad << 3.0, -0.5;
+  Eigen::Matrix2d L_grad;
+  L_grad << 2.0, 0.0,
+            -1.0, 0.25;
+  stan::variational::normal_fullrank elbo_grad(mu_grad, L_grad);
+
+  stan::variational::adam<stan::variational::normal_fullrank> adam(2, true);
+  adam.update(variational, elbo_grad, 0.1);
+  EXPECT_FLOAT_EQ(1.6, variational.mu()(0));
+  EXPECT_FLOAT_EQ(-2.1, variational.mu()(1));
+  EXPECT_FLOAT_EQ(1.1, variational.L_chol()(0, 0));
+  EXPECT_FLOAT_EQ(0.0, variational.L_chol()(0, 1));
+  EXPECT_FLOAT_EQ(-0.1, variational.L_chol()(1, 0));
+  EXPECT_FLOAT_EQ(1.1, variational.L_chol()(1, 1));
+}
@@ -0,0 +1,35 @@
+#include <stan/variational/optimizers/rmsprop.hpp>
+#include <stan/variational/families/normal_meanfield.hpp>
+#include <gtest/gtest.h>
+#include <cmath>
+
+TEST(rmsprop_test, update) {
+  Eigen::VectorXd zero = Eigen::VectorXd::Zero(1);
+  Eigen::VectorXd two = Eigen::VectorXd::Constant(1, 2.0);
+  stan::variational::normal_meanfield elbo_grad(two, zero);
+  stan::variational::normal_meanfield variational(zero);
+
+  double rho = 0.9;
+  double momentum = 0.9;
+  double eta = 0.01;
+  stan::variational::rmsprop<stan::variational::normal_meanfield>
+    rmsprop(1, rho, momentum);
+
+  rmsprop.update(variational, elbo_grad, eta);
+  double v = (1 - rho) * 4.0;
+  double velocity = eta * 2.0 / (1e-8 + std::sqrt(v));
+  EXPECT_FLOAT_EQ(velocity, variational.mu()(0));
+  EXPECT_FLOAT_EQ(0.0, variational.omega()(0));
+
+  rmsprop.update(variational, elbo_grad, eta);
+  v = rho * v + (1 - rho) * 4.0;
+  double mu = velocity;
+  velocity = momentum * velocity + eta * 2.0 / (1e-8 + std::sqrt(v));
+  EXPECT_FLOAT_EQ(mu + velocity, variational.mu()(0));
+
+  rmsprop.restart();
+  mu = variational.mu()(0);
+  rmsprop.update(variational, elbo_grad, eta);
+  EXPECT_FLOAT_EQ(mu + eta * 2.0 / (1e-8 + std::sqrt((1 - rho) * 4.0)),
+                  variational.mu()(0));
+}
@@ -0,0 +1,41 @@
+#include <stan/variational/optimizers/stepsize_sequence.hpp>
+#include <stan/variational/families/normal_meanfield.hpp>
+#include <gtest/gtest.h>
+#include <cmath>
+
+TEST(stepsize_sequence_test, update) {
+  Eigen::Vector2d mu;
+  mu << 1.5, -2.0;
+  Eigen::Vector2d omega;
+  omega << 0.1, -0.3;
+  stan::variational::normal_meanfield variational(mu, omega);
+
+  Eigen::Vector2d mu_grad;
+  mu_grad << 2.0, -0.5;
+  Eigen::Vector2d omega_grad;
+  omega_grad << 0.0, 4.0;
+  stan::variational::normal_meanfield elbo_grad(mu_grad, omega_grad);
+
+  stan::variational::stepsize_sequence<stan::variational::normal_meanfield>
+    sequence(2);
+  double eta = 0.5;
+
+  // first iteration: history is the squared gradient
+  sequence.update(variational, elbo_grad, eta);
+  EXPECT_FLOAT_EQ(1.5 + eta * 2.0 / 3.0, variational.mu()(0));
+  EXPECT_FLOAT_EQ(-2.0 - eta * 0.5 / 1.5, variational.mu()(1));
+  EXPECT_FLOAT_EQ(0.1, variational.omega()(0));
+  EXPECT_FLOAT_EQ(-0.3 + eta * 4.0 / 5.0, variational.omega()(1));
+
+  // second iteration: history is the weighted average
+  double mu_0 = variational.mu()(0);
+  sequence.update(variational, elbo_grad, eta);
+  EXPECT_FLOAT_EQ(mu_0 + eta / std::sqrt(2.0) * 2.0 / (1.0 + 2.0),
+                  variational.mu()(0));
+
+  // after a restart the update is the first again
+  sequence.restart();
+  mu_0 = variational.mu()(0);
+  sequence.update(variational, elbo_grad, eta);
+  EXPECT_FLOAT_EQ(mu_0 + eta * 2.0 / 3.0, variational.mu()(0));
+}